@@ -1,3 +1,23 @@
+from os import PathLike
+from typing import Literal, Optional, Union
+
 from ..EndianedBytesIO import EndianedBytesIO
+from ..EndianedIOBase import Endianess
+
+MmapAdvice = Literal["normal", "sequential", "random", "willneed", "dontneed"]
+
+class EndianedMmapIO(EndianedBytesIO):
+    def __init__(
+        self,
+        file: Union[int, str, bytes, PathLike[str], PathLike[bytes]],
+        mode: Literal["r", "r+", "c"] = "r",
+        endian: Endianess = "<",
+        count_type: Optional[str] = None,
+        advice: Optional[MmapAdvice] = None,
+        populate: bool = False,
+    ) -> None: ...
+    def madvise(
+        self, advice: MmapAdvice, start: int = 0, length: Optional[int] = None
+    ) -> None: ...
 
-__all__ = ["EndianedBytesIO"]
+__all__ = ["EndianedBytesIO", "EndianedMmapIO"]
@@ -0,0 +1,3 @@
+from ..EndianedFileIO import EndianedFileIO
+
+__all__ = ["EndianedFileIO"]
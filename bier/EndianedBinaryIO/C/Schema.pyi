@@ -0,0 +1,8 @@
+from typing import Any, Tuple
+
+class Schema:
+    description: Tuple[Any, ...]
+
+    def __init__(self, description: Tuple[Any, ...]) -> None: ...
+
+__all__ = ["Schema"]
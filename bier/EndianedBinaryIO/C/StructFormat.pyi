@@ -0,0 +1,16 @@
+from typing import Any, Sequence, Tuple
+
+from ..EndianedIOBase import Endianess
+
+class StructFormat:
+    format: str
+    size: int
+    length: int
+
+    def __init__(self, format: str) -> None: ...
+    def unpack(self, buffer: bytes, endian: Endianess = ...) -> Tuple[Any, ...]: ...
+    def pack(self, v: Sequence[Any], endian: Endianess = ...) -> bytes: ...
+
+def compile(format: str) -> StructFormat: ...
+
+__all__ = ["StructFormat", "compile"]
@@ -1,4 +1,9 @@
 from .EndianedBytesIO import EndianedBytesIO as EndianedBytesIO
+from .EndianedBytesIO import EndianedMmapIO as EndianedMmapIO
+from .EndianedFileIO import EndianedFileIO as EndianedFileIO
 from .EndianedStreamIO import EndianedStreamIO as EndianedStreamIO
+from .Schema import Schema as Schema
+from .StructFormat import StructFormat as StructFormat
+from .StructFormat import compile as compile
 # disabled for now, because it is slower than the pure python version
 # from .EndianedIOBase import EndianedIOBase as EndianedIOBase
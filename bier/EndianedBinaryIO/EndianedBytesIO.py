@@ -1,5 +1,9 @@
+import re
 from io import BytesIO
+from struct import Struct
+from struct import pack as struct_pack
 from sys import version_info
+from typing import Any, Dict, Iterable, List, Optional, Tuple, Union
 
 if version_info >= (3, 12):
     from collections.abc import Buffer
@@ -7,13 +11,468 @@ elif version_info >= (3, 9):
     from typing_extensions import Buffer
 # Buffer is not available in Python 3.8 and below
 
-from .EndianedIOBase import EndianedIOBase, Endianess
+from .EndianedIOBase import EndianedIOBase, Endianess, _endianed_struct
 
+# the struct formats of the scalar types of the gather functions
+_SCALAR_FORMATS = {
+    "bool": "?",
+    "u8": "B",
+    "u16": "H",
+    "u32": "I",
+    "u64": "Q",
+    "i8": "b",
+    "i16": "h",
+    "i32": "i",
+    "i64": "q",
+    "f16": "e",
+    "f32": "f",
+    "f64": "d",
+}
+
+
+
+def _protobuf_varint(data: bytes, offset: int, end: int) -> Tuple[int, int]:
+    value = 0
+    shift = 0
+    while True:
+        if offset >= end:
+            raise ValueError("Truncated protobuf message.")
+        byte = data[offset]
+        offset += 1
+        if shift == 63 and byte > 1:
+            raise OverflowError("Varint too large.")
+        value |= (byte & 0x7F) << shift
+        if not byte & 0x80:
+            return value, offset
+        shift += 7
+
+
+def _protobuf_skip(data: bytes, offset: int, end: int, key: int) -> int:
+    # field numbers of the open groups, a group ends with an end group key of its field
+    groups = []
+    while True:
+        wire_type = key & 7
+        size = 0
+        if wire_type == 0:
+            _, offset = _protobuf_varint(data, offset, end)
+        elif wire_type == 1:
+            size = 8
+        elif wire_type == 5:
+            size = 4
+        elif wire_type == 2:
+            size, offset = _protobuf_varint(data, offset, end)
+        elif wire_type == 3:
+            groups.append(key >> 3)
+        elif wire_type == 4:
+            if not groups or groups[-1] != key >> 3:
+                raise ValueError(f"Unexpected end of group {key >> 3}.")
+            groups.pop()
+        else:
+            raise ValueError(f"Invalid wire type {wire_type}.")
+        if size > end - offset:
+            raise ValueError("Truncated protobuf message.")
+        offset += size
+        if not groups:
+            return offset
+        key, offset = _protobuf_varint(data, offset, end)
 
 class EndianedBytesIO(BytesIO, EndianedIOBase):
     def __init__(self, initial_bytes: "Buffer" = b"", endian: Endianess = "<") -> None:
         BytesIO.__init__(self, initial_bytes)
         self.endian = endian
 
+    def reserve(self, n: int) -> None:
+        """Hint that the buffer will grow to at least n bytes.
+
+        BytesIO manages its own growth, so this is a no-op for the python implementation.
+        """
+
+    def read_view(self, size: Optional[int] = -1) -> memoryview:
+        pos = self.tell()
+        view = self.getbuffer()
+        end = len(view) if size is None or size < 0 else min(pos + size, len(view))
+        self.seek(max(end, pos))
+        return view[pos:end]
+
+    def cursor(
+        self,
+        offset: Optional[int] = None,
+        length: Optional[int] = None,
+        endian: Optional[Endianess] = None,
+    ) -> "EndianedBytesIO":
+        """Create an independent reader over length bytes at offset.
+
+        The cursor has its own position, starting at 0, and endian.
+        The C implementation shares the buffer, this one copies it.
+
+        Args:
+            offset (int, optional): The start of the cursor, the current position if None.
+            length (int, optional): The size of the cursor, the rest of the buffer if None.
+            endian (str, optional): The endian of the cursor, the one of this reader if None.
+        """
+        size = self.getbuffer().nbytes
+        if offset is None:
+            offset = self.tell()
+        if offset < 0 or offset > size:
+            raise ValueError("Cursor offset is out of bounds.")
+        if length is None:
+            length = size - offset
+        elif length < 0 or length > size - offset:
+            raise ValueError("Cursor length exceeds the buffer.")
+        with self.getbuffer() as view:
+            data = view[offset : offset + length].tobytes()
+        cursor = EndianedBytesIO(data, endian or self.endian)
+        cursor.count_type = self.count_type
+        return cursor
+
+    def fork(self) -> "EndianedBytesIO":
+        """Create an independent reader over the whole buffer at the current position."""
+        cursor = self.cursor(0)
+        cursor.seek(self.tell())
+        return cursor
+
+    def read_protobuf(
+        self, size: Optional[int] = None, fields: Optional[Iterable[int]] = None
+    ) -> Dict[int, List[Union[int, memoryview]]]:
+        """Read the fields of a protobuf message.
+
+        Varint, i64 and i32 fields are returned as unsigned ints, length-delimited ones as memoryviews.
+        Unselected fields and groups are skipped without being decoded.
+        The C implementation returns views of the buffer, this one copies the message.
+
+        Args:
+            size (int, optional): The size of the message, the rest of the buffer if None.
+            fields (Iterable[int], optional): The field numbers to return, all if None.
+
+        Returns:
+            Dict[int, List[int | memoryview]]: The values of each field in message order.
+        """
+        pos = self.tell()
+        with self.getbuffer() as view:
+            end = max(len(view), pos)
+            if size is not None:
+                if size < 0 or size > len(view) - pos:
+                    raise ValueError("Read exceeds buffer length.")
+                end = pos + size
+            data = memoryview(view[pos:end].tobytes())
+        wanted = None if fields is None else set(fields)
+
+        result: Dict[int, List[Union[int, memoryview]]] = {}
+        offset = 0
+        end = len(data)
+        while offset < end:
+            key, offset = _protobuf_varint(data, offset, end)
+            field, wire_type = key >> 3, key & 7
+            if field == 0:
+                raise ValueError("Invalid field number 0.")
+            if (wanted is not None and field not in wanted) or wire_type in (3, 4):
+                offset = _protobuf_skip(data, offset, end, key)
+                continue
+            if wire_type == 0:
+                value, offset = _protobuf_varint(data, offset, end)
+            elif wire_type in (1, 5):
+                length = 8 if wire_type == 1 else 4
+                if end - offset < length:
+                    raise ValueError("Truncated protobuf message.")
+                value = int.from_bytes(data[offset : offset + length], "little")
+                offset += length
+            elif wire_type == 2:
+                length, offset = _protobuf_varint(data, offset, end)
+                if length > end - offset:
+                    raise ValueError("Truncated protobuf message.")
+                value = data[offset : offset + length]
+                offset += length
+            else:
+                raise ValueError(f"Invalid wire type {wire_type}.")
+            result.setdefault(field, []).append(value)
+        self.seek(pos + end)
+        return result
+
+    # pattern search
+    def _search(
+        self, pattern: Union[bytes, str], start: Optional[int], end: Optional[int]
+    ) -> Tuple["re.Pattern[bytes]", int, int]:
+        if isinstance(pattern, str):
+            pattern = pattern.encode("utf-8")
+        if len(pattern) == 0:
+            raise ValueError("Pattern must not be empty.")
+        if start is None:
+            start = self.tell()
+        start, end, _ = slice(start, end).indices(self.getbuffer().nbytes)
+        return re.compile(re.escape(bytes(pattern))), start, end
+
+    def find(
+        self,
+        pattern: Union[bytes, str],
+        start: Optional[int] = None,
+        end: Optional[int] = None,
+    ) -> int:
+        """Find the first occurrence of a pattern without moving the position.
+
+        Args:
+            pattern (bytes | str): The pattern, str is encoded as UTF-8.
+            start (int, optional): The start of the search, interpreted like a slice index. The current position if None.
+            end (int, optional): The end of the search, interpreted like a slice index. The end of the buffer if None.
+
+        Returns:
+            int: The offset of the match, -1 if there is none.
+        """
+        regex, start, end = self._search(pattern, start, end)
+        with self.getbuffer() as view:
+            match = regex.search(view, start, end)
+        return -1 if match is None else match.start()
+
+    def find_all(
+        self,
+        pattern: Union[bytes, str],
+        start: Optional[int] = None,
+        end: Optional[int] = None,
+        as_array: bool = False,
+    ) -> Union[Tuple[int, ...], memoryview]:
+        """Find the offsets of all non-overlapping occurrences of a pattern without moving the position.
+
+        Args:
+            pattern (bytes | str): The pattern, str is encoded as UTF-8.
+            start (int, optional): The start of the search, interpreted like a slice index. The current position if None.
+            end (int, optional): The end of the search, interpreted like a slice index. The end of the buffer if None.
+            as_array (bool, optional): Return an i64 memoryview instead of a tuple. Defaults to False.
+
+        Returns:
+            Tuple[int, ...] | memoryview: The offsets of the matches.
+        """
+        regex, start, end = self._search(pattern, start, end)
+        with self.getbuffer() as view:
+            offsets = tuple(match.start() for match in regex.finditer(view, start, end))
+        if as_array:
+            return memoryview(struct_pack(f"={len(offsets)}q", *offsets)).cast("q")
+        return offsets
+
+    def readuntil(self, delimiter: Union[bytes, str], size: int = -1) -> bytes:
+        """Read up to size bytes until the delimiter, which is left unread.
+
+        Args:
+            delimiter (bytes | str): The delimiter, str is encoded as UTF-8.
+            size (int, optional): The maximum number of bytes to read, the rest of the buffer if negative.
+        """
+        pos = self.tell()
+        end = None if size < 0 else pos + size
+        offset = self.find(delimiter, pos, end)
+        if offset < 0:
+            return self.read(size)
+        return self.read(offset - pos)
+
+    # gather reads
+    def _gather(
+        self, offsets: Iterable[int], type: str, as_array: bool
+    ) -> Union[Tuple[Any, ...], memoryview]:
+        name, _, endian = type.partition("_")
+        fmt = _SCALAR_FORMATS[name]
+        struct = Struct({"le": "<", "be": ">"}.get(endian, self.endian) + fmt)
+        values = []
+        with self.getbuffer() as view:
+            for offset in offsets:
+                if offset < 0 or offset > len(view) - struct.size:
+                    raise ValueError(f"Read at offset {offset} exceeds buffer length.")
+                values.append(struct.unpack_from(view, offset)[0])
+        if as_array:
+            return memoryview(struct_pack(f"={len(values)}{fmt}", *values)).cast(fmt)
+        return tuple(values)
+
+    def gather_bool(
+        self, offsets: Iterable[int], as_array: bool = False
+    ) -> Union[Tuple[bool, ...], memoryview]:
+        return self._gather(offsets, "bool", as_array)
+
+    def gather_u8(
+        self, offsets: Iterable[int], as_array: bool = False
+    ) -> Union[Tuple[int, ...], memoryview]:
+        return self._gather(offsets, "u8", as_array)
+
+    def gather_u16(
+        self, offsets: Iterable[int], as_array: bool = False
+    ) -> Union[Tuple[int, ...], memoryview]:
+        return self._gather(offsets, "u16", as_array)
+
+    def gather_u16_le(
+        self, offsets: Iterable[int], as_array: bool = False
+    ) -> Union[Tuple[int, ...], memoryview]:
+        return self._gather(offsets, "u16_le", as_array)
+
+    def gather_u16_be(
+        self, offsets: Iterable[int], as_array: bool = False
+    ) -> Union[Tuple[int, ...], memoryview]:
+        return self._gather(offsets, "u16_be", as_array)
+
+    def gather_u32(
+        self, offsets: Iterable[int], as_array: bool = False
+    ) -> Union[Tuple[int, ...], memoryview]:
+        return self._gather(offsets, "u32", as_array)
+
+    def gather_u32_le(
+        self, offsets: Iterable[int], as_array: bool = False
+    ) -> Union[Tuple[int, ...], memoryview]:
+        return self._gather(offsets, "u32_le", as_array)
+
+    def gather_u32_be(
+        self, offsets: Iterable[int], as_array: bool = False
+    ) -> Union[Tuple[int, ...], memoryview]:
+        return self._gather(offsets, "u32_be", as_array)
+
+    def gather_u64(
+        self, offsets: Iterable[int], as_array: bool = False
+    ) -> Union[Tuple[int, ...], memoryview]:
+        return self._gather(offsets, "u64", as_array)
+
+    def gather_u64_le(
+        self, offsets: Iterable[int], as_array: bool = False
+    ) -> Union[Tuple[int, ...], memoryview]:
+        return self._gather(offsets, "u64_le", as_array)
+
+    def gather_u64_be(
+        self, offsets: Iterable[int], as_array: bool = False
+    ) -> Union[Tuple[int, ...], memoryview]:
+        return self._gather(offsets, "u64_be", as_array)
+
+    def gather_i8(
+        self, offsets: Iterable[int], as_array: bool = False
+    ) -> Union[Tuple[int, ...], memoryview]:
+        return self._gather(offsets, "i8", as_array)
+
+    def gather_i16(
+        self, offsets: Iterable[int], as_array: bool = False
+    ) -> Union[Tuple[int, ...], memoryview]:
+        return self._gather(offsets, "i16", as_array)
+
+    def gather_i16_le(
+        self, offsets: Iterable[int], as_array: bool = False
+    ) -> Union[Tuple[int, ...], memoryview]:
+        return self._gather(offsets, "i16_le", as_array)
+
+    def gather_i16_be(
+        self, offsets: Iterable[int], as_array: bool = False
+    ) -> Union[Tuple[int, ...], memoryview]:
+        return self._gather(offsets, "i16_be", as_array)
+
+    def gather_i32(
+        self, offsets: Iterable[int], as_array: bool = False
+    ) -> Union[Tuple[int, ...], memoryview]:
+        return self._gather(offsets, "i32", as_array)
+
+    def gather_i32_le(
+        self, offsets: Iterable[int], as_array: bool = False
+    ) -> Union[Tuple[int, ...], memoryview]:
+        return self._gather(offsets, "i32_le", as_array)
+
+    def gather_i32_be(
+        self, offsets: Iterable[int], as_array: bool = False
+    ) -> Union[Tuple[int, ...], memoryview]:
+        return self._gather(offsets, "i32_be", as_array)
+
+    def gather_i64(
+        self, offsets: Iterable[int], as_array: bool = False
+    ) -> Union[Tuple[int, ...], memoryview]:
+        return self._gather(offsets, "i64", as_array)
+
+    def gather_i64_le(
+        self, offsets: Iterable[int], as_array: bool = False
+    ) -> Union[Tuple[int, ...], memoryview]:
+        return self._gather(offsets, "i64_le", as_array)
+
+    def gather_i64_be(
+        self, offsets: Iterable[int], as_array: bool = False
+    ) -> Union[Tuple[int, ...], memoryview]:
+        return self._gather(offsets, "i64_be", as_array)
+
+    def gather_f16(
+        self, offsets: Iterable[int], as_array: bool = False
+    ) -> Union[Tuple[float, ...], memoryview]:
+        return self._gather(offsets, "f16", as_array)
+
+    def gather_f16_le(
+        self, offsets: Iterable[int], as_array: bool = False
+    ) -> Union[Tuple[float, ...], memoryview]:
+        return self._gather(offsets, "f16_le", as_array)
+
+    def gather_f16_be(
+        self, offsets: Iterable[int], as_array: bool = False
+    ) -> Union[Tuple[float, ...], memoryview]:
+        return self._gather(offsets, "f16_be", as_array)
+
+    def gather_f32(
+        self, offsets: Iterable[int], as_array: bool = False
+    ) -> Union[Tuple[float, ...], memoryview]:
+        return self._gather(offsets, "f32", as_array)
+
+    def gather_f32_le(
+        self, offsets: Iterable[int], as_array: bool = False
+    ) -> Union[Tuple[float, ...], memoryview]:
+        return self._gather(offsets, "f32_le", as_array)
+
+    def gather_f32_be(
+        self, offsets: Iterable[int], as_array: bool = False
+    ) -> Union[Tuple[float, ...], memoryview]:
+        return self._gather(offsets, "f32_be", as_array)
+
+    def gather_f64(
+        self, offsets: Iterable[int], as_array: bool = False
+    ) -> Union[Tuple[float, ...], memoryview]:
+        return self._gather(offsets, "f64", as_array)
+
+    def gather_f64_le(
+        self, offsets: Iterable[int], as_array: bool = False
+    ) -> Union[Tuple[float, ...], memoryview]:
+        return self._gather(offsets, "f64_le", as_array)
+
+    def gather_f64_be(
+        self, offsets: Iterable[int], as_array: bool = False
+    ) -> Union[Tuple[float, ...], memoryview]:
+        return self._gather(offsets, "f64_be", as_array)
+
+    def gather_struct(
+        self, format: Union[str, Any], offsets: Iterable[int]
+    ) -> List[Tuple[Any, ...]]:
+        """Read a record of a struct format at each offset.
+
+        Args:
+            format (str | StructFormat): The format, native byte order formats use the endian of the reader.
+            offsets (Iterable[int]): The offsets of the records.
+        """
+        struct = _endianed_struct(format, self.endian)
+        records = []
+        with self.getbuffer() as view:
+            for offset in offsets:
+                if offset < 0 or offset > len(view) - struct.size:
+                    raise ValueError(f"Read at offset {offset} exceeds buffer length.")
+                records.append(struct.unpack_from(view, offset))
+        return records
+
+    def read_strided(
+        self,
+        type: Union[str, Any],
+        start: int,
+        stride: int,
+        count: int,
+        as_array: bool = False,
+    ) -> Union[Tuple[Any, ...], memoryview, List[Tuple[Any, ...]]]:
+        """Read count values starting at start, stride bytes apart, e.g. one attribute of interleaved vertices.
+
+        Args:
+            type (str | StructFormat): A scalar type like "u32" or "f32_le", anything else is read as struct format.
+            start (int): The offset of the first value.
+            stride (int): The distance between two values in bytes.
+            count (int): The number of values.
+            as_array (bool, optional): Return a typed memoryview instead of a tuple, only for scalar types.
+        """
+        if count < 0:
+            raise ValueError("Count must be non-negative.")
+        offsets = range(start, start + count * stride, stride) if stride else [start] * count
+        if isinstance(type, str):
+            name, _, endian = type.partition("_")
+            if name in _SCALAR_FORMATS and endian in ("", "le", "be"):
+                return self._gather(offsets, type, as_array)
+        if as_array:
+            raise ValueError("as_array requires a scalar type.")
+        return self.gather_struct(type, offsets)
+
 
 __all__ = ("EndianedBytesIO",)
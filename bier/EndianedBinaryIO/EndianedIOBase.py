@@ -1,8 +1,11 @@
 import abc
+from functools import lru_cache
 from io import IOBase
 from struct import Struct
+from struct import calcsize
 from struct import pack as struct_pack
-from typing import Literal, Optional, Sequence, Tuple
+from sys import byteorder
+from typing import Any, List, Literal, Optional, Sequence, Tuple, Union
 
 from ._structs import (
     BOOL,
@@ -29,13 +32,64 @@ from ._structs import (
 )
 
 Endianess = Literal["<", ">"]
+NATIVE_ENDIAN: Endianess = "<" if byteorder == "little" else ">"
+
+
+CountType = Literal["u8", "u16", "u32", "u64", "i8", "i16", "i32", "i64", "varint"]
+
+
+def _endianed_struct(format: Union[str, Any], endian: Endianess) -> Struct:
+    # accept compiled StructFormat objects as well
+    if not isinstance(format, str):
+        format = format.format
+    return _compile_struct(format, endian)
+
+
+def _encode_varint(v: int) -> bytes:
+    if v < 0:
+        raise ValueError("Varint must be non-negative.")
+    data = bytearray()
+    while v > 0x7F:
+        data.append((v & 0x7F) | 0x80)
+        v >>= 7
+    data.append(v)
+    return bytes(data)
+
+
+def _zigzag(v: int) -> int:
+    if not -(1 << 63) <= v < (1 << 63):
+        raise OverflowError("Signed varint doesn't fit into an i64.")
+    return (v << 1) ^ (v >> 63)
+
+
+@lru_cache(maxsize=None)
+def _compile_struct(format: str, endian: Endianess) -> Struct:
+    # formats without an explicit byte order use the endian of the reader/writer
+    if format[:1] in ("<", ">", "!"):
+        return Struct(format)
+    if format[:1] in ("@", "="):
+        format = format[1:]
+    return Struct(f"{endian}{format}")
+
+
+def _compile_struct_format(format: str) -> Struct:
+    # pure Python fallback of bier.compile when the C extension isn't available,
+    # "=" keeps formats without an explicit byte order on the endian of the reader/writer
+    if format[:1] in ("<", ">", "!", "="):
+        return Struct(format)
+    if format[:1] == "@":
+        format = format[1:]
+    return Struct(f"={format}")
 
 
 class EndianedReaderIOBase(IOBase, metaclass=abc.ABCMeta):
     endian: Endianess
+    count_type: Optional[CountType] = None
 
     def read_count(self) -> int:
-        return self.read_i32()
+        if self.count_type is None:
+            return self.read_i32()
+        return getattr(self, f"read_{self.count_type}")()
 
     # helper functions
     def align(self, size: int) -> int:
@@ -47,26 +101,72 @@ class EndianedReaderIOBase(IOBase, metaclass=abc.ABCMeta):
                 self.read(padding)
         return self.tell()
 
+    def _read_typed_array(self, struct: Struct, fmt: str) -> memoryview:
+        data = self.read(struct.size)
+        if len(data) != struct.size:
+            raise ValueError(
+                f"Buffer size mismatch: expected {struct.size}, got {len(data)}"
+            )
+        if struct.format[0] in "<>" and struct.format[0] != NATIVE_ENDIAN:
+            count = len(data) // calcsize(fmt)
+            data = struct_pack(f"={count}{fmt}", *struct.unpack(data))
+        return memoryview(data).cast(fmt)
+
+    def _read_array_into(
+        self, dest, count: Optional[int], endian: str, fmt: str
+    ) -> int:
+        if count is None:
+            count = self.read_count()
+        struct = Struct(f"{endian}{count}{fmt}")
+        with memoryview(dest) as view, view.cast("B") as raw:
+            if raw.readonly:
+                raise BufferError("Object is not writable.")
+            if struct.size > raw.nbytes:
+                raise ValueError("Destination buffer is too small.")
+            data = self.read(struct.size)
+            if len(data) != struct.size:
+                raise ValueError(
+                    f"Buffer size mismatch: expected {struct.size}, got {len(data)}"
+                )
+            if endian in ("<", ">") and endian != NATIVE_ENDIAN:
+                data = struct_pack(f"={count}{fmt}", *struct.unpack(data))
+            raw[: struct.size] = data
+        return count
+
     # bool
     def read_bool(self) -> bool:
         return BOOL.unpack(self.read(1))[0]
 
-    def read_bool_array(self, count: Optional[int] = None) -> Tuple[bool, ...]:
+    def read_bool_array(
+        self, count: Optional[int] = None, as_array: bool = False
+    ) -> Union[Tuple[bool, ...], memoryview]:
         if count is None:
             count = self.read_count()
         struct = Struct(f"{count}?")
+        if as_array:
+            return self._read_typed_array(struct, "?")
         return struct.unpack(self.read(struct.size))
 
+    def read_bool_array_into(self, dest, count: Optional[int] = None) -> int:
+        return self._read_array_into(dest, count, "", "?")
+
     # unsigned integer
     def read_u8(self) -> int:
         return U8.unpack(self.read(1))[0]
 
-    def read_u8_array(self, count: Optional[int] = None) -> Tuple[int, ...]:
+    def read_u8_array(
+        self, count: Optional[int] = None, as_array: bool = False
+    ) -> Union[Tuple[int, ...], memoryview]:
         if count is None:
             count = self.read_count()
         struct = Struct(f"{count}B")
+        if as_array:
+            return self._read_typed_array(struct, "B")
         return struct.unpack(self.read(struct.size))
 
+    def read_u8_array_into(self, dest, count: Optional[int] = None) -> int:
+        return self._read_array_into(dest, count, "", "B")
+
     def read_u16(self) -> int:
         if self.endian == "<":
             return U16_LE.unpack(self.read(2))[0]
@@ -75,30 +175,51 @@ class EndianedReaderIOBase(IOBase, metaclass=abc.ABCMeta):
         else:
             raise ValueError(f"Invalid endian: {self.endian}")
 
-    def read_u16_array(self, count: Optional[int] = None) -> Tuple[int, ...]:
+    def read_u16_array(
+        self, count: Optional[int] = None, as_array: bool = False
+    ) -> Union[Tuple[int, ...], memoryview]:
         if count is None:
             count = self.read_count()
         struct = Struct(f"{self.endian}{count}H")
+        if as_array:
+            return self._read_typed_array(struct, "H")
         return struct.unpack(self.read(struct.size))
 
+    def read_u16_array_into(self, dest, count: Optional[int] = None) -> int:
+        return self._read_array_into(dest, count, self.endian, "H")
+
     def read_u16_le(self) -> int:
         return U16_LE.unpack(self.read(2))[0]
 
-    def read_u16_le_array(self, count: Optional[int] = None) -> Tuple[int, ...]:
+    def read_u16_le_array(
+        self, count: Optional[int] = None, as_array: bool = False
+    ) -> Union[Tuple[int, ...], memoryview]:
         if count is None:
             count = self.read_count()
         struct = Struct(f"<{count}H")
+        if as_array:
+            return self._read_typed_array(struct, "H")
         return struct.unpack(self.read(struct.size))
 
+    def read_u16_le_array_into(self, dest, count: Optional[int] = None) -> int:
+        return self._read_array_into(dest, count, "<", "H")
+
     def read_u16_be(self) -> int:
         return U16_BE.unpack(self.read(2))[0]
 
-    def read_u16_be_array(self, count: Optional[int] = None) -> Tuple[int, ...]:
+    def read_u16_be_array(
+        self, count: Optional[int] = None, as_array: bool = False
+    ) -> Union[Tuple[int, ...], memoryview]:
         if count is None:
             count = self.read_count()
         struct = Struct(f">{count}H")
+        if as_array:
+            return self._read_typed_array(struct, "H")
         return struct.unpack(self.read(struct.size))
 
+    def read_u16_be_array_into(self, dest, count: Optional[int] = None) -> int:
+        return self._read_array_into(dest, count, ">", "H")
+
     def read_u32(self) -> int:
         if self.endian == "<":
             return U32_LE.unpack(self.read(4))[0]
@@ -107,30 +228,51 @@ class EndianedReaderIOBase(IOBase, metaclass=abc.ABCMeta):
         else:
             raise ValueError(f"Invalid endian: {self.endian}")
 
-    def read_u32_array(self, count: Optional[int] = None) -> Tuple[int, ...]:
+    def read_u32_array(
+        self, count: Optional[int] = None, as_array: bool = False
+    ) -> Union[Tuple[int, ...], memoryview]:
         if count is None:
             count = self.read_count()
         struct = Struct(f"{self.endian}{count}I")
+        if as_array:
+            return self._read_typed_array(struct, "I")
         return struct.unpack(self.read(struct.size))
 
+    def read_u32_array_into(self, dest, count: Optional[int] = None) -> int:
+        return self._read_array_into(dest, count, self.endian, "I")
+
     def read_u32_le(self) -> int:
         return U32_LE.unpack(self.read(4))[0]
 
-    def read_u32_le_array(self, count: Optional[int] = None) -> Tuple[int, ...]:
+    def read_u32_le_array(
+        self, count: Optional[int] = None, as_array: bool = False
+    ) -> Union[Tuple[int, ...], memoryview]:
         if count is None:
             count = self.read_count()
         struct = Struct(f"<{count}I")
+        if as_array:
+            return self._read_typed_array(struct, "I")
         return struct.unpack(self.read(struct.size))
 
+    def read_u32_le_array_into(self, dest, count: Optional[int] = None) -> int:
+        return self._read_array_into(dest, count, "<", "I")
+
     def read_u32_be(self) -> int:
         return U32_BE.unpack(self.read(4))[0]
 
-    def read_u32_be_array(self, count: Optional[int] = None) -> Tuple[int, ...]:
+    def read_u32_be_array(
+        self, count: Optional[int] = None, as_array: bool = False
+    ) -> Union[Tuple[int, ...], memoryview]:
         if count is None:
             count = self.read_count()
         struct = Struct(f">{count}I")
+        if as_array:
+            return self._read_typed_array(struct, "I")
         return struct.unpack(self.read(struct.size))
 
+    def read_u32_be_array_into(self, dest, count: Optional[int] = None) -> int:
+        return self._read_array_into(dest, count, ">", "I")
+
     def read_u64(self) -> int:
         if self.endian == "<":
             return U64_LE.unpack(self.read(8))[0]
@@ -139,40 +281,68 @@ class EndianedReaderIOBase(IOBase, metaclass=abc.ABCMeta):
         else:
             raise ValueError(f"Invalid endian: {self.endian}")
 
-    def read_u64_array(self, count: Optional[int] = None) -> Tuple[int, ...]:
+    def read_u64_array(
+        self, count: Optional[int] = None, as_array: bool = False
+    ) -> Union[Tuple[int, ...], memoryview]:
         if count is None:
             count = self.read_count()
         struct = Struct(f"{self.endian}{count}Q")
+        if as_array:
+            return self._read_typed_array(struct, "Q")
         return struct.unpack(self.read(struct.size))
 
+    def read_u64_array_into(self, dest, count: Optional[int] = None) -> int:
+        return self._read_array_into(dest, count, self.endian, "Q")
+
     def read_u64_le(self) -> int:
         return U64_LE.unpack(self.read(8))[0]
 
-    def read_u64_le_array(self, count: Optional[int] = None) -> Tuple[int, ...]:
+    def read_u64_le_array(
+        self, count: Optional[int] = None, as_array: bool = False
+    ) -> Union[Tuple[int, ...], memoryview]:
         if count is None:
             count = self.read_count()
         struct = Struct(f"<{count}Q")
+        if as_array:
+            return self._read_typed_array(struct, "Q")
         return struct.unpack(self.read(struct.size))
 
+    def read_u64_le_array_into(self, dest, count: Optional[int] = None) -> int:
+        return self._read_array_into(dest, count, "<", "Q")
+
     def read_u64_be(self) -> int:
         return U64_BE.unpack(self.read(8))[0]
 
-    def read_u64_be_array(self, count: Optional[int] = None) -> Tuple[int, ...]:
+    def read_u64_be_array(
+        self, count: Optional[int] = None, as_array: bool = False
+    ) -> Union[Tuple[int, ...], memoryview]:
         if count is None:
             count = self.read_count()
         struct = Struct(f">{count}Q")
+        if as_array:
+            return self._read_typed_array(struct, "Q")
         return struct.unpack(self.read(struct.size))
 
+    def read_u64_be_array_into(self, dest, count: Optional[int] = None) -> int:
+        return self._read_array_into(dest, count, ">", "Q")
+
     # signed integer
     def read_i8(self) -> int:
         return I8.unpack(self.read(1))[0]
 
-    def read_i8_array(self, count: Optional[int] = None) -> Tuple[int, ...]:
+    def read_i8_array(
+        self, count: Optional[int] = None, as_array: bool = False
+    ) -> Union[Tuple[int, ...], memoryview]:
         if count is None:
             count = self.read_count()
         struct = Struct(f"{count}b")
+        if as_array:
+            return self._read_typed_array(struct, "b")
         return struct.unpack(self.read(struct.size))
 
+    def read_i8_array_into(self, dest, count: Optional[int] = None) -> int:
+        return self._read_array_into(dest, count, "", "b")
+
     def read_i16(self) -> int:
         if self.endian == "<":
             return I16_LE.unpack(self.read(2))[0]
@@ -181,30 +351,51 @@ class EndianedReaderIOBase(IOBase, metaclass=abc.ABCMeta):
         else:
             raise ValueError(f"Invalid endian: {self.endian}")
 
-    def read_i16_array(self, count: Optional[int] = None) -> Tuple[int, ...]:
+    def read_i16_array(
+        self, count: Optional[int] = None, as_array: bool = False
+    ) -> Union[Tuple[int, ...], memoryview]:
         if count is None:
             count = self.read_count()
         struct = Struct(f"{self.endian}{count}h")
+        if as_array:
+            return self._read_typed_array(struct, "h")
         return struct.unpack(self.read(struct.size))
 
+    def read_i16_array_into(self, dest, count: Optional[int] = None) -> int:
+        return self._read_array_into(dest, count, self.endian, "h")
+
     def read_i16_le(self) -> int:
         return I16_LE.unpack(self.read(2))[0]
 
-    def read_i16_le_array(self, count: Optional[int] = None) -> Tuple[int, ...]:
+    def read_i16_le_array(
+        self, count: Optional[int] = None, as_array: bool = False
+    ) -> Union[Tuple[int, ...], memoryview]:
         if count is None:
             count = self.read_count()
         struct = Struct(f"<{count}h")
+        if as_array:
+            return self._read_typed_array(struct, "h")
         return struct.unpack(self.read(struct.size))
 
+    def read_i16_le_array_into(self, dest, count: Optional[int] = None) -> int:
+        return self._read_array_into(dest, count, "<", "h")
+
     def read_i16_be(self) -> int:
         return I16_BE.unpack(self.read(2))[0]
 
-    def read_i16_be_array(self, count: Optional[int] = None) -> Tuple[int, ...]:
+    def read_i16_be_array(
+        self, count: Optional[int] = None, as_array: bool = False
+    ) -> Union[Tuple[int, ...], memoryview]:
         if count is None:
             count = self.read_count()
         struct = Struct(f">{count}h")
+        if as_array:
+            return self._read_typed_array(struct, "h")
         return struct.unpack(self.read(struct.size))
 
+    def read_i16_be_array_into(self, dest, count: Optional[int] = None) -> int:
+        return self._read_array_into(dest, count, ">", "h")
+
     def read_i32(self) -> int:
         if self.endian == "<":
             return I32_LE.unpack(self.read(4))[0]
@@ -213,30 +404,51 @@ class EndianedReaderIOBase(IOBase, metaclass=abc.ABCMeta):
         else:
             raise ValueError(f"Invalid endian: {self.endian}")
 
-    def read_i32_array(self, count: Optional[int] = None) -> Tuple[int, ...]:
+    def read_i32_array(
+        self, count: Optional[int] = None, as_array: bool = False
+    ) -> Union[Tuple[int, ...], memoryview]:
         if count is None:
             count = self.read_count()
         struct = Struct(f"{self.endian}{count}i")
+        if as_array:
+            return self._read_typed_array(struct, "i")
         return struct.unpack(self.read(struct.size))
 
+    def read_i32_array_into(self, dest, count: Optional[int] = None) -> int:
+        return self._read_array_into(dest, count, self.endian, "i")
+
     def read_i32_le(self) -> int:
         return I32_LE.unpack(self.read(4))[0]
 
-    def read_i32_le_array(self, count: Optional[int] = None) -> Tuple[int, ...]:
+    def read_i32_le_array(
+        self, count: Optional[int] = None, as_array: bool = False
+    ) -> Union[Tuple[int, ...], memoryview]:
         if count is None:
             count = self.read_count()
         struct = Struct(f"<{count}i")
+        if as_array:
+            return self._read_typed_array(struct, "i")
         return struct.unpack(self.read(struct.size))
 
+    def read_i32_le_array_into(self, dest, count: Optional[int] = None) -> int:
+        return self._read_array_into(dest, count, "<", "i")
+
     def read_i32_be(self) -> int:
         return I32_BE.unpack(self.read(4))[0]
 
-    def read_i32_be_array(self, count: Optional[int] = None) -> Tuple[int, ...]:
+    def read_i32_be_array(
+        self, count: Optional[int] = None, as_array: bool = False
+    ) -> Union[Tuple[int, ...], memoryview]:
         if count is None:
             count = self.read_count()
         struct = Struct(f">{count}i")
+        if as_array:
+            return self._read_typed_array(struct, "i")
         return struct.unpack(self.read(struct.size))
 
+    def read_i32_be_array_into(self, dest, count: Optional[int] = None) -> int:
+        return self._read_array_into(dest, count, ">", "i")
+
     def read_i64(self) -> int:
         if self.endian == "<":
             return I64_LE.unpack(self.read(8))[0]
@@ -245,30 +457,51 @@ class EndianedReaderIOBase(IOBase, metaclass=abc.ABCMeta):
         else:
             raise ValueError(f"Invalid endian: {self.endian}")
 
-    def read_i64_array(self, count: Optional[int] = None) -> Tuple[int, ...]:
+    def read_i64_array(
+        self, count: Optional[int] = None, as_array: bool = False
+    ) -> Union[Tuple[int, ...], memoryview]:
         if count is None:
             count = self.read_count()
         struct = Struct(f"{self.endian}{count}q")
+        if as_array:
+            return self._read_typed_array(struct, "q")
         return struct.unpack(self.read(struct.size))
 
+    def read_i64_array_into(self, dest, count: Optional[int] = None) -> int:
+        return self._read_array_into(dest, count, self.endian, "q")
+
     def read_i64_le(self) -> int:
         return I64_LE.unpack(self.read(8))[0]
 
-    def read_i64_le_array(self, count: Optional[int] = None) -> Tuple[int, ...]:
+    def read_i64_le_array(
+        self, count: Optional[int] = None, as_array: bool = False
+    ) -> Union[Tuple[int, ...], memoryview]:
         if count is None:
             count = self.read_count()
         struct = Struct(f"<{count}q")
+        if as_array:
+            return self._read_typed_array(struct, "q")
         return struct.unpack(self.read(struct.size))
 
+    def read_i64_le_array_into(self, dest, count: Optional[int] = None) -> int:
+        return self._read_array_into(dest, count, "<", "q")
+
     def read_i64_be(self) -> int:
         return I64_BE.unpack(self.read(8))[0]
 
-    def read_i64_be_array(self, count: Optional[int] = None) -> Tuple[int, ...]:
+    def read_i64_be_array(
+        self, count: Optional[int] = None, as_array: bool = False
+    ) -> Union[Tuple[int, ...], memoryview]:
         if count is None:
             count = self.read_count()
         struct = Struct(f">{count}q")
+        if as_array:
+            return self._read_typed_array(struct, "q")
         return struct.unpack(self.read(struct.size))
 
+    def read_i64_be_array_into(self, dest, count: Optional[int] = None) -> int:
+        return self._read_array_into(dest, count, ">", "q")
+
     # floats
     def read_f16(self) -> float:
         if self.endian == "<":
@@ -278,30 +511,51 @@ class EndianedReaderIOBase(IOBase, metaclass=abc.ABCMeta):
         else:
             raise ValueError(f"Invalid endian: {self.endian}")
 
-    def read_f16_array(self, count: Optional[int] = None) -> Tuple[float, ...]:
+    def read_f16_array(
+        self, count: Optional[int] = None, as_array: bool = False
+    ) -> Union[Tuple[float, ...], memoryview]:
         if count is None:
             count = self.read_count()
         struct = Struct(f"{self.endian}{count}e")
+        if as_array:
+            return self._read_typed_array(struct, "e")
         return struct.unpack(self.read(struct.size))
 
+    def read_f16_array_into(self, dest, count: Optional[int] = None) -> int:
+        return self._read_array_into(dest, count, self.endian, "e")
+
     def read_f16_le(self) -> float:
         return F16_LE.unpack(self.read(2))[0]
 
-    def read_f16_le_array(self, count: Optional[int] = None) -> Tuple[float, ...]:
+    def read_f16_le_array(
+        self, count: Optional[int] = None, as_array: bool = False
+    ) -> Union[Tuple[float, ...], memoryview]:
         if count is None:
             count = self.read_count()
         struct = Struct(f"<{count}e")
+        if as_array:
+            return self._read_typed_array(struct, "e")
         return struct.unpack(self.read(struct.size))
 
+    def read_f16_le_array_into(self, dest, count: Optional[int] = None) -> int:
+        return self._read_array_into(dest, count, "<", "e")
+
     def read_f16_be(self) -> float:
         return F16_BE.unpack(self.read(2))[0]
 
-    def read_f16_be_array(self, count: Optional[int] = None) -> Tuple[float, ...]:
+    def read_f16_be_array(
+        self, count: Optional[int] = None, as_array: bool = False
+    ) -> Union[Tuple[float, ...], memoryview]:
         if count is None:
             count = self.read_count()
         struct = Struct(f">{count}e")
+        if as_array:
+            return self._read_typed_array(struct, "e")
         return struct.unpack(self.read(struct.size))
 
+    def read_f16_be_array_into(self, dest, count: Optional[int] = None) -> int:
+        return self._read_array_into(dest, count, ">", "e")
+
     def read_f32(self) -> float:
         if self.endian == "<":
             return F32_LE.unpack(self.read(4))[0]
@@ -310,30 +564,51 @@ class EndianedReaderIOBase(IOBase, metaclass=abc.ABCMeta):
         else:
             raise ValueError(f"Invalid endian: {self.endian}")
 
-    def read_f32_array(self, count: Optional[int] = None) -> Tuple[float, ...]:
+    def read_f32_array(
+        self, count: Optional[int] = None, as_array: bool = False
+    ) -> Union[Tuple[float, ...], memoryview]:
         if count is None:
             count = self.read_count()
         struct = Struct(f"{self.endian}{count}f")
+        if as_array:
+            return self._read_typed_array(struct, "f")
         return struct.unpack(self.read(struct.size))
 
+    def read_f32_array_into(self, dest, count: Optional[int] = None) -> int:
+        return self._read_array_into(dest, count, self.endian, "f")
+
     def read_f32_le(self) -> float:
         return F32_LE.unpack(self.read(4))[0]
 
-    def read_f32_le_array(self, count: Optional[int] = None) -> Tuple[float, ...]:
+    def read_f32_le_array(
+        self, count: Optional[int] = None, as_array: bool = False
+    ) -> Union[Tuple[float, ...], memoryview]:
         if count is None:
             count = self.read_count()
         struct = Struct(f"<{count}f")
+        if as_array:
+            return self._read_typed_array(struct, "f")
         return struct.unpack(self.read(struct.size))
 
+    def read_f32_le_array_into(self, dest, count: Optional[int] = None) -> int:
+        return self._read_array_into(dest, count, "<", "f")
+
     def read_f32_be(self) -> float:
         return F32_BE.unpack(self.read(4))[0]
 
-    def read_f32_be_array(self, count: Optional[int] = None) -> Tuple[float, ...]:
+    def read_f32_be_array(
+        self, count: Optional[int] = None, as_array: bool = False
+    ) -> Union[Tuple[float, ...], memoryview]:
         if count is None:
             count = self.read_count()
         struct = Struct(f">{count}f")
+        if as_array:
+            return self._read_typed_array(struct, "f")
         return struct.unpack(self.read(struct.size))
 
+    def read_f32_be_array_into(self, dest, count: Optional[int] = None) -> int:
+        return self._read_array_into(dest, count, ">", "f")
+
     def read_f64(self) -> float:
         if self.endian == "<":
             return F64_LE.unpack(self.read(8))[0]
@@ -342,37 +617,73 @@ class EndianedReaderIOBase(IOBase, metaclass=abc.ABCMeta):
         else:
             raise ValueError(f"Invalid endian: {self.endian}")
 
-    def read_f64_array(self, count: Optional[int] = None) -> Tuple[float, ...]:
+    def read_f64_array(
+        self, count: Optional[int] = None, as_array: bool = False
+    ) -> Union[Tuple[float, ...], memoryview]:
         if count is None:
             count = self.read_count()
         struct = Struct(f"{self.endian}{count}d")
+        if as_array:
+            return self._read_typed_array(struct, "d")
         return struct.unpack(self.read(struct.size))
 
+    def read_f64_array_into(self, dest, count: Optional[int] = None) -> int:
+        return self._read_array_into(dest, count, self.endian, "d")
+
     def read_f64_le(self) -> float:
         return F64_LE.unpack(self.read(8))[0]
 
-    def read_f64_le_array(self, count: Optional[int] = None) -> Tuple[float, ...]:
+    def read_f64_le_array(
+        self, count: Optional[int] = None, as_array: bool = False
+    ) -> Union[Tuple[float, ...], memoryview]:
         if count is None:
             count = self.read_count()
         struct = Struct(f"<{count}d")
+        if as_array:
+            return self._read_typed_array(struct, "d")
         return struct.unpack(self.read(struct.size))
 
+    def read_f64_le_array_into(self, dest, count: Optional[int] = None) -> int:
+        return self._read_array_into(dest, count, "<", "d")
+
     def read_f64_be(self) -> float:
         return F64_BE.unpack(self.read(8))[0]
 
-    def read_f64_be_array(self, count: Optional[int] = None) -> Tuple[float, ...]:
+    def read_f64_be_array(
+        self, count: Optional[int] = None, as_array: bool = False
+    ) -> Union[Tuple[float, ...], memoryview]:
         if count is None:
             count = self.read_count()
         struct = Struct(f">{count}d")
+        if as_array:
+            return self._read_typed_array(struct, "d")
         return struct.unpack(self.read(struct.size))
 
+    def read_f64_be_array_into(self, dest, count: Optional[int] = None) -> int:
+        return self._read_array_into(dest, count, ">", "d")
+
     # strings
-    def read_cstring(self, encoding: str = "utf-8", errors="surrogateescape") -> str:
+    def _intern(self, string: str) -> str:
+        # the C readers only intern short ASCII strings, with a cache of the same size
+        if len(string) > 256 or not string.isascii():
+            return string
+        cache = self.__dict__.setdefault("_string_cache", {})
+        cached = cache.get(string)
+        if cached is None:
+            if len(cache) >= 16384:
+                cache.clear()
+            cached = cache[string] = string
+        return cached
+
+    def read_cstring(
+        self, encoding: str = "utf-8", errors="surrogateescape", intern: bool = False
+    ) -> str:
         """ ""Read a null-terminated string from the stream.
 
         Args:
             encoding (str, optional): The encoding to use. Defaults to "utf-8".
             errors (str, optional): The error handling scheme to use. Defaults to "surrogateescape".
+            intern (bool, optional): Return the same str for repeated ASCII strings, from a bounded cache of the reader. Defaults to False.
         """
         string = b""
         while True:
@@ -380,13 +691,36 @@ class EndianedReaderIOBase(IOBase, metaclass=abc.ABCMeta):
             if not char or char == b"\x00":
                 break
             string += char
-        return string.decode("utf-8", errors=errors)
+        string = string.decode(encoding, errors=errors)
+        return self._intern(string) if intern else string
+
+    def read_cstring_array(
+        self,
+        count: Optional[int] = None,
+        encoding: str = "utf-8",
+        errors="surrogateescape",
+        intern: bool = False,
+    ) -> Tuple[str, ...]:
+        """Read consecutive null-terminated strings from the stream.
+
+        Args:
+            count (int, optional): The number of strings to read. If None, use read_count to determine the length.
+            encoding (str, optional): The encoding to use. Defaults to "utf-8".
+            errors (str, optional): The error handling scheme to use. Defaults to "surrogateescape".
+            intern (bool, optional): Return the same str for repeated ASCII strings, from a bounded cache of the reader. Defaults to False.
+        """
+        if count is None:
+            count = self.read_count()
+        return tuple(
+            self.read_cstring(encoding, errors, intern) for _ in range(count)
+        )
 
     def read_string(
         self,
         length: Optional[int] = None,
         encoding: str = "utf-8",
         errors="surrogateescape",
+        intern: bool = False,
     ) -> str:
         """Read a string of a given length from the stream.
 
@@ -394,23 +728,40 @@ class EndianedReaderIOBase(IOBase, metaclass=abc.ABCMeta):
             length (int, optional): The length of the string to read. If None, use read_count to determine the length.
             encoding (str, optional): The encoding to use. Defaults to "utf-8".
             errors (str, optional): The error handling scheme to use. Defaults to "surrogateescape".
+            intern (bool, optional): Return the same str for repeated ASCII strings, from a bounded cache of the reader. Defaults to False.
         """
         if length is None:
             length = self.read_count()
-        return self.read(length).decode(encoding, errors=errors)
+        string = self.read(length).decode(encoding, errors=errors)
+        return self._intern(string) if intern else string
 
     def read_bytes(
         self,
         length: Optional[int] = None,
-    ) -> bytes:
+        copy: bool = True,
+    ) -> Union[bytes, memoryview]:
         """Read a bytes object of a given length from the stream.
 
         Args:
             length (int, optional): The length of the bytes to read. If None, use read_count to determine the length.
+            copy (bool, optional): If False, return a memoryview instead of bytes. Defaults to True.
         """
         if length is None:
             length = self.read_count()
-        return self.read(length)
+        if copy:
+            return self.read(length)
+        return self.read_view(length)
+
+    def read_view(self, size: Optional[int] = -1) -> memoryview:
+        """Read up to size bytes as a memoryview.
+
+        In-memory implementations return a slice of their buffer without copying,
+        the default implementation wraps the result of read.
+
+        Args:
+            size (int, optional): The number of bytes to read. If None or negative, read until the end.
+        """
+        return memoryview(self.read(size))
 
     # custom stuff
     def read_varint(self) -> int:
@@ -423,28 +774,396 @@ class EndianedReaderIOBase(IOBase, metaclass=abc.ABCMeta):
         shift = 0
         while True:
             byte = self.read_u8()
+            if shift == 63 and byte > 1:
+                raise OverflowError("Varint too large.")
             result |= (byte & 0x7F) << shift
             if not (byte & 0x80):
                 break
             shift += 7
         return result
 
-    def read_varint_array(self, count: Optional[int] = None) -> Tuple[int, ...]:
+    def read_svarint(self) -> int:
+        """Read a zigzag encoded signed variable-length integer from the stream.
+
+        Returns:
+            int: The signed variable-length integer.
+        """
+        value = self.read_varint()
+        return (value >> 1) ^ -(value & 1)
+
+    def read_struct(self, format: Union[str, Any]) -> Tuple[Any, ...]:
+        """Read a record of a struct format.
+
+        Args:
+            format (str | StructFormat): The format, native byte order formats use the endian of the reader.
+
+        Returns:
+            Tuple[Any, ...]: The values of the record.
+        """
+        struct = _endianed_struct(format, self.endian)
+        return struct.unpack(self.read(struct.size))
+
+    def read_struct_array(
+        self, format: Union[str, Any], count: Optional[int] = None
+    ) -> List[Tuple[Any, ...]]:
+        """Read a list of records of a struct format.
+
+        Args:
+            format (str | StructFormat): The format, native byte order formats use the endian of the reader.
+            count (int, optional): The number of records to read. If None, use read_count to determine the length.
+
+        Returns:
+            List[Tuple[Any, ...]]: The records.
+        """
+        if count is None:
+            count = self.read_count()
+        struct = _endianed_struct(format, self.endian)
+        if struct.size == 0:
+            return [() for _ in range(count)]
+        return list(struct.iter_unpack(self.read(struct.size * count)))
+
+    def read_varint_array(
+        self, count: Optional[int] = None, as_array: bool = False
+    ) -> Union[Tuple[int, ...], memoryview]:
         """Read a variable-length integer array from the stream.
 
         Args:
             count (int, optional): The number of variable-length integers to read. If None, use read_count to determine the length.
+            as_array (bool, optional): Return a u64 memoryview instead of a tuple. Defaults to False.
 
         Returns:
-            Tuple[int, ...]: The variable-length integer array.
+            Tuple[int, ...] | memoryview: The variable-length integer array.
         """
         if count is None:
             count = self.read_count()
-        return tuple(self.read_varint() for _ in range(count))
+        values = tuple(self.read_varint() for _ in range(count))
+        if as_array:
+            return memoryview(struct_pack(f"={count}Q", *values)).cast("Q")
+        return values
+
+    def read_svarint_array(
+        self, count: Optional[int] = None, as_array: bool = False
+    ) -> Union[Tuple[int, ...], memoryview]:
+        """Read a zigzag encoded signed variable-length integer array from the stream.
 
+        Args:
+            count (int, optional): The number of variable-length integers to read. If None, use read_count to determine the length.
+            as_array (bool, optional): Return an i64 memoryview instead of a tuple. Defaults to False.
+
+        Returns:
+            Tuple[int, ...] | memoryview: The signed variable-length integer array.
+        """
+        if count is None:
+            count = self.read_count()
+        values = tuple(self.read_svarint() for _ in range(count))
+        if as_array:
+            return memoryview(struct_pack(f"={count}q", *values)).cast("q")
+        return values
+
+    # positional reads
+    def _read_at(self, offset: int, read, *args, **kwargs):
+        if offset < 0:
+            raise ValueError("Offset must be non-negative.")
+        pos = self.tell()
+        self.seek(offset)
+        try:
+            return read(*args, **kwargs)
+        finally:
+            self.seek(pos)
+
+    def read_bool_at(self, offset: int) -> bool:
+        return self._read_at(offset, self.read_bool)
+
+    def read_bool_array_at(
+        self, offset: int, count: Optional[int] = None, as_array: bool = False
+    ) -> Union[Tuple[bool, ...], memoryview]:
+        return self._read_at(offset, self.read_bool_array, count, as_array)
+
+    def read_u8_at(self, offset: int) -> int:
+        return self._read_at(offset, self.read_u8)
+
+    def read_u8_array_at(
+        self, offset: int, count: Optional[int] = None, as_array: bool = False
+    ) -> Union[Tuple[int, ...], memoryview]:
+        return self._read_at(offset, self.read_u8_array, count, as_array)
+
+    def read_u16_at(self, offset: int) -> int:
+        return self._read_at(offset, self.read_u16)
+
+    def read_u16_array_at(
+        self, offset: int, count: Optional[int] = None, as_array: bool = False
+    ) -> Union[Tuple[int, ...], memoryview]:
+        return self._read_at(offset, self.read_u16_array, count, as_array)
+
+    def read_u16_le_at(self, offset: int) -> int:
+        return self._read_at(offset, self.read_u16_le)
+
+    def read_u16_le_array_at(
+        self, offset: int, count: Optional[int] = None, as_array: bool = False
+    ) -> Union[Tuple[int, ...], memoryview]:
+        return self._read_at(offset, self.read_u16_le_array, count, as_array)
+
+    def read_u16_be_at(self, offset: int) -> int:
+        return self._read_at(offset, self.read_u16_be)
+
+    def read_u16_be_array_at(
+        self, offset: int, count: Optional[int] = None, as_array: bool = False
+    ) -> Union[Tuple[int, ...], memoryview]:
+        return self._read_at(offset, self.read_u16_be_array, count, as_array)
+
+    def read_u32_at(self, offset: int) -> int:
+        return self._read_at(offset, self.read_u32)
+
+    def read_u32_array_at(
+        self, offset: int, count: Optional[int] = None, as_array: bool = False
+    ) -> Union[Tuple[int, ...], memoryview]:
+        return self._read_at(offset, self.read_u32_array, count, as_array)
+
+    def read_u32_le_at(self, offset: int) -> int:
+        return self._read_at(offset, self.read_u32_le)
+
+    def read_u32_le_array_at(
+        self, offset: int, count: Optional[int] = None, as_array: bool = False
+    ) -> Union[Tuple[int, ...], memoryview]:
+        return self._read_at(offset, self.read_u32_le_array, count, as_array)
+
+    def read_u32_be_at(self, offset: int) -> int:
+        return self._read_at(offset, self.read_u32_be)
+
+    def read_u32_be_array_at(
+        self, offset: int, count: Optional[int] = None, as_array: bool = False
+    ) -> Union[Tuple[int, ...], memoryview]:
+        return self._read_at(offset, self.read_u32_be_array, count, as_array)
+
+    def read_u64_at(self, offset: int) -> int:
+        return self._read_at(offset, self.read_u64)
+
+    def read_u64_array_at(
+        self, offset: int, count: Optional[int] = None, as_array: bool = False
+    ) -> Union[Tuple[int, ...], memoryview]:
+        return self._read_at(offset, self.read_u64_array, count, as_array)
+
+    def read_u64_le_at(self, offset: int) -> int:
+        return self._read_at(offset, self.read_u64_le)
+
+    def read_u64_le_array_at(
+        self, offset: int, count: Optional[int] = None, as_array: bool = False
+    ) -> Union[Tuple[int, ...], memoryview]:
+        return self._read_at(offset, self.read_u64_le_array, count, as_array)
+
+    def read_u64_be_at(self, offset: int) -> int:
+        return self._read_at(offset, self.read_u64_be)
+
+    def read_u64_be_array_at(
+        self, offset: int, count: Optional[int] = None, as_array: bool = False
+    ) -> Union[Tuple[int, ...], memoryview]:
+        return self._read_at(offset, self.read_u64_be_array, count, as_array)
+
+    def read_i8_at(self, offset: int) -> int:
+        return self._read_at(offset, self.read_i8)
+
+    def read_i8_array_at(
+        self, offset: int, count: Optional[int] = None, as_array: bool = False
+    ) -> Union[Tuple[int, ...], memoryview]:
+        return self._read_at(offset, self.read_i8_array, count, as_array)
+
+    def read_i16_at(self, offset: int) -> int:
+        return self._read_at(offset, self.read_i16)
+
+    def read_i16_array_at(
+        self, offset: int, count: Optional[int] = None, as_array: bool = False
+    ) -> Union[Tuple[int, ...], memoryview]:
+        return self._read_at(offset, self.read_i16_array, count, as_array)
+
+    def read_i16_le_at(self, offset: int) -> int:
+        return self._read_at(offset, self.read_i16_le)
+
+    def read_i16_le_array_at(
+        self, offset: int, count: Optional[int] = None, as_array: bool = False
+    ) -> Union[Tuple[int, ...], memoryview]:
+        return self._read_at(offset, self.read_i16_le_array, count, as_array)
+
+    def read_i16_be_at(self, offset: int) -> int:
+        return self._read_at(offset, self.read_i16_be)
+
+    def read_i16_be_array_at(
+        self, offset: int, count: Optional[int] = None, as_array: bool = False
+    ) -> Union[Tuple[int, ...], memoryview]:
+        return self._read_at(offset, self.read_i16_be_array, count, as_array)
+
+    def read_i32_at(self, offset: int) -> int:
+        return self._read_at(offset, self.read_i32)
+
+    def read_i32_array_at(
+        self, offset: int, count: Optional[int] = None, as_array: bool = False
+    ) -> Union[Tuple[int, ...], memoryview]:
+        return self._read_at(offset, self.read_i32_array, count, as_array)
+
+    def read_i32_le_at(self, offset: int) -> int:
+        return self._read_at(offset, self.read_i32_le)
+
+    def read_i32_le_array_at(
+        self, offset: int, count: Optional[int] = None, as_array: bool = False
+    ) -> Union[Tuple[int, ...], memoryview]:
+        return self._read_at(offset, self.read_i32_le_array, count, as_array)
+
+    def read_i32_be_at(self, offset: int) -> int:
+        return self._read_at(offset, self.read_i32_be)
+
+    def read_i32_be_array_at(
+        self, offset: int, count: Optional[int] = None, as_array: bool = False
+    ) -> Union[Tuple[int, ...], memoryview]:
+        return self._read_at(offset, self.read_i32_be_array, count, as_array)
+
+    def read_i64_at(self, offset: int) -> int:
+        return self._read_at(offset, self.read_i64)
+
+    def read_i64_array_at(
+        self, offset: int, count: Optional[int] = None, as_array: bool = False
+    ) -> Union[Tuple[int, ...], memoryview]:
+        return self._read_at(offset, self.read_i64_array, count, as_array)
+
+    def read_i64_le_at(self, offset: int) -> int:
+        return self._read_at(offset, self.read_i64_le)
+
+    def read_i64_le_array_at(
+        self, offset: int, count: Optional[int] = None, as_array: bool = False
+    ) -> Union[Tuple[int, ...], memoryview]:
+        return self._read_at(offset, self.read_i64_le_array, count, as_array)
+
+    def read_i64_be_at(self, offset: int) -> int:
+        return self._read_at(offset, self.read_i64_be)
+
+    def read_i64_be_array_at(
+        self, offset: int, count: Optional[int] = None, as_array: bool = False
+    ) -> Union[Tuple[int, ...], memoryview]:
+        return self._read_at(offset, self.read_i64_be_array, count, as_array)
+
+    def read_f16_at(self, offset: int) -> float:
+        return self._read_at(offset, self.read_f16)
+
+    def read_f16_array_at(
+        self, offset: int, count: Optional[int] = None, as_array: bool = False
+    ) -> Union[Tuple[float, ...], memoryview]:
+        return self._read_at(offset, self.read_f16_array, count, as_array)
+
+    def read_f16_le_at(self, offset: int) -> float:
+        return self._read_at(offset, self.read_f16_le)
+
+    def read_f16_le_array_at(
+        self, offset: int, count: Optional[int] = None, as_array: bool = False
+    ) -> Union[Tuple[float, ...], memoryview]:
+        return self._read_at(offset, self.read_f16_le_array, count, as_array)
+
+    def read_f16_be_at(self, offset: int) -> float:
+        return self._read_at(offset, self.read_f16_be)
+
+    def read_f16_be_array_at(
+        self, offset: int, count: Optional[int] = None, as_array: bool = False
+    ) -> Union[Tuple[float, ...], memoryview]:
+        return self._read_at(offset, self.read_f16_be_array, count, as_array)
+
+    def read_f32_at(self, offset: int) -> float:
+        return self._read_at(offset, self.read_f32)
+
+    def read_f32_array_at(
+        self, offset: int, count: Optional[int] = None, as_array: bool = False
+    ) -> Union[Tuple[float, ...], memoryview]:
+        return self._read_at(offset, self.read_f32_array, count, as_array)
+
+    def read_f32_le_at(self, offset: int) -> float:
+        return self._read_at(offset, self.read_f32_le)
+
+    def read_f32_le_array_at(
+        self, offset: int, count: Optional[int] = None, as_array: bool = False
+    ) -> Union[Tuple[float, ...], memoryview]:
+        return self._read_at(offset, self.read_f32_le_array, count, as_array)
+
+    def read_f32_be_at(self, offset: int) -> float:
+        return self._read_at(offset, self.read_f32_be)
+
+    def read_f32_be_array_at(
+        self, offset: int, count: Optional[int] = None, as_array: bool = False
+    ) -> Union[Tuple[float, ...], memoryview]:
+        return self._read_at(offset, self.read_f32_be_array, count, as_array)
+
+    def read_f64_at(self, offset: int) -> float:
+        return self._read_at(offset, self.read_f64)
+
+    def read_f64_array_at(
+        self, offset: int, count: Optional[int] = None, as_array: bool = False
+    ) -> Union[Tuple[float, ...], memoryview]:
+        return self._read_at(offset, self.read_f64_array, count, as_array)
+
+    def read_f64_le_at(self, offset: int) -> float:
+        return self._read_at(offset, self.read_f64_le)
+
+    def read_f64_le_array_at(
+        self, offset: int, count: Optional[int] = None, as_array: bool = False
+    ) -> Union[Tuple[float, ...], memoryview]:
+        return self._read_at(offset, self.read_f64_le_array, count, as_array)
+
+    def read_f64_be_at(self, offset: int) -> float:
+        return self._read_at(offset, self.read_f64_be)
+
+    def read_f64_be_array_at(
+        self, offset: int, count: Optional[int] = None, as_array: bool = False
+    ) -> Union[Tuple[float, ...], memoryview]:
+        return self._read_at(offset, self.read_f64_be_array, count, as_array)
+
+    def read_cstring_at(
+        self,
+        offset: int,
+        encoding: str = "utf-8",
+        errors="surrogateescape",
+        intern: bool = False,
+    ) -> str:
+        return self._read_at(offset, self.read_cstring, encoding, errors, intern)
+
+    def read_cstring_table(
+        self,
+        offsets: Sequence[int],
+        base: Optional[int] = None,
+        encoding: str = "utf-8",
+        errors="surrogateescape",
+        intern: bool = False,
+    ) -> Tuple[str, ...]:
+        """Read the null-terminated strings at base + offset for every offset, without moving the position.
+
+        Args:
+            offsets (Sequence[int]): The offsets of the strings, relative to base.
+            base (int, optional): The start of the string table. Defaults to the current position.
+            encoding (str, optional): The encoding to use. Defaults to "utf-8".
+            errors (str, optional): The error handling scheme to use. Defaults to "surrogateescape".
+            intern (bool, optional): Return the same str for repeated ASCII strings, from a bounded cache of the reader. Defaults to False.
+        """
+        if base is None:
+            base = self.tell()
+        return tuple(
+            self.read_cstring_at(base + offset, encoding, errors, intern)
+            for offset in offsets
+        )
+
+    def read_string_at(
+        self,
+        offset: int,
+        length: Optional[int] = None,
+        encoding: str = "utf-8",
+        errors="surrogateescape",
+        intern: bool = False,
+    ) -> str:
+        return self._read_at(
+            offset, self.read_string, length, encoding, errors, intern
+        )
+
+    def read_bytes_at(
+        self, offset: int, length: Optional[int] = None, copy: bool = True
+    ) -> Union[bytes, memoryview]:
+        return self._read_at(offset, self.read_bytes, length, copy)
 
 class EndianedWriterIOBase(IOBase, metaclass=abc.ABCMeta):
     endian: Endianess
+    count_type: Optional[CountType] = None
 
     def align(self, size: int) -> int:
         padding = size - (self.tell() % size)
@@ -457,7 +1176,9 @@ class EndianedWriterIOBase(IOBase, metaclass=abc.ABCMeta):
         return self.tell()
 
     def write_count(self, count: int) -> int:
-        return self.write_i32(count)
+        if self.count_type is None:
+            return self.write_i32(count)
+        return getattr(self, f"write_{self.count_type}")(count)
 
     # bool
     def write_bool(self, v: bool) -> int:
@@ -799,12 +1520,7 @@ class EndianedWriterIOBase(IOBase, metaclass=abc.ABCMeta):
         Args:
             v (int): The variable-length integer to write.
         """
-        result = 0
-        while v > 0x7F:
-            self.write_u8((v & 0x7F) | 0x80)
-            v >>= 7
-            result += 1
-        return self.write_u8(v)
+        return self.write(_encode_varint(v))
 
     def write_varint_array(self, v: Sequence[int], write_count: bool = True) -> int:
         """Write a variable-length integer array to the stream.
@@ -813,9 +1529,59 @@ class EndianedWriterIOBase(IOBase, metaclass=abc.ABCMeta):
             v (Sequence[int]): The variable-length integer array to write.
             write_count (bool, optional): Whether to write the length of the array first. Defaults to True.
         """
+        data = b"".join(_encode_varint(i) for i in v)
         if write_count:
             self.write_count(len(v))
-        return sum(self.write_varint(i) for i in v)
+        return self.write(data)
+
+    def write_svarint(self, v: int) -> int:
+        """Write a zigzag encoded signed variable-length integer to the stream.
+
+        Args:
+            v (int): The signed variable-length integer to write, has to fit into an i64.
+        """
+        return self.write(_encode_varint(_zigzag(v)))
+
+    def write_svarint_array(self, v: Sequence[int], write_count: bool = True) -> int:
+        """Write a zigzag encoded signed variable-length integer array to the stream.
+
+        Args:
+            v (Sequence[int]): The signed variable-length integer array to write.
+            write_count (bool, optional): Whether to write the length of the array first. Defaults to True.
+        """
+        data = b"".join(_encode_varint(_zigzag(i)) for i in v)
+        if write_count:
+            self.write_count(len(v))
+        return self.write(data)
+
+    def write_struct(self, format: Union[str, Any], v: Sequence[Any]) -> int:
+        """Write a record of a struct format.
+
+        Args:
+            format (str | StructFormat): The format, native byte order formats use the endian of the writer.
+            v (Sequence[Any]): The values of the record.
+        """
+        struct = _endianed_struct(format, self.endian)
+        return self.write(struct.pack(*v))
+
+    def write_struct_array(
+        self,
+        format: Union[str, Any],
+        v: Sequence[Sequence[Any]],
+        write_count: bool = True,
+    ) -> int:
+        """Write a list of records of a struct format.
+
+        Args:
+            format (str | StructFormat): The format, native byte order formats use the endian of the writer.
+            v (Sequence[Sequence[Any]]): The records to write.
+            write_count (bool, optional): Whether to write the number of records first. Defaults to True.
+        """
+        struct = _endianed_struct(format, self.endian)
+        data = b"".join(struct.pack(*record) for record in v)
+        if write_count:
+            self.write_count(len(v))
+        return self.write(data)
 
 
 class EndianedIOBase(EndianedReaderIOBase, EndianedWriterIOBase):
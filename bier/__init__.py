@@ -1 +1,6 @@
 __version__ = "0.0.3"
+
+try:
+    from .EndianedBinaryIO.C.StructFormat import compile as compile
+except ImportError:
+    from .EndianedBinaryIO.EndianedIOBase import _compile_struct_format as compile
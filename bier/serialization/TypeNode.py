@@ -1,5 +1,6 @@
 from abc import ABCMeta
 from dataclasses import dataclass
+from functools import cached_property
 from enum import Enum
 from typing import Any, Callable, ClassVar, Self, Sequence
 
@@ -70,6 +71,10 @@ class PrimitiveNode[T](TypeNode[T]):
     """
 
     size: ClassVar[int]
+    # the suffix of the read_/write_ functions and the struct format code,
+    # used to read/write arrays of primitives in bulk
+    name: ClassVar[str]
+    format: ClassVar[str]
 
     def __new__(cls, *args, **kwargs) -> Self:
         if cls in PRIMITIVE_INSTANCE_MAP:
@@ -89,6 +94,8 @@ PRIMITIVE_INSTANCE_MAP: PrimitiveInstanceMapType = {}
 
 class U8Node(PrimitiveNode[int]):
     size = 1
+    name = "u8"
+    format = "B"
 
     def read_from(self, reader, context=None):
         return reader.read_u8()
@@ -99,6 +106,8 @@ class U8Node(PrimitiveNode[int]):
 
 class U16Node(PrimitiveNode[int]):
     size = 2
+    name = "u16"
+    format = "H"
 
     def read_from(self, reader, context=None):
         return reader.read_u16()
@@ -109,6 +118,8 @@ class U16Node(PrimitiveNode[int]):
 
 class U32Node(PrimitiveNode[int]):
     size = 4
+    name = "u32"
+    format = "I"
 
     def read_from(self, reader, context=None):
         return reader.read_u32()
@@ -119,6 +130,8 @@ class U32Node(PrimitiveNode[int]):
 
 class U64Node(PrimitiveNode[int]):
     size = 8
+    name = "u64"
+    format = "Q"
 
     def read_from(self, reader, context=None):
         return reader.read_u64()
@@ -129,6 +142,8 @@ class U64Node(PrimitiveNode[int]):
 
 class I8Node(PrimitiveNode[int]):
     size = 1
+    name = "i8"
+    format = "b"
 
     def read_from(self, reader, context=None):
         return reader.read_i8()
@@ -139,6 +154,8 @@ class I8Node(PrimitiveNode[int]):
 
 class I16Node(PrimitiveNode[int]):
     size = 2
+    name = "i16"
+    format = "h"
 
     def read_from(self, reader, context=None):
         return reader.read_i16()
@@ -149,6 +166,8 @@ class I16Node(PrimitiveNode[int]):
 
 class I32Node(PrimitiveNode[int]):
     size = 4
+    name = "i32"
+    format = "i"
 
     def read_from(self, reader, context=None):
         return reader.read_i32()
@@ -159,6 +178,8 @@ class I32Node(PrimitiveNode[int]):
 
 class I64Node(PrimitiveNode[int]):
     size = 8
+    name = "i64"
+    format = "q"
 
     def read_from(self, reader, context=None):
         return reader.read_i64()
@@ -169,6 +190,8 @@ class I64Node(PrimitiveNode[int]):
 
 class F16Node(PrimitiveNode[float]):
     size = 2
+    name = "f16"
+    format = "e"
 
     def read_from(self, reader, context=None):
         return reader.read_f16()
@@ -179,6 +202,8 @@ class F16Node(PrimitiveNode[float]):
 
 class F32Node(PrimitiveNode[float]):
     size = 4
+    name = "f32"
+    format = "f"
 
     def read_from(self, reader, context=None):
         return reader.read_f32()
@@ -189,6 +214,8 @@ class F32Node(PrimitiveNode[float]):
 
 class F64Node(PrimitiveNode[float]):
     size = 8
+    name = "f64"
+    format = "d"
 
     def read_from(self, reader, context=None):
         return reader.read_f64()
@@ -197,25 +224,49 @@ class F64Node(PrimitiveNode[float]):
         return writer.write_f64(value)
 
 
+# the builtin primitives, subclasses might change the behavior
+PRIMITIVE_NODES: frozenset[type[PrimitiveNode]] = frozenset(
+    (
+        U8Node,
+        U16Node,
+        U32Node,
+        U64Node,
+        I8Node,
+        I16Node,
+        I32Node,
+        I64Node,
+        F16Node,
+        F32Node,
+        F64Node,
+    )
+)
+
+
 @dataclass(frozen=True)
 class StringNode(TypeNode[str]):
     """StringNode is either a length-prefixed string or a C-style string.
 
     If type_info is None, it is a C-style string.
     If type_info is a TypeNode, it is a length-prefixed string with the given type as the length encoding.
+    If intern is set, repeated values, e.g. type and field names, share one str from the string cache of the reader.
     """
 
     size_node: TypeNode[int] | None = None
     encoding: str = "utf-8"
     errors: str = "surrogateescape"
+    intern: bool = False
 
     def read_from(self, reader, context=None):
         if self.size_node is None:
             # C-style string
+            if self.intern:
+                return reader.read_cstring(intern=True)
             return reader.read_cstring()
         else:
             # Length-prefixed string
             length = self.size_node.read_from(reader, context)
+            if self.intern:
+                return reader.read_string(length, self.encoding, self.errors, True)
             return reader.read(length).decode(self.encoding, self.errors)
 
     def write_to(self, value, writer, context=None):
@@ -260,13 +311,39 @@ class ListNode[T](TypeNode[list[T]]):
     elem_node: TypeNode[T]
     size_node: TypeNode[int]
 
+    @cached_property
+    def _bulk(self) -> tuple[str, str, str | None] | None:
+        """The reader/writer functions that handle all elements in one call.
+
+        Lists of primitives use read_*_array/write_*_array,
+        lists of tuples of primitives read_struct_array/write_struct_array with the struct format.
+        """
+        if type(self.elem_node) in PRIMITIVE_NODES:
+            name = self.elem_node.name
+            return (f"read_{name}_array", f"write_{name}_array", None)
+        if type(self.elem_node) is TupleNode and self.elem_node._format is not None:
+            return ("read_struct_array", "write_struct_array", self.elem_node._format)
+        return None
+
     def read_from(self, reader, context=None):
         # TODO: change context to be read list fields?
         length = self.size_node.read_from(reader, context)
+        bulk = self._bulk
+        if bulk is not None:
+            read_name, _, format = bulk
+            read = getattr(reader, read_name)
+            return list(read(length) if format is None else read(format, length))
         return [self.elem_node.read_from(reader, context) for _ in range(length)]
 
     def write_to(self, value: Sequence[T], writer, context=None) -> int:
         total_size = self.size_node.write_to(len(value), writer, context)
+        bulk = self._bulk
+        if bulk is not None:
+            _, write_name, format = bulk
+            write = getattr(writer, write_name)
+            if format is None:
+                return total_size + write(value, write_count=False)
+            return total_size + write(format, value, write_count=False)
         total_size += sum(
             self.elem_node.write_to(element, writer, context) for element in value
         )
@@ -279,11 +356,22 @@ class TupleNode[T](TypeNode[tuple[T, ...]]):
 
     nodes: tuple[TypeNode[T], ...]
 
+    @cached_property
+    def _format(self) -> str | None:
+        """The struct format of the tuple if it only consists of primitives."""
+        if self.nodes and all(type(node) in PRIMITIVE_NODES for node in self.nodes):
+            return "".join(node.format for node in self.nodes)
+        return None
+
     def read_from(self, reader, context=None):
         # TODO: change context to be read tuple fields?
+        if self._format is not None:
+            return reader.read_struct(self._format)
         return tuple(node.read_from(reader, context) for node in self.nodes)
 
     def write_to(self, value: tuple[T, ...], writer, context=None) -> int:
+        if self._format is not None:
+            return writer.write_struct(self._format, value)
         return sum(
             node.write_to(val, writer, context) for node, val in zip(self.nodes, value)
         )
@@ -297,7 +385,18 @@ class ClassNode[T](TypeNode[T]):
     names: tuple[str, ...]
     call: Callable[[dict[str, Any]], T]
 
+    @cached_property
+    def schema(self) -> Any:
+        """The node tree lowered for the native read_schema/write_schema of the C IO classes."""
+        from .schema import lower_type_node
+
+        return lower_type_node(self)
+
     def read_from(self, reader, context=None):
+        read_schema = getattr(reader, "read_schema", None)
+        if read_schema is not None and self.schema is not None:
+            return read_schema(self.schema)
+
         read_fields = {}
         for name, node in zip(self.names, self.nodes):
             read_fields[name] = node.read_from(reader, read_fields)
@@ -305,6 +404,10 @@ class ClassNode[T](TypeNode[T]):
         return self.call(read_fields)
 
     def write_to(self, value: T, writer, context=None):
+        write_schema = getattr(writer, "write_schema", None)
+        if write_schema is not None and self.schema is not None:
+            return write_schema(self.schema, value)
+
         return sum(
             node.write_to(getattr(value, name), writer, value)
             for name, node in zip(self.names, self.nodes)
@@ -0,0 +1,118 @@
+"""Lowering of node trees into schemas that the C IO classes execute natively.
+
+A lowered schema reads or writes a whole object with a single call of
+``read_schema``/``write_schema`` on EndianedBytesIO/EndianedStreamIO,
+instead of dispatching every field through the Python nodes.
+Nodes that can't be lowered, e.g. custom TypeNode subclasses,
+are embedded as they are and executed via their read_from/write_to.
+"""
+
+from inspect import isclass
+from typing import Any
+
+from .TypeNode import (
+    PRIMITIVE_NODES,
+    BytesNode,
+    ClassNode,
+    ConvertNode,
+    EnumNode,
+    ListNode,
+    MemberLengthNode,
+    StaticLengthNode,
+    StringNode,
+    StructNode,
+    TupleNode,
+    TypeNode,
+)
+
+try:
+    from ..EndianedBinaryIO.C.Schema import Schema
+except ImportError:
+    Schema = None
+
+
+def lower_type_node(node: ClassNode) -> Any:
+    """Lowers a ClassNode into a Schema.
+
+    Returns None if the C extension isn't available.
+    """
+    if Schema is None:
+        return None
+    owner = getattr(node.call, "__self__", None)
+    return Schema(_lower(node, {owner} if isclass(owner) else set()))
+
+
+def _is_plain_binary_serializable(clz: type) -> bool:
+    # only inline classes that use the default node based (de)serialization
+    from .BinarySerializable import BinarySerializable
+
+    return (
+        isclass(clz)
+        and issubclass(clz, BinarySerializable)
+        and clz.read_from.__func__ is BinarySerializable.read_from.__func__
+        and clz.write_to is BinarySerializable.write_to
+        and clz._get_node.__func__ is BinarySerializable._get_node.__func__
+    )
+
+
+def _lower(node: TypeNode, in_progress: set[type]) -> tuple:
+    # exact type checks, subclasses might change the behavior
+    node_type = type(node)
+
+    if node_type in PRIMITIVE_NODES:
+        return ("prim", node.format)
+    if node_type is StaticLengthNode:
+        return ("static", node.size)
+    if node_type is MemberLengthNode:
+        return ("member", node.member_name)
+    if node_type is StringNode:
+        if node.size_node is None:
+            return ("cstring", node.intern)
+        return (
+            "string",
+            _lower(node.size_node, in_progress),
+            node.encoding,
+            node.errors,
+            node.intern,
+        )
+    if node_type is BytesNode:
+        return ("bytes", _lower(node.size_node, in_progress))
+    if node_type is ListNode:
+        return (
+            "list",
+            _lower(node.size_node, in_progress),
+            _lower(node.elem_node, in_progress),
+        )
+    if node_type is TupleNode:
+        return ("tuple", tuple(_lower(n, in_progress) for n in node.nodes))
+    if node_type is ClassNode:
+        return (
+            "class",
+            tuple(node.names),
+            tuple(_lower(n, in_progress) for n in node.nodes),
+            node.call,
+        )
+    if node_type is EnumNode:
+        return ("enum", node.clz, _lower(node.value_node, in_progress))
+    if node_type is ConvertNode:
+        return (
+            "convert",
+            _lower(node.raw_node, in_progress),
+            node.from_raw,
+            node.to_raw,
+        )
+    if (
+        node_type is StructNode
+        and node.clz not in in_progress
+        and _is_plain_binary_serializable(node.clz)
+    ):
+        # recursive classes stay python nodes, they would never end otherwise
+        in_progress.add(node.clz)
+        try:
+            return _lower(node.clz._get_node(), in_progress)
+        finally:
+            in_progress.discard(node.clz)
+    return ("node", node)
+
+
+__all__ = ("lower_type_node",)
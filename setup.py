@@ -1,5 +1,6 @@
 import platform
 import sys
+import sysconfig
 
 from setuptools import Extension, find_packages, setup
 from setuptools.command.bdist_wheel import bdist_wheel
@@ -13,9 +14,13 @@ default_sources = [
     "src/EndianedBinaryIO/PyFloat_Half.cpp",
 ]
 default_depends = [
+    "src/EndianedBinaryIO/ByteSearch.hpp",
+    "src/EndianedBinaryIO/ByteSwap.hpp",
     "src/EndianedBinaryIO/EndianedIOBase.hpp",
     "src/EndianedBinaryIO/PyConverter.hpp",
     "src/EndianedBinaryIO/PyFloat_Half.hpp",
+    "src/EndianedBinaryIO/Schema.hpp",
+    "src/EndianedBinaryIO/StructFormat.hpp",
 ]
 
 
@@ -32,7 +37,9 @@ class bdist_wheel_abi3(bdist_wheel):
 
 # only use the limited API if Python 3.11 or newer is used
 # 3.11 added PyBuffer support to the limited API,
-py_limited_api = sys.version_info >= (3, 12)
+# free-threaded builds (3.13t+) don't support the limited API
+free_threaded = bool(sysconfig.get_config_var("Py_GIL_DISABLED"))
+py_limited_api = sys.version_info >= (3, 12) and not free_threaded
 cmdclass = {"bdist_wheel": bdist_wheel_abi3} if py_limited_api else {}
 
 setup(
@@ -48,6 +55,24 @@ setup(
             extra_compile_args=extra_compile_args,
             py_limited_api=py_limited_api,
         ),
+        Extension(
+            "bier.EndianedBinaryIO.C.StructFormat",
+            ["src/EndianedBinaryIO/StructFormat.cpp", *default_sources],
+            depends=default_depends,
+            language="c++",
+            include_dirs=["src"],
+            extra_compile_args=extra_compile_args,
+            py_limited_api=py_limited_api,
+        ),
+        Extension(
+            "bier.EndianedBinaryIO.C.Schema",
+            ["src/EndianedBinaryIO/Schema.cpp", *default_sources],
+            depends=default_depends,
+            language="c++",
+            include_dirs=["src"],
+            extra_compile_args=extra_compile_args,
+            py_limited_api=py_limited_api,
+        ),
         Extension(
             "bier.EndianedBinaryIO.C.EndianedStreamIO",
             ["src/EndianedBinaryIO/EndianedStreamIO.cpp", *default_sources],
@@ -57,6 +82,15 @@ setup(
             extra_compile_args=extra_compile_args,
             py_limited_api=py_limited_api,
         ),
+        Extension(
+            "bier.EndianedBinaryIO.C.EndianedFileIO",
+            ["src/EndianedBinaryIO/EndianedFileIO.cpp", *default_sources],
+            depends=default_depends,
+            language="c++",
+            include_dirs=["src"],
+            extra_compile_args=extra_compile_args,
+            py_limited_api=py_limited_api,
+        ),
         # somehow slower than the pure python version
         # Extension(
         #     "bier.EndianedBinaryIO.C.EndianedIOBase",
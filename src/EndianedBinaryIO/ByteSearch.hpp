@@ -0,0 +1,271 @@
+/**
+ * @file ByteSearch.hpp
+ * @brief Vectorized search of a byte pattern in a buffer and a pure ASCII check.
+ *
+ * Candidate positions are found by comparing the first and the last byte of the pattern
+ * against a whole vector of positions at once, only the candidates that match both are compared with memcmp.
+ * Single byte patterns go to memchr, which the C library already vectorizes.
+ * The best kernel is chosen per platform:
+ * - x86: AVX2 (runtime detected with GCC/Clang, compile time with MSVC), otherwise SSE2
+ * - ARM64: NEON
+ * - everything else: memchr for the first byte and memcmp
+ */
+#pragma once
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <immintrin.h>
+#define BIER_BYTESEARCH_SSE2
+#if defined(__GNUC__) || defined(__clang__)
+#define BIER_BYTESEARCH_AVX2
+#define BIER_BYTESEARCH_TARGET_AVX2 __attribute__((target("avx2")))
+#elif defined(__AVX2__)
+#define BIER_BYTESEARCH_AVX2
+#define BIER_BYTESEARCH_TARGET_AVX2
+#endif
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#include <arm_neon.h>
+#define BIER_BYTESEARCH_NEON
+#endif
+
+namespace bytesearch_kernels
+{
+    /**
+     * @brief Checks the candidates of a bitmask, bit i is set if position + i matches the first and last byte.
+     *
+     * @param bits_per_position 1 for the x86 movemask, 4 for the NEON narrowing shift
+     */
+    template <int bits_per_position>
+    static inline const uint8_t *verify(const uint8_t *position, uint64_t mask, const uint8_t *pattern, size_t pattern_size)
+    {
+        while (mask != 0)
+        {
+            const int offset = std::countr_zero(mask) / bits_per_position;
+            if (memcmp(position + offset + 1, pattern + 1, pattern_size - 2) == 0)
+            {
+                return position + offset;
+            }
+            if constexpr (bits_per_position == 1)
+            {
+                mask &= mask - 1;
+            }
+            else
+            {
+                mask &= ~(static_cast<uint64_t>((1u << bits_per_position) - 1) << (offset * bits_per_position));
+            }
+        }
+        return nullptr;
+    }
+
+    static inline const uint8_t *scalar(const uint8_t *data, size_t size, const uint8_t *pattern, size_t pattern_size)
+    {
+        if (size < pattern_size)
+        {
+            return nullptr;
+        }
+        const uint8_t *end = data + size - pattern_size + 1;
+        while (data < end)
+        {
+            data = static_cast<const uint8_t *>(memchr(data, pattern[0], end - data));
+            if (data == nullptr)
+            {
+                return nullptr;
+            }
+            if (memcmp(data + 1, pattern + 1, pattern_size - 1) == 0)
+            {
+                return data;
+            }
+            ++data;
+        }
+        return nullptr;
+    }
+
+#ifdef BIER_BYTESEARCH_AVX2
+    /**
+     * @return the match or nullptr, done receives the number of positions that were checked
+     */
+    BIER_BYTESEARCH_TARGET_AVX2 static const uint8_t *avx2(const uint8_t *data, size_t size, const uint8_t *pattern, size_t pattern_size, size_t &done)
+    {
+        const __m256i first = _mm256_set1_epi8(static_cast<char>(pattern[0]));
+        const __m256i last = _mm256_set1_epi8(static_cast<char>(pattern[pattern_size - 1]));
+        size_t i = 0;
+        for (; i + pattern_size - 1 + 32 <= size; i += 32)
+        {
+            const __m256i block_first = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i));
+            const __m256i block_last = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i + pattern_size - 1));
+            const uint32_t mask = static_cast<uint32_t>(_mm256_movemask_epi8(
+                _mm256_and_si256(_mm256_cmpeq_epi8(first, block_first), _mm256_cmpeq_epi8(last, block_last))));
+            if (mask != 0)
+            {
+                if (const uint8_t *match = verify<1>(data + i, mask, pattern, pattern_size))
+                {
+                    return match;
+                }
+            }
+        }
+        done = i;
+        return nullptr;
+    }
+
+    static inline bool has_avx2()
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        static const bool supported = __builtin_cpu_supports("avx2");
+        return supported;
+#else
+        return true;
+#endif
+    }
+#endif
+
+#ifdef BIER_BYTESEARCH_SSE2
+    static const uint8_t *sse2(const uint8_t *data, size_t size, const uint8_t *pattern, size_t pattern_size, size_t &done)
+    {
+        const __m128i first = _mm_set1_epi8(static_cast<char>(pattern[0]));
+        const __m128i last = _mm_set1_epi8(static_cast<char>(pattern[pattern_size - 1]));
+        size_t i = 0;
+        for (; i + pattern_size - 1 + 16 <= size; i += 16)
+        {
+            const __m128i block_first = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i));
+            const __m128i block_last = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i + pattern_size - 1));
+            const uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(
+                _mm_and_si128(_mm_cmpeq_epi8(first, block_first), _mm_cmpeq_epi8(last, block_last))));
+            if (mask != 0)
+            {
+                if (const uint8_t *match = verify<1>(data + i, mask, pattern, pattern_size))
+                {
+                    return match;
+                }
+            }
+        }
+        done = i;
+        return nullptr;
+    }
+#endif
+
+#ifdef BIER_BYTESEARCH_NEON
+    static const uint8_t *neon(const uint8_t *data, size_t size, const uint8_t *pattern, size_t pattern_size, size_t &done)
+    {
+        const uint8x16_t first = vdupq_n_u8(pattern[0]);
+        const uint8x16_t last = vdupq_n_u8(pattern[pattern_size - 1]);
+        size_t i = 0;
+        for (; i + pattern_size - 1 + 16 <= size; i += 16)
+        {
+            const uint8x16_t eq = vandq_u8(vceqq_u8(first, vld1q_u8(data + i)),
+                                           vceqq_u8(last, vld1q_u8(data + i + pattern_size - 1)));
+            // NEON has no movemask, narrowing every byte to 4 bits gives a 64-bit mask instead
+            const uint64_t mask = vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(eq), 4)), 0);
+            if (mask != 0)
+            {
+                if (const uint8_t *match = verify<4>(data + i, mask, pattern, pattern_size))
+                {
+                    return match;
+                }
+            }
+        }
+        done = i;
+        return nullptr;
+    }
+
+    static inline bool is_ascii(const uint8_t *data, size_t size, size_t &done)
+    {
+        uint8x16_t acc = vdupq_n_u8(0);
+        size_t i = 0;
+        for (; i + 16 <= size; i += 16)
+        {
+            acc = vorrq_u8(acc, vld1q_u8(data + i));
+        }
+        done = i;
+        return vmaxvq_u8(acc) < 0x80;
+    }
+#endif
+
+#ifdef BIER_BYTESEARCH_SSE2
+    static inline bool is_ascii(const uint8_t *data, size_t size, size_t &done)
+    {
+        __m128i acc = _mm_setzero_si128();
+        size_t i = 0;
+        for (; i + 16 <= size; i += 16)
+        {
+            acc = _mm_or_si128(acc, _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i)));
+        }
+        done = i;
+        return _mm_movemask_epi8(acc) == 0;
+    }
+#endif
+}
+
+/**
+ * @brief Finds the first occurrence of pattern in data, like memmem.
+ *
+ * @return Pointer to the match, data for an empty pattern or nullptr if there is none
+ */
+static inline const uint8_t *byte_search(const void *data, size_t size, const void *pattern, size_t pattern_size)
+{
+    const uint8_t *ptr = static_cast<const uint8_t *>(data);
+    const uint8_t *needle = static_cast<const uint8_t *>(pattern);
+    if (pattern_size == 0)
+    {
+        return ptr;
+    }
+    if (pattern_size > size)
+    {
+        return nullptr;
+    }
+    if (pattern_size == 1)
+    {
+        return static_cast<const uint8_t *>(memchr(ptr, needle[0], size));
+    }
+
+    size_t done = 0;
+    const uint8_t *match = nullptr;
+#if defined(BIER_BYTESEARCH_AVX2)
+    if (bytesearch_kernels::has_avx2())
+    {
+        match = bytesearch_kernels::avx2(ptr, size, needle, pattern_size, done);
+    }
+    else
+#endif
+    {
+#if defined(BIER_BYTESEARCH_SSE2)
+        match = bytesearch_kernels::sse2(ptr, size, needle, pattern_size, done);
+#elif defined(BIER_BYTESEARCH_NEON)
+        match = bytesearch_kernels::neon(ptr, size, needle, pattern_size, done);
+#endif
+    }
+    if (match != nullptr)
+    {
+        return match;
+    }
+    return bytesearch_kernels::scalar(ptr + done, size - done, needle, pattern_size);
+}
+
+/**
+ * @brief Checks if no byte has the high bit set, strings are mostly short, so there is no AVX2 kernel.
+ */
+static inline bool bytes_are_ascii(const void *data, size_t size)
+{
+    const uint8_t *ptr = static_cast<const uint8_t *>(data);
+    size_t done = 0;
+#if defined(BIER_BYTESEARCH_SSE2) || defined(BIER_BYTESEARCH_NEON)
+    if (!bytesearch_kernels::is_ascii(ptr, size, done))
+    {
+        return false;
+    }
+#endif
+    uint64_t acc = 0;
+    for (; done + 8 <= size; done += 8)
+    {
+        uint64_t word;
+        memcpy(&word, ptr + done, 8);
+        acc |= word;
+    }
+    for (; done < size; ++done)
+    {
+        acc |= ptr[done];
+    }
+    return (acc & 0x8080808080808080ull) == 0;
+}
@@ -0,0 +1,167 @@
+/**
+ * @file ByteSwap.hpp
+ * @brief Vectorized in-place byteswap kernels for arrays of 2, 4 and 8 byte values.
+ *
+ * The kernels process the bulk of an array with SIMD shuffles and finish the tail with
+ * the scalar std::byteswap. The best kernel is chosen per platform:
+ * - x86: AVX2 (runtime detected with GCC/Clang, compile time with MSVC), otherwise SSE2
+ * - ARM64: NEON
+ * - everything else: scalar
+ *
+ * The data pointer doesn't have to be aligned.
+ */
+#pragma once
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <immintrin.h>
+#define BIER_BYTESWAP_SSE2
+#if defined(__GNUC__) || defined(__clang__)
+#define BIER_BYTESWAP_AVX2
+#define BIER_TARGET_AVX2 __attribute__((target("avx2")))
+#elif defined(__AVX2__)
+#define BIER_BYTESWAP_AVX2
+#define BIER_TARGET_AVX2
+#endif
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#include <arm_neon.h>
+#define BIER_BYTESWAP_NEON
+#endif
+
+namespace byteswap_kernels
+{
+    template <typename U>
+    static inline void scalar(uint8_t *data, size_t count)
+    {
+        U value;
+        for (size_t i = 0; i < count; ++i, data += sizeof(U))
+        {
+            memcpy(&value, data, sizeof(U));
+            value = std::byteswap(value);
+            memcpy(data, &value, sizeof(U));
+        }
+    }
+
+#ifdef BIER_BYTESWAP_AVX2
+    template <size_t size>
+    BIER_TARGET_AVX2 static size_t avx2(uint8_t *data, size_t count)
+    {
+        // reverse the bytes within each element, the mask is applied per 128-bit lane
+        __m256i mask;
+        if constexpr (size == 2)
+            mask = _mm256_setr_epi8(1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14,
+                                    1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14);
+        else if constexpr (size == 4)
+            mask = _mm256_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12,
+                                    3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12);
+        else
+            mask = _mm256_setr_epi8(7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8,
+                                    7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8);
+
+        constexpr size_t per_vector = 32 / size;
+        size_t i = 0;
+        for (; i + per_vector <= count; i += per_vector, data += 32)
+        {
+            __m256i v = _mm256_loadu_si256(reinterpret_cast<__m256i *>(data));
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(data), _mm256_shuffle_epi8(v, mask));
+        }
+        return i;
+    }
+
+    static inline bool has_avx2()
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        static const bool supported = __builtin_cpu_supports("avx2");
+        return supported;
+#else
+        return true;
+#endif
+    }
+#endif
+
+#ifdef BIER_BYTESWAP_SSE2
+    // SSE2 has no byte shuffle, so swap the 16-bit words first and then the bytes within them
+    template <size_t size>
+    static size_t sse2(uint8_t *data, size_t count)
+    {
+        constexpr size_t per_vector = 16 / size;
+        size_t i = 0;
+        for (; i + per_vector <= count; i += per_vector, data += 16)
+        {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<__m128i *>(data));
+            if constexpr (size == 4)
+            {
+                v = _mm_shufflelo_epi16(v, _MM_SHUFFLE(2, 3, 0, 1));
+                v = _mm_shufflehi_epi16(v, _MM_SHUFFLE(2, 3, 0, 1));
+            }
+            else if constexpr (size == 8)
+            {
+                v = _mm_shufflelo_epi16(v, _MM_SHUFFLE(0, 1, 2, 3));
+                v = _mm_shufflehi_epi16(v, _MM_SHUFFLE(0, 1, 2, 3));
+            }
+            v = _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(data), v);
+        }
+        return i;
+    }
+#endif
+
+#ifdef BIER_BYTESWAP_NEON
+    template <size_t size>
+    static size_t neon(uint8_t *data, size_t count)
+    {
+        constexpr size_t per_vector = 16 / size;
+        size_t i = 0;
+        for (; i + per_vector <= count; i += per_vector, data += 16)
+        {
+            uint8x16_t v = vld1q_u8(data);
+            if constexpr (size == 2)
+                v = vrev16q_u8(v);
+            else if constexpr (size == 4)
+                v = vrev32q_u8(v);
+            else
+                v = vrev64q_u8(v);
+            vst1q_u8(data, v);
+        }
+        return i;
+    }
+#endif
+}
+
+/**
+ * @brief Reverses the byte order of count values of the given size in place.
+ *
+ * @tparam size The size of a single value, 1, 2, 4 or 8
+ * @param data Pointer to the first value
+ * @param count Number of values
+ */
+template <size_t size>
+    requires(size == 1 || size == 2 || size == 4 || size == 8)
+static inline void byteswap_inplace(void *data, size_t count)
+{
+    if constexpr (size == 1)
+    {
+        return;
+    }
+    else
+    {
+        using U = std::conditional_t<size == 2, uint16_t, std::conditional_t<size == 4, uint32_t, uint64_t>>;
+        uint8_t *ptr = static_cast<uint8_t *>(data);
+        size_t done = 0;
+#if defined(BIER_BYTESWAP_AVX2)
+        if (byteswap_kernels::has_avx2())
+        {
+            done = byteswap_kernels::avx2<size>(ptr, count);
+        }
+#endif
+#if defined(BIER_BYTESWAP_SSE2)
+        done += byteswap_kernels::sse2<size>(ptr + done * size, count - done);
+#elif defined(BIER_BYTESWAP_NEON)
+        done = byteswap_kernels::neon<size>(ptr, count);
+#endif
+        byteswap_kernels::scalar<U>(ptr + done * size, count - done);
+    }
+}
@@ -3,12 +3,26 @@
 #include <bit>
 #include <type_traits>
 
+#include <fcntl.h>
+#include <sys/stat.h>
+#ifdef _WIN32
+#include <io.h>
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
 #include "Python.h"
 #include "structmember.h"
 
 #include "PyConverter.hpp"
 #include "EndianedIOBase.hpp"
+#include "StructFormat.hpp"
+#include "Schema.hpp"
+#include "ByteSearch.hpp"
 #include <algorithm>
+#include <vector>
 
 // 'truncate'
 // 'writelines'
@@ -18,25 +32,111 @@ PyObject *EndianedBytesIO_OT = nullptr;
 typedef struct
 {
     PyObject_HEAD
-        Py_buffer view; // The view object for the buffer.
-    Py_ssize_t pos;     // The current position in the buffer.
-    char endian;        // The endianness of the data.
-    bool closed;        // Indicates if the stream is closed.
+        Py_buffer view;   // The view object for the buffer.
+    Py_ssize_t pos;       // The current position in the buffer.
+    Py_ssize_t capacity;  // The allocated size of the buffer, >= view.len.
+    Py_ssize_t exports;   // The number of buffer exports of this object.
+    char endian;          // The endianness of the data.
+    CountType count_type; // The encoding of length prefixes.
+    bool closed;          // Indicates if the stream is closed.
+    bool owned;           // view.buf is allocated by this object instead of borrowed.
+    bool mapped;          // view.buf is a memory mapping of a file, which can't be resized.
+    StringInternCache *string_cache; // Interned strings of the reads with intern=True, nullptr until the first one.
 
 } EndianedBytesIO;
 
-static void EndianedBytesIO_dealloc(EndianedBytesIO *self)
+static void _unmap(void *addr, Py_ssize_t size);
+
+static inline void _release_buffer(EndianedBytesIO *self)
 {
-    if (self->view.buf != nullptr)
+    if (self->mapped)
+    {
+        _unmap(self->view.buf, self->view.len);
+        self->mapped = false;
+    }
+    else if (self->owned)
+    {
+        PyMem_Free(self->view.buf);
+        self->owned = false;
+    }
+    else if (self->view.buf != nullptr)
     {
         PyBuffer_Release(&self->view);
     }
-    PyObject_Del((PyObject *)self);
+    self->view = {};
+    self->capacity = 0;
+}
+
+/**
+ * @brief Runs fn on the buffer without the GIL if size reaches NOGIL_THRESHOLD.
+ *
+ * The buffer counts as exported meanwhile, so that other threads can't resize or close it.
+ */
+template <typename F>
+static inline void _nogil(EndianedBytesIO *self, Py_ssize_t size, F &&fn)
+{
+    self->exports++;
+    nogil(size, fn);
+    self->exports--;
+}
+
+/**
+ * @brief Copies size bytes at offset of the buffer into a new bytes object.
+ */
+static inline PyObject *_copy_bytes(EndianedBytesIO *self, Py_ssize_t offset, Py_ssize_t size)
+{
+    PyObject *ret = PyBytes_FromStringAndSize(nullptr, size);
+    if (ret == nullptr)
+    {
+        return nullptr;
+    }
+    char *dst = PyBytes_AsString(ret);
+    const char *src = static_cast<char *>(self->view.buf) + offset;
+    _nogil(self, size, [&]
+           { memcpy(dst, src, size); });
+    return ret;
+}
+
+/**
+ * @brief Copies size bytes at pos into a new bytes object and advances pos.
+ *
+ * pos is moved before the copy, as other threads may use the object while it runs without the GIL.
+ */
+static inline PyObject *_read_bytes(EndianedBytesIO *self, Py_ssize_t size, Py_ssize_t &pos)
+{
+    Py_ssize_t offset = pos;
+    pos += size;
+    PyObject *ret = _copy_bytes(self, offset, size);
+    if (ret == nullptr)
+    {
+        // only fails before the copy
+        pos = offset;
+    }
+    return ret;
+}
+
+static inline PyObject *_read_bytes(EndianedBytesIO *self, Py_ssize_t size)
+{
+    return _read_bytes(self, size, self->pos);
+}
+
+static void EndianedBytesIO_dealloc(EndianedBytesIO *self)
+{
+    _release_buffer(self);
+    delete self->string_cache;
+    EndianedIOBase_free(reinterpret_cast<PyObject *>(self));
 }
 
 static int EndianedBytesIO_init(EndianedBytesIO *self, PyObject *args, PyObject *kwds)
 {
-    self->view = {};
+    if (self->exports > 0)
+    {
+        PyErr_SetString(PyExc_BufferError, "Existing exports of data: object cannot be re-initialized.");
+        return -1;
+    }
+
+    // Clear existing buffer if reinitialized
+    _release_buffer(self);
     self->pos = 0;
     self->endian = '<';
     self->closed = false;
@@ -46,22 +146,27 @@ static int EndianedBytesIO_init(EndianedBytesIO *self, PyObject *args, PyObject
     static const char *kwlist[] = {
         "initial_bytes",
         "endian",
+        "count_type",
         nullptr};
 
-    // Clear existing buffer if reinitialized
-    if (self->view.buf)
-        PyBuffer_Release(&self->view);
-
     // Parse arguments
-    PyObject *buf{};
-    if (!PyArg_ParseTupleAndKeywords(args, kwds, "O|s*",
+    PyObject *buf = Py_None;
+    PyObject *count_type = Py_None;
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "|Os*O",
                                      const_cast<char **>(kwlist),
                                      &buf,
-                                     &endian_view))
+                                     &endian_view,
+                                     &count_type))
     {
         return -1;
     }
 
+    if (CountType_FromObject(count_type, self->count_type) < 0)
+    {
+        PyBuffer_Release(&endian_view);
+        return -1;
+    }
+
     // parse endian argument
     if (endian_view.buf != nullptr)
     {
@@ -70,18 +175,27 @@ static int EndianedBytesIO_init(EndianedBytesIO *self, PyObject *args, PyObject
         if (endian_view.len != 1 || (buf_ptr[0] != '<' && buf_ptr[0] != '>'))
         {
             PyErr_SetString(PyExc_ValueError, "Endian must be '<' or '>'.");
+            PyBuffer_Release(&endian_view);
             return -1;
         }
         self->endian = buf_ptr[0];
         PyBuffer_Release(&endian_view);
     }
 
+    // no initial bytes -> start with an empty buffer owned by this object
+    if (buf == Py_None)
+    {
+        self->owned = true;
+        return PyBuffer_FillInfo(&self->view, nullptr, nullptr, 0, 0, PyBUF_ND);
+    }
+
     // check if the buffer is contiguous
     if (PyObject_GetBuffer(buf, &self->view, PyBUF_ND))
     {
         PyErr_SetString(PyExc_ValueError, "Incontigous buffer object.");
         return -1;
     }
+    self->capacity = self->view.len;
 
     return 0;
 };
@@ -94,6 +208,21 @@ PyMemberDef EndianedBytesIO_members[] = {
     {NULL} /* Sentinel */
 };
 
+static PyObject *EndianedBytesIO_get_count_type(EndianedBytesIO *self, void *closure)
+{
+    return CountType_AsObject(self->count_type);
+}
+
+static int EndianedBytesIO_set_count_type(EndianedBytesIO *self, PyObject *value, void *closure)
+{
+    return CountType_FromObject(value, self->count_type);
+}
+
+PyGetSetDef EndianedBytesIO_getseters[] = {
+    {"count_type", (getter)LOCKED(EndianedBytesIO_get_count_type), (setter)LOCKED(EndianedBytesIO_set_count_type), "The encoding of length prefixes, None uses read_count/write_count.", nullptr},
+    {nullptr} /* Sentinel */
+};
+
 static PyObject *EndianedBytesIO_read(EndianedBytesIO *self, PyObject *arg)
 {
     CHECK_CLOSED
@@ -121,10 +250,9 @@ static PyObject *EndianedBytesIO_read(EndianedBytesIO *self, PyObject *arg)
         return nullptr;
     }
 
-    auto read_size = std::min(size, self->view.len - self->pos);
-    char *buffer = static_cast<char *>(self->view.buf) + self->pos;
-    self->pos += read_size;
-    return PyBytes_FromStringAndSize(buffer, read_size);
+    // the position may be behind the end of the buffer after a seek
+    auto read_size = std::min(size, std::max<Py_ssize_t>(0, self->view.len - self->pos));
+    return _read_bytes(self, read_size);
 }
 
 static PyObject *EndianedBytesIO_readinto(EndianedBytesIO *self, PyObject *arg)
@@ -136,47 +264,137 @@ static PyObject *EndianedBytesIO_readinto(EndianedBytesIO *self, PyObject *arg)
         return nullptr;
     }
     Py_buffer view;
-    if (PyObject_GetBuffer(arg, &view, PyBUF_WRITE) == -1)
+    if (PyObject_GetBuffer(arg, &view, PyBUF_WRITABLE) == -1)
     {
         return nullptr;
     }
-    Py_ssize_t read_size = std::min(view.len, self->view.len - self->pos);
-    Py_MEMCPY(view.buf, static_cast<char *>(self->view.buf) + self->pos, read_size);
-    PyBuffer_Release(&view);
+    // the position may be behind the end of the buffer after a seek
+    Py_ssize_t read_size = std::min(view.len, std::max<Py_ssize_t>(0, self->view.len - self->pos));
+    const char *src = static_cast<char *>(self->view.buf) + self->pos;
     self->pos += read_size;
+    _nogil(self, read_size, [&]
+           { memcpy(view.buf, src, read_size); });
+    PyBuffer_Release(&view);
     return PyLong_FromSsize_t(read_size);
 }
 
+/*
+ * The reads that have a read_*_at take the position they start at and advance,
+ * which is the position of the object for the plain reads and a local offset for read_*_at,
+ * so that read_*_at never move the position of the object other threads see.
+ */
+
 template <typename T, char endian>
     requires EndianedOperation<T, endian>
-static PyObject *EndianedBytesIO_read_t(EndianedBytesIO *self, PyObject *unused)
+static PyObject *_EndianedBytesIO_read_t(EndianedBytesIO *self, Py_ssize_t &pos)
 {
     CHECK_CLOSED
     T value{};
-    if (self->pos + sizeof(T) > self->view.len)
+    if (static_cast<Py_ssize_t>(sizeof(T)) > self->view.len - pos)
     {
         PyErr_SetString(PyExc_ValueError, "Read exceeds buffer length.");
         return nullptr;
     }
 
     // Read the data from the buffer
-    memcpy(&value, static_cast<char *>(self->view.buf) + self->pos, sizeof(T));
-    self->pos += sizeof(T);
+    memcpy(&value, static_cast<char *>(self->view.buf) + pos, sizeof(T));
+    pos += sizeof(T);
 
     handle_swap<EndianedBytesIO, T, endian>(self, value);
 
     return PyObject_FromAny(value);
 }
 
-static inline bool _read_count(EndianedBytesIO *self, PyObject *py_count, Py_ssize_t &count)
+template <typename T, char endian>
+    requires EndianedOperation<T, endian>
+static PyObject *EndianedBytesIO_read_t(EndianedBytesIO *self, PyObject *unused)
+{
+    return _EndianedBytesIO_read_t<T, endian>(self, self->pos);
+}
+
+static inline bool _read_raw(EndianedBytesIO *self, void *dst, Py_ssize_t size)
+{
+    if (size > self->view.len - self->pos)
+    {
+        PyErr_SetString(PyExc_ValueError, "Read exceeds buffer length.");
+        return true;
+    }
+    const char *src = static_cast<char *>(self->view.buf) + self->pos;
+    self->pos += size;
+    _nogil(self, size, [&]
+           { memcpy(dst, src, size); });
+    return false;
+}
+
+/**
+ * @brief A read of a length prefix at pos, which leaves the position of the object alone.
+ */
+struct EndianedBytesIOAt
+{
+    char endian;
+    EndianedBytesIO *io;
+    Py_ssize_t &pos;
+};
+
+static inline bool _read_raw_at(EndianedBytesIOAt *at, void *dst, Py_ssize_t size)
+{
+    if (size > at->io->view.len - at->pos)
+    {
+        PyErr_SetString(PyExc_ValueError, "Read exceeds buffer length.");
+        return true;
+    }
+    memcpy(dst, static_cast<char *>(at->io->view.buf) + at->pos, size);
+    at->pos += size;
+    return false;
+}
+
+/**
+ * @brief Checks if the class of self replaces read_count, which then reads the CountType::Python prefixes.
+ */
+static inline bool _overrides_read_count(EndianedBytesIO *self)
+{
+    PyObject *type = reinterpret_cast<PyObject *>(Py_TYPE(self));
+    if (type == EndianedBytesIO_OT)
+    {
+        return false;
+    }
+    PyObject *own = PyObject_GetAttrString(type, "read_count");
+    PyObject *base = PyObject_GetAttrString(EndianedBytesIO_OT, "read_count");
+    // a failed lookup counts as override, so that calling read_count reports it
+    bool overrides = own == nullptr || own != base;
+    Py_XDECREF(own);
+    Py_XDECREF(base);
+    PyErr_Clear();
+    return overrides;
+}
+
+/**
+ * @brief Gets the count argument of a read, or reads the length prefix at pos if it is None.
+ *
+ * @return true on success, false on failure
+ */
+static inline bool _read_count(EndianedBytesIO *self, PyObject *py_count, Py_ssize_t &count, Py_ssize_t &pos)
 {
-    if ((py_count == nullptr) || (py_count == Py_None))
+    if (((py_count == nullptr) || (py_count == Py_None)) && ((self->count_type != CountType::Python) || !_overrides_read_count(self)))
     {
+        EndianedBytesIOAt at{self->endian, self, pos};
+        return !EndianedIOBase_read_native_count<EndianedBytesIOAt, _read_raw_at>(&at, self->count_type, count);
+    }
+    else if ((py_count == nullptr) || (py_count == Py_None))
+    {
+        // an overridden read_count can only read at the position of the object
+        Py_ssize_t saved = self->pos;
+        self->pos = pos;
         PyObject *py_count = PyObject_CallMethod(
             reinterpret_cast<PyObject *>(self),
             "read_count",
             "",
             nullptr);
+        pos = self->pos;
+        if (&pos != &self->pos)
+        {
+            self->pos = saved;
+        }
         if (py_count == nullptr)
         {
             return false;
@@ -213,29 +431,61 @@ static inline bool _read_count(EndianedBytesIO *self, PyObject *py_count, Py_ssi
 
 template <typename T, char endian>
     requires EndianedOperation<T, endian>
-static PyObject *EndianedBytesIO_read_array_t(EndianedBytesIO *self, PyObject *arg)
+static PyObject *_EndianedBytesIO_read_array_t(EndianedBytesIO *self, PyObject *args, PyObject *kwds, Py_ssize_t &pos)
 {
     CHECK_CLOSED
+
+    static const char *kwlist[] = {
+        "count",
+        "as_array",
+        nullptr};
+
+    PyObject *py_count = nullptr;
+    int as_array = 0;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "|Op",
+                                     const_cast<char **>(kwlist),
+                                     &py_count,
+                                     &as_array))
+    {
+        return nullptr;
+    }
+
     Py_ssize_t size = 0;
-    if (!_read_count(self, arg, size))
+    if (!_read_count(self, py_count, size, pos))
     {
         return nullptr;
     }
 
-    if (size * sizeof(T) > self->view.len - self->pos)
+    // divide instead of multiplying, so that huge counts can't overflow
+    if (pos > self->view.len || size > (self->view.len - pos) / static_cast<Py_ssize_t>(sizeof(T)))
     {
         PyErr_SetString(PyExc_ValueError, "Read exceeds buffer length.");
         return nullptr;
     }
 
+    if (as_array)
+    {
+        // the copy might release the GIL
+        self->exports++;
+        PyObject *ret = PyMemoryView_FromAnyArray<EndianedBytesIO, T, endian>(
+            self, static_cast<char *>(self->view.buf) + pos, size);
+        self->exports--;
+        if (ret != nullptr)
+        {
+            pos += size * sizeof(T);
+        }
+        return ret;
+    }
+
     PyObject *ret = PyTuple_New(size);
 
     T value{};
     for (Py_ssize_t i = 0; i < size; ++i)
     {
 
-        memcpy(&value, static_cast<char *>(self->view.buf) + self->pos, sizeof(T));
-        self->pos += sizeof(T);
+        memcpy(&value, static_cast<char *>(self->view.buf) + pos, sizeof(T));
+        pos += sizeof(T);
 
         handle_swap<EndianedBytesIO, T, endian>(self, value);
 
@@ -250,18 +500,185 @@ static PyObject *EndianedBytesIO_read_array_t(EndianedBytesIO *self, PyObject *a
     return ret;
 }
 
+template <typename T, char endian>
+    requires EndianedOperation<T, endian>
+static PyObject *EndianedBytesIO_read_array_t(EndianedBytesIO *self, PyObject *args, PyObject *kwds)
+{
+    return _EndianedBytesIO_read_array_t<T, endian>(self, args, kwds, self->pos);
+}
+
+template <typename T, char endian>
+    requires EndianedOperation<T, endian>
+static PyObject *EndianedBytesIO_read_array_into_t(EndianedBytesIO *self, PyObject *args, PyObject *kwds)
+{
+    CHECK_CLOSED
+
+    static const char *kwlist[] = {
+        "dest",
+        "count",
+        nullptr};
+
+    PyObject *dest = nullptr;
+    PyObject *py_count = nullptr;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "O|O",
+                                     const_cast<char **>(kwlist),
+                                     &dest,
+                                     &py_count))
+    {
+        return nullptr;
+    }
+
+    Py_buffer dst{};
+    if (PyObject_GetBuffer(dest, &dst, PyBUF_WRITABLE | PyBUF_C_CONTIGUOUS) != 0)
+    {
+        return nullptr;
+    }
+
+    Py_ssize_t size = 0;
+    if (!_read_count(self, py_count, size, self->pos))
+    {
+        PyBuffer_Release(&dst);
+        return nullptr;
+    }
+    // divide instead of multiplying, so that huge counts can't overflow
+    if (size > dst.len / static_cast<Py_ssize_t>(sizeof(T)))
+    {
+        PyBuffer_Release(&dst);
+        PyErr_SetString(PyExc_ValueError, "Destination buffer is too small.");
+        return nullptr;
+    }
+    if (self->pos > self->view.len || size > (self->view.len - self->pos) / static_cast<Py_ssize_t>(sizeof(T)))
+    {
+        PyBuffer_Release(&dst);
+        PyErr_SetString(PyExc_ValueError, "Read exceeds buffer length.");
+        return nullptr;
+    }
+
+    const bool swap = needs_swap<EndianedBytesIO, T, endian>(self);
+    const char *src = static_cast<char *>(self->view.buf) + self->pos;
+    self->pos += size * sizeof(T);
+    _nogil(self, size * sizeof(T), [&]
+           {
+        memcpy(dst.buf, src, size * sizeof(T));
+        if (swap)
+        {
+            byteswap_array<T>(dst.buf, size);
+        } });
+    PyBuffer_Release(&dst);
+    return PyLong_FromSsize_t(size);
+}
+
+static inline bool _reserve(EndianedBytesIO *self, Py_ssize_t capacity)
+{
+    if (capacity <= self->capacity)
+    {
+        return false;
+    }
+    if (self->exports > 0)
+    {
+        PyErr_SetString(PyExc_BufferError, "Existing exports of data: object cannot be re-sized.");
+        return true;
+    }
+    if (self->mapped)
+    {
+        PyErr_SetString(PyExc_ValueError, "Write exceeds the mapped length.");
+        return true;
+    }
+    if (!self->owned)
+    {
+        // writes into a caller's buffer have to keep reaching it, so it isn't swapped for a copy
+        PyErr_SetString(PyExc_ValueError, "Write exceeds buffer length.");
+        return true;
+    }
+
+    char *buf = static_cast<char *>(PyMem_Realloc(self->view.buf, capacity));
+    if (buf == nullptr)
+    {
+        PyErr_NoMemory();
+        return true;
+    }
+    Py_ssize_t len = self->view.len;
+    // everything past view.len is kept zeroed, so seeking past the end and writing leaves no garbage
+    memset(buf + std::max(len, self->capacity), 0, capacity - std::max(len, self->capacity));
+    self->view.buf = buf;
+    self->capacity = capacity;
+    return false;
+}
+
 static inline bool _check_size(EndianedBytesIO *self, Py_ssize_t write_size)
 {
-    if (self->pos + write_size > self->view.len)
+    Py_ssize_t end = self->pos + write_size;
+    if (end <= self->view.len)
+    {
+        return false;
+    }
+    if (end > self->capacity)
+    {
+        // geometric growth to keep appends amortized O(1)
+        if (_reserve(self, std::max(end, std::max(self->capacity * 2, static_cast<Py_ssize_t>(64)))))
+        {
+            return true;
+        }
+    }
+    self->view.len = end;
+    return false;
+}
+
+static inline bool _write_raw(EndianedBytesIO *self, const void *src, Py_ssize_t size)
+{
+    if (self->view.readonly)
+    {
+        PyErr_SetString(PyExc_ValueError, "Buffer is not writable.");
+        return true;
+    }
+    if (_check_size(self, size))
     {
-        PyErr_SetString(PyExc_ValueError, "Write exceeds buffer length. (Resize not implemented)");
         return true;
-        // self->view.obj can't be resized, as it's being used by the view
-        // -> needs a rewrite of the input handling logic
     }
+    char *dst = static_cast<char *>(self->view.buf) + self->pos;
+    self->pos += size;
+    _nogil(self, size, [&]
+           { memcpy(dst, src, size); });
     return false;
 }
 
+static inline bool _write_count(EndianedBytesIO *self, Py_ssize_t count)
+{
+    if (self->count_type != CountType::Python)
+    {
+        return EndianedIOBase_write_native_count<EndianedBytesIO, _write_raw>(self, self->count_type, count);
+    }
+    return EndianedIOBase_call_write_count(self, count);
+}
+
+static PyObject *EndianedBytesIO_read_count(EndianedBytesIO *self, PyObject *unused)
+{
+    CHECK_CLOSED
+    Py_ssize_t count = 0;
+    if (EndianedIOBase_read_native_count<EndianedBytesIO, _read_raw>(self, self->count_type, count))
+    {
+        return nullptr;
+    }
+    return PyLong_FromSsize_t(count);
+}
+
+static PyObject *EndianedBytesIO_write_count(EndianedBytesIO *self, PyObject *arg)
+{
+    CHECK_CLOSED
+    Py_ssize_t count = PyLong_AsSsize_t(arg);
+    if (count == -1 && PyErr_Occurred())
+    {
+        return nullptr;
+    }
+    Py_ssize_t start_pos = self->pos;
+    if (EndianedIOBase_write_native_count<EndianedBytesIO, _write_raw>(self, self->count_type, count))
+    {
+        return nullptr;
+    }
+    return PyLong_FromSsize_t(self->pos - start_pos);
+}
+
 template <typename T, char endian>
     requires EndianedOperation<T, endian>
 static PyObject *EndianedBytesIO_write_t(EndianedBytesIO *self, PyObject *arg)
@@ -273,17 +690,17 @@ static PyObject *EndianedBytesIO_write_t(EndianedBytesIO *self, PyObject *arg)
         return nullptr;
     }
 
-    if (_check_size(self, sizeof(T)))
-    {
-        return nullptr; // Resize failed
-    }
-
     T value{};
     if (!PyObject_ToAny(arg, value))
     {
         return nullptr; // Conversion failed
     }
 
+    if (_check_size(self, sizeof(T)))
+    {
+        return nullptr; // Resize failed
+    }
+
     handle_swap<EndianedBytesIO, T, endian>(self, value);
 
     memcpy(static_cast<char *>(self->view.buf) + self->pos, &value, sizeof(T));
@@ -319,8 +736,34 @@ static PyObject *EndianedBytesIO_write_array_t(EndianedBytesIO *self, PyObject *
         return nullptr;
     }
 
+    // fast path for array.array, memoryview, numpy, ... holding values of T
+    Py_buffer src{};
+    char src_endian = PyObject_GetAnyArrayBuffer<T>(v, &src);
+    if (src_endian)
+    {
+        Py_ssize_t count = src.len / sizeof(T);
+        if (((write_count_obj == Py_True) && _write_count(self, count)) ||
+            _check_size(self, src.len))
+        {
+            PyBuffer_Release(&src);
+            return nullptr;
+        }
+        char *dst = static_cast<char *>(self->view.buf) + self->pos;
+        self->pos += count * sizeof(T);
+        const bool swap = needs_swap<EndianedBytesIO, T, endian>(self) != (src_endian != NATIVE_ENDIAN);
+        _nogil(self, src.len, [&]
+               {
+            memcpy(dst, src.buf, src.len);
+            if (swap)
+            {
+                byteswap_array<T>(dst, count);
+            } });
+        PyBuffer_Release(&src);
+        return PyLong_FromSsize_t(count * sizeof(T));
+    }
+
     Py_ssize_t count = PyObject_Size(v);
-    if ((write_count_obj == Py_True) && EndianedIOBase_write_count(self, count))
+    if ((write_count_obj == Py_True) && _write_count(self, count))
     {
         return nullptr; // Resize failed
     }
@@ -331,17 +774,17 @@ static PyObject *EndianedBytesIO_write_array_t(EndianedBytesIO *self, PyObject *
 
     PyObject *iter = PyObject_GetIter(v);
     PyObject *item = PyIter_Next(iter);
+    Py_ssize_t start_pos = self->pos;
     T value{};
     while (item)
     {
         if (!PyObject_ToAny(item, value))
         {
+            Py_DecRef(item);
             Py_DecRef(iter);
             return nullptr; // Conversion failed
         }
 
-        handle_swap<EndianedBytesIO, T, endian>(self, value);
-
         memcpy(static_cast<char *>(self->view.buf) + self->pos, &value, sizeof(T));
         self->pos += sizeof(T);
         Py_DecRef(item);
@@ -352,6 +795,13 @@ static PyObject *EndianedBytesIO_write_array_t(EndianedBytesIO *self, PyObject *
     {
         return nullptr; // Error occurred during iteration
     }
+    // swap all values at once instead of one by one
+    if (needs_swap<EndianedBytesIO, T, endian>(self))
+    {
+        char *dst = static_cast<char *>(self->view.buf) + start_pos;
+        _nogil(self, count * sizeof(T), [&]
+               { byteswap_array<T>(dst, count); });
+    }
     return PyLong_FromSsize_t(count * sizeof(T));
 }
 
@@ -382,26 +832,23 @@ static PyObject *EndianedBytesIO_write_cstring(EndianedBytesIO *self, PyObject *
         return nullptr;
     }
 
-    PyObject *bytes = PyUnicode_AsEncodedString(v, encoding, errors);
-    if (bytes == nullptr)
+    StringEncoder encoded;
+    if (encoded.encode(v, encoding, errors))
     {
         return nullptr; // Encoding failed
     }
-    Py_ssize_t write_size = PyBytes_GET_SIZE(bytes);
-    if (_check_size(self, write_size + 1)) // +1 for null terminator
+    // the encoded data is followed by a null terminator
+    Py_ssize_t write_size = encoded.size() + 1;
+    if (_check_size(self, write_size))
     {
-        Py_DecRef(bytes);
         return nullptr; // Resize failed
     }
-    memcpy(
-        static_cast<char *>(self->view.buf) + self->pos,
-        PyBytes_AS_STRING(bytes),
-        write_size);
-    Py_DecRef(bytes);
-
+    char *dst = static_cast<char *>(self->view.buf) + self->pos;
     self->pos += write_size;
-    reinterpret_cast<char *>(self->view.buf)[self->pos++] = 0; // Null terminator
-    return PyLong_FromSsize_t(write_size + 1);
+    _nogil(self, write_size, [&]
+           { memcpy(dst, encoded.data(), write_size); });
+
+    return PyLong_FromSsize_t(write_size);
 }
 
 static PyObject *EndianedBytesIO_write_string(EndianedBytesIO *self, PyObject *args, PyObject *kwds)
@@ -435,32 +882,28 @@ static PyObject *EndianedBytesIO_write_string(EndianedBytesIO *self, PyObject *a
         return nullptr;
     }
 
-    Py_ssize_t start_pos = self->pos;
-    Py_ssize_t string_size = PyUnicode_GET_LENGTH(v);
-    if ((write_count_obj == Py_True) && EndianedIOBase_write_count(self, string_size))
+    StringEncoder encoded;
+    if (encoded.encode(v, encoding, errors))
     {
-        return nullptr; // Resize failed
+        return nullptr; // Encoding failed
     }
-
-    PyObject *bytes = PyUnicode_AsEncodedString(v, encoding, errors);
-    if (bytes == nullptr)
+    Py_ssize_t start_pos = self->pos;
+    Py_ssize_t bytes_size = encoded.size();
+    // the length prefix counts the encoded bytes
+    if ((write_count_obj == Py_True) && _write_count(self, bytes_size))
     {
-        return nullptr; // Encoding failed
+        return nullptr; // Resize failed
     }
-    Py_ssize_t bytes_size = PyBytes_GET_SIZE(bytes);
     if (_check_size(self, bytes_size))
     {
         self->pos = start_pos;
-        Py_DecRef(bytes);
         return nullptr; // Resize failed
     }
-    memcpy(
-        static_cast<char *>(self->view.buf) + self->pos,
-        PyBytes_AS_STRING(bytes),
-        bytes_size);
-    Py_DecRef(bytes);
-
+    char *dst = static_cast<char *>(self->view.buf) + self->pos;
     self->pos += bytes_size;
+    _nogil(self, bytes_size, [&]
+           { memcpy(dst, encoded.data(), bytes_size); });
+
     return PyLong_FromSsize_t(self->pos - start_pos);
 }
 
@@ -490,7 +933,7 @@ static PyObject *EndianedBytesIO_write_bytes(EndianedBytesIO *self, PyObject *ar
     }
 
     Py_ssize_t start_pos = self->pos;
-    if ((write_count_obj == Py_True) && EndianedIOBase_write_count(self, v.len))
+    if ((write_count_obj == Py_True) && _write_count(self, v.len))
     {
         PyBuffer_Release(&v);
         return nullptr; // Resize failed
@@ -501,12 +944,15 @@ static PyObject *EndianedBytesIO_write_bytes(EndianedBytesIO *self, PyObject *ar
         PyBuffer_Release(&v);
         return nullptr; // Resize failed
     }
-    memcpy(static_cast<char *>(self->view.buf) + self->pos, v.buf, v.len);
+    char *dst = static_cast<char *>(self->view.buf) + self->pos;
     self->pos += v.len;
+    _nogil(self, v.len, [&]
+           { memcpy(dst, v.buf, v.len); });
     PyBuffer_Release(&v);
     return PyLong_FromSsize_t(self->pos - start_pos);
 }
 
+template <bool zigzag>
 static PyObject *EndianedBytesIO_write_varint(EndianedBytesIO *self, PyObject *arg)
 {
     CHECK_CLOSED
@@ -516,41 +962,23 @@ static PyObject *EndianedBytesIO_write_varint(EndianedBytesIO *self, PyObject *a
         return nullptr;
     }
 
-    Py_ssize_t value = 0;
-    if (!PyArg_ParseTuple(arg, "n", &value))
-    {
-        return nullptr;
-    }
-    if (value < 0)
+    uint64_t value = 0;
+    if (PyLong_AsVarint<zigzag>(arg, value))
     {
-        PyErr_SetString(PyExc_ValueError, "Varint must be non-negative.");
         return nullptr;
     }
 
-    // Calculate the number of bytes needed for the varint
-    Py_ssize_t write_size = 0;
-    uint64_t temp = value;
-    do
-    {
-        write_size++;
-        temp >>= 7;
-    } while (temp != 0);
-
+    const Py_ssize_t write_size = varint_size(value);
     if (_check_size(self, write_size))
     {
         return nullptr; // Resize failed
     }
-
-    while (value > 0x7F)
-    {
-        uint8_t byte = static_cast<uint8_t>((value & 0x7F) | 0x80);
-        reinterpret_cast<uint8_t *>(self->view.buf)[self->pos++] = byte;
-        value >>= 7;
-    }
-
+    varint_encode(value, static_cast<uint8_t *>(self->view.buf) + self->pos);
+    self->pos += write_size;
     return PyLong_FromSsize_t(write_size);
 }
 
+template <bool zigzag>
 static PyObject *EndianedBytesIO_write_varint_array(EndianedBytesIO *self, PyObject *args, PyObject *kwds)
 {
     CHECK_CLOSED
@@ -577,325 +1005,1816 @@ static PyObject *EndianedBytesIO_write_varint_array(EndianedBytesIO *self, PyObj
         return nullptr;
     }
 
+    std::vector<uint64_t> values;
+    if (varints_FromObject<zigzag>(v, values))
+    {
+        return nullptr;
+    }
+
     Py_ssize_t start_pos = self->pos;
-    Py_ssize_t count = PyObject_Size(v);
-    if ((write_count_obj == Py_True) && EndianedIOBase_write_count(self, count))
+    const Py_ssize_t count = static_cast<Py_ssize_t>(values.size());
+    if ((write_count_obj == Py_True) && _write_count(self, count))
     {
         return nullptr; // Resize failed
     }
 
-    PyObject *iter = PyObject_GetIter(v);
-    PyObject *item = PyIter_Next(iter);
-    while (item)
+    // size the buffer once, then encode in place
+    const Py_ssize_t write_size = varint_size_array(values.data(), count);
+    if (_check_size(self, write_size))
     {
-        EndianedBytesIO_write_varint(self, item);
-        if (PyErr_Occurred())
-        {
-            self->pos = start_pos;
-            Py_DecRef(iter);
-            return nullptr; // Error occurred during write
-        }
+        self->pos = start_pos;
+        return nullptr; // Resize failed
     }
-    Py_DecRef(iter);
+    uint8_t *dst = static_cast<uint8_t *>(self->view.buf) + self->pos;
+    self->pos += write_size;
+    _nogil(self, write_size, [&]
+           { varint_encode_array(values.data(), count, dst); });
     return PyLong_FromSsize_t(self->pos - start_pos);
 }
 
-static PyObject *EndianedBytesIO_seek(EndianedBytesIO *self, PyObject *args)
+static PyObject *EndianedBytesIO_read_struct(EndianedBytesIO *self, PyObject *arg)
 {
     CHECK_CLOSED
-    Py_ssize_t offset = 0;
-    int whence = SEEK_SET;
-    if (!PyArg_ParseTuple(args, "n|i", &offset, &whence))
+    StructFormatObject *format = StructFormat_FromObject(arg);
+    if (format == nullptr)
     {
         return nullptr;
     }
-    Py_ssize_t new_pos = 0;
-    switch (whence)
+    if (format->size > self->view.len - self->pos)
     {
-    case SEEK_SET:
-        new_pos = offset;
-        break;
-    case SEEK_CUR:
-        new_pos = self->pos + offset;
-        break;
-    case SEEK_END:
-        new_pos = self->view.len + offset;
-        break;
-    default:
-        PyErr_SetString(PyExc_ValueError, "Invalid value for whence.");
+        Py_DECREF(format);
+        PyErr_SetString(PyExc_ValueError, "Read exceeds buffer length.");
         return nullptr;
     }
-    if (new_pos < 0)
+    PyObject *ret = StructFormat_unpack(
+        format,
+        static_cast<char *>(self->view.buf) + self->pos,
+        StructFormat_endian(format, self->endian));
+    if (ret != nullptr)
     {
-        PyErr_SetString(PyExc_ValueError, "Negative seek position.");
-        return nullptr;
+        self->pos += format->size;
     }
-    self->pos = new_pos;
-    return PyLong_FromSsize_t(self->pos);
-}
-
-static PyObject *EndianedBytesIO_tell(EndianedBytesIO *self, PyObject *args)
-{
-    CHECK_CLOSED
-    return PyLong_FromSsize_t(self->pos);
+    Py_DECREF(format);
+    return ret;
 }
 
-static PyObject *EndianedBytesIO_seekable(EndianedBytesIO *self, PyObject *args)
+static PyObject *EndianedBytesIO_read_struct_array(EndianedBytesIO *self, PyObject *args, PyObject *kwds)
 {
     CHECK_CLOSED
-    Py_RETURN_TRUE;
-}
 
-static PyObject *EndianedBytesIO_readable(EndianedBytesIO *self, PyObject *args)
-{
-    CHECK_CLOSED
-    Py_RETURN_TRUE;
-}
+    static const char *kwlist[] = {
+        "format",
+        "count",
+        nullptr};
 
-static PyObject *EndianedBytesIO_writable(EndianedBytesIO *self, PyObject *args)
-{
-    CHECK_CLOSED
-    PyObject *ret = self->view.readonly ? Py_False : Py_True;
-    Py_IncRef(ret);
-    return ret;
-}
+    PyObject *py_format = nullptr;
+    PyObject *py_count = nullptr;
 
-static PyObject *EndianedBytesIO_close(EndianedBytesIO *self, PyObject *args)
-{
-    if (self->view.buf != nullptr)
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "O|O",
+                                     const_cast<char **>(kwlist),
+                                     &py_format,
+                                     &py_count))
     {
-        PyBuffer_Release(&self->view);
-        self->view.buf = nullptr;
+        return nullptr;
     }
-    self->closed = true;
-    Py_RETURN_NONE;
-}
 
-static PyObject *EndianedBytesIO_isatty(EndianedBytesIO *self, PyObject *args)
-{
-    CHECK_CLOSED
-    Py_RETURN_FALSE;
-}
+    StructFormatObject *format = StructFormat_FromObject(py_format);
+    if (format == nullptr)
+    {
+        return nullptr;
+    }
+    Py_ssize_t size = 0;
+    if (!_read_count(self, py_count, size, self->pos))
+    {
+        Py_DECREF(format);
+        return nullptr;
+    }
+    if (format->size != 0 && size > (self->view.len - self->pos) / format->size)
+    {
+        Py_DECREF(format);
+        PyErr_SetString(PyExc_ValueError, "Read exceeds buffer length.");
+        return nullptr;
+    }
 
-static PyObject *EndianedBytesIO_detach(EndianedBytesIO *self, PyObject *no_args)
-{
-    CHECK_CLOSED
-    PyErr_SetString(PyExc_IOError, "detach() not supported on this type of stream.");
-    return nullptr;
+    const char endian = StructFormat_endian(format, self->endian);
+    const char *data = static_cast<char *>(self->view.buf) + self->pos;
+    PyObject *ret = PyList_New(size);
+    for (Py_ssize_t i = 0; ret != nullptr && i < size; ++i, data += format->size)
+    {
+        PyObject *item = StructFormat_unpack(format, data, endian);
+        if (item == nullptr)
+        {
+            Py_DecRef(ret);
+            ret = nullptr;
+            break;
+        }
+        PyList_SetItem(ret, i, item); // Steal reference, no need to DECREF
+    }
+    if (ret != nullptr)
+    {
+        self->pos += size * format->size;
+    }
+    Py_DECREF(format);
+    return ret;
 }
 
-static PyObject *EndianedBytesIO_fileno(EndianedBytesIO *self, PyObject *no_args)
+static inline bool _write_struct(EndianedBytesIO *self, StructFormatObject *format, PyObject *values, char endian)
 {
-    CHECK_CLOSED
-    PyErr_SetString(PyExc_OSError, "fileno() not supported on this type of stream.");
-    return nullptr;
+    Py_ssize_t old_len = self->view.len;
+    if (_check_size(self, format->size))
+    {
+        return true;
+    }
+    char *out = static_cast<char *>(self->view.buf) + self->pos;
+    if (StructFormat_pack(format, values, out, endian) < 0)
+    {
+        // drop the partially packed record, the buffer is zero-filled past its length
+        if (self->view.len > old_len)
+        {
+            memset(static_cast<char *>(self->view.buf) + old_len, 0, self->view.len - old_len);
+            self->view.len = old_len;
+        }
+        return true;
+    }
+    self->pos += format->size;
+    return false;
 }
 
-static PyObject *EndianedBytesIO_flush(EndianedBytesIO *self, PyObject *no_args)
+/**
+ * @brief Converts a sequence of ints or a buffer of native integers, e.g. an array.array, into offsets.
+ *
+ * @return true on failure, false on success
+ */
+static bool _offsets_FromObject(PyObject *obj, std::vector<Py_ssize_t> &offsets)
 {
-    CHECK_CLOSED
-    Py_RETURN_NONE;
-}
+    Py_buffer view{};
+    if (PyObject_CheckBuffer(obj) && PyObject_GetBuffer(obj, &view, PyBUF_FORMAT | PyBUF_C_CONTIGUOUS) == 0)
+    {
+        const char *format = view.format != nullptr ? view.format : "B";
+        if (format[0] == '@' || format[0] == '=' || format[0] == NATIVE_ENDIAN)
+        {
+            ++format;
+        }
+        const char code = format[1] == '\0' ? format[0] : '\0';
+        const bool is_signed = code == 'b' || code == 'h' || code == 'i' || code == 'l' || code == 'q' || code == 'n';
+        const bool is_unsigned = code == 'B' || code == 'H' || code == 'I' || code == 'L' || code == 'Q' || code == 'N';
+        auto convert = [&]<typename T>()
+        {
+            const Py_ssize_t count = view.len / static_cast<Py_ssize_t>(sizeof(T));
+            offsets.resize(count);
+            for (Py_ssize_t i = 0; i < count; ++i)
+            {
+                T value;
+                memcpy(&value, static_cast<char *>(view.buf) + i * sizeof(T), sizeof(T));
+                // offsets that don't fit into Py_ssize_t fail the bounds check as negative ones
+                offsets[i] = (std::is_unsigned_v<T> && value > static_cast<T>(PY_SSIZE_T_MAX))
+                                 ? -1
+                                 : static_cast<Py_ssize_t>(value);
+            }
+            return true;
+        };
+        bool converted = false;
+        if (is_signed || is_unsigned)
+        {
+            switch (view.itemsize)
+            {
+            case 1:
+                converted = is_signed ? convert.template operator()<int8_t>() : convert.template operator()<uint8_t>();
+                break;
+            case 2:
+                converted = is_signed ? convert.template operator()<int16_t>() : convert.template operator()<uint16_t>();
+                break;
+            case 4:
+                converted = is_signed ? convert.template operator()<int32_t>() : convert.template operator()<uint32_t>();
+                break;
+            case 8:
+                converted = is_signed ? convert.template operator()<int64_t>() : convert.template operator()<uint64_t>();
+                break;
+            }
+        }
+        PyBuffer_Release(&view);
+        if (!converted)
+        {
+            PyErr_SetString(PyExc_TypeError, "Offsets buffer must hold native integers.");
+            return true;
+        }
+        return false;
+    }
+    PyErr_Clear();
 
-static PyObject *EndianedBytesIO_align(EndianedBytesIO *self, PyObject *arg)
-{
-    CHECK_CLOSED
-    Py_ssize_t size;
-    CHECK_SIZE_ARG(arg, size, 4)
-    if (size <= 0)
+    PyObject *seq = PySequence_Fast(obj, "Offsets must be a sequence or buffer of integers.");
+    if (seq == nullptr)
     {
-        PyErr_SetString(PyExc_ValueError, "Invalid size argument.");
-        return nullptr;
+        return true;
     }
-    Py_ssize_t pad = size - (self->pos % size);
-    if (pad != size)
+    const Py_ssize_t count = PySequence_Fast_GET_SIZE(seq);
+    PyObject **items = PySequence_Fast_ITEMS(seq);
+    offsets.resize(count);
+    for (Py_ssize_t i = 0; i < count; ++i)
     {
-        Py_ssize_t new_pos = self->pos + pad;
-        if (new_pos > self->view.len)
+        offsets[i] = PyLong_AsSsize_t(items[i]);
+        if (offsets[i] == -1 && PyErr_Occurred())
         {
-            PyErr_SetString(PyExc_ValueError, "Alignment exceeds buffer length.");
-            return nullptr;
+            Py_DecRef(seq);
+            return true;
         }
-        self->pos = new_pos;
     }
-    return PyLong_FromSsize_t(self->pos);
+    Py_DecRef(seq);
+    return false;
 }
 
-static PyObject *EndianedBytesIO_getValue(EndianedBytesIO *self, void *closure)
+/**
+ * @brief Checks that size bytes at offset are within the buffer.
+ *
+ * @return true on failure, false on success
+ */
+static inline bool _check_offset(EndianedBytesIO *self, Py_ssize_t offset, Py_ssize_t size)
 {
-    CHECK_CLOSED
-    if (PyBytes_CheckExact(self->view.obj))
+    if (offset < 0 || offset > self->view.len - size)
     {
-        Py_IncRef(self->view.obj);
-        return self->view.obj;
+        PyErr_Format(PyExc_ValueError, "Read at offset %zd exceeds buffer length.", offset);
+        return true;
     }
-    return PyBytes_FromObject(self->view.obj);
+    return false;
 }
 
-static PyObject *EndianedBytesIO_getbuffer(EndianedBytesIO *self, PyObject *args)
+/**
+ * @brief Reads count values of T at the offsets given by offset_at(i) into a tuple or typed memoryview.
+ */
+template <typename T, char endian, typename F>
+    requires EndianedOperation<T, endian>
+static PyObject *_EndianedBytesIO_gather(EndianedBytesIO *self, Py_ssize_t count, F &&offset_at, bool as_array)
 {
-    CHECK_CLOSED
-    if (self->view.buf == nullptr)
+    // a small or zero stride allows any count, so check it before sizing the buffer
+    if (count > PY_SSIZE_T_MAX / static_cast<Py_ssize_t>(sizeof(T)))
     {
-        PyErr_SetString(PyExc_ValueError, "Buffer is not initialized.");
+        PyErr_SetString(PyExc_OverflowError, "Count too large.");
         return nullptr;
     }
-    return PyMemoryView_FromBuffer(&self->view);
-}
-
-static inline PyObject *_EndianedBytesIO_readuntil(EndianedBytesIO *self, char delimiter, Py_ssize_t size)
-{
-    if (size < 0 || size > self->view.len - self->pos)
+    // bytes instead of T, std::vector<bool> isn't contiguous,
+    // and allocated through Python to get a MemoryError instead of std::bad_alloc
+    PyObject *raw = PyBytes_FromStringAndSize(nullptr, count * sizeof(T));
+    if (raw == nullptr)
     {
-        size = self->view.len - self->pos;
+        return nullptr;
     }
-    char *buffer = static_cast<char *>(self->view.buf) + self->pos;
-    char *end = static_cast<char *>(memchr(buffer, delimiter, size));
-    if (end == nullptr)
+    char *values = PyBytes_AS_STRING(raw);
+    for (Py_ssize_t i = 0; i < count; ++i)
     {
-        end = buffer + size;
+        const Py_ssize_t offset = offset_at(i);
+        if (_check_offset(self, offset, sizeof(T)))
+        {
+            Py_DecRef(raw);
+            return nullptr;
+        }
+        memcpy(values + i * sizeof(T), static_cast<char *>(self->view.buf) + offset, sizeof(T));
     }
-    Py_ssize_t read_size = end - buffer;
-    self->pos += read_size;
-    return PyBytes_FromStringAndSize(buffer, read_size);
-}
-
-static PyObject *EndianedBytesIO_readline(EndianedBytesIO *self, PyObject *size)
-{
-    CHECK_CLOSED
-    Py_ssize_t read_size;
-    CHECK_SIZE_ARG(size, read_size, self->view.len - self->pos);
-    return _EndianedBytesIO_readuntil(self, '\n', read_size);
-}
-
-static PyObject *EndianedBytesIO_read_cstring(EndianedBytesIO *self, PyObject *args, PyObject *kwds)
-{
-    CHECK_CLOSED
-
-    static const char *kwlist[] = {
-        "encoding",
-        "errors",
-        nullptr};
 
-    const char *encoding = "utf-8";         // Default encoding
-    const char *errors = "surrogateescape"; // Default error handling
-
-    if (!PyArg_ParseTupleAndKeywords(args, kwds, "|ss",
-                                     const_cast<char **>(kwlist),
-                                     &encoding,
-                                     &errors))
+    PyObject *ret = nullptr;
+    if (as_array)
     {
-        return nullptr;
+        ret = PyMemoryView_FromAnyArray<EndianedBytesIO, T, endian>(self, values, count);
+        Py_DecRef(raw);
+        return ret;
     }
 
-    PyObject *result_bytes = _EndianedBytesIO_readuntil(self, '\x00', self->view.len - self->pos);
-    if (result_bytes == nullptr)
+    ret = PyTuple_New(count);
+    T value{};
+    for (Py_ssize_t i = 0; ret != nullptr && i < count; ++i)
     {
-        return nullptr;
+        memcpy(&value, values + i * sizeof(T), sizeof(T));
+        handle_swap<EndianedBytesIO, T, endian>(self, value);
+        PyObject *item = PyObject_FromAny(value);
+        if (item == nullptr)
+        {
+            Py_CLEAR(ret);
+            break;
+        }
+        PyTuple_SET_ITEM(ret, i, item);
     }
-    PyObject *result_str = PyUnicode_FromEncodedObject(result_bytes, encoding, errors);
-    Py_DecRef(result_bytes);
-    return result_str;
+    Py_DecRef(raw);
+    return ret;
 }
 
-static PyObject *EndianedBytesIO_read_string(EndianedBytesIO *self, PyObject *args, PyObject *kwds)
+template <typename T, char endian>
+    requires EndianedOperation<T, endian>
+static PyObject *EndianedBytesIO_gather_t(EndianedBytesIO *self, PyObject *args, PyObject *kwds)
 {
     CHECK_CLOSED
 
     static const char *kwlist[] = {
-        "length",
-        "encoding",
-        "errors",
+        "offsets",
+        "as_array",
         nullptr};
 
-    PyObject *py_count = nullptr;
-    const char *encoding = "utf-8";         // Default encoding
-    const char *errors = "surrogateescape"; // Default error handling
+    PyObject *py_offsets = nullptr;
+    int as_array = 0;
 
-    if (!PyArg_ParseTupleAndKeywords(args, kwds, "|Oss",
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "O|p",
                                      const_cast<char **>(kwlist),
-                                     &py_count, &encoding,
-                                     &errors))
+                                     &py_offsets,
+                                     &as_array))
     {
         return nullptr;
     }
 
-    Py_ssize_t count = 0;
-    if (!_read_count(self, py_count, count))
+    std::vector<Py_ssize_t> offsets;
+    if (_offsets_FromObject(py_offsets, offsets))
     {
         return nullptr;
     }
-    if (count < 0 || count > self->view.len - self->pos)
-    {
-        count = self->view.len - self->pos;
+    return _EndianedBytesIO_gather<T, endian>(
+        self,
+        static_cast<Py_ssize_t>(offsets.size()),
+        [&](Py_ssize_t i)
+        {
+            return offsets[i];
+        },
+        as_array);
+}
+
+/**
+ * @brief Unpacks a record of format at every offset given by offset_at(i) into a list.
+ */
+template <typename F>
+static PyObject *_EndianedBytesIO_gather_struct(EndianedBytesIO *self, StructFormatObject *format, Py_ssize_t count, F &&offset_at)
+{
+    const char endian = StructFormat_endian(format, self->endian);
+    PyObject *ret = PyList_New(count);
+    for (Py_ssize_t i = 0; ret != nullptr && i < count; ++i)
+    {
+        const Py_ssize_t offset = offset_at(i);
+        PyObject *item = _check_offset(self, offset, format->size)
+                             ? nullptr
+                             : StructFormat_unpack(format, static_cast<char *>(self->view.buf) + offset, endian);
+        if (item == nullptr)
+        {
+            Py_DECREF(ret);
+            ret = nullptr;
+            break;
+        }
+        PyList_SET_ITEM(ret, i, item);
     }
-    char *buffer = static_cast<char *>(self->view.buf) + self->pos;
-    self->pos += count;
-    return PyUnicode_Decode(buffer, count, encoding, errors);
+    return ret;
 }
 
-static PyObject *EndianedBytesIO_read_bytes(EndianedBytesIO *self, PyObject *arg)
+static PyObject *EndianedBytesIO_gather_struct(EndianedBytesIO *self, PyObject *args)
 {
     CHECK_CLOSED
-    Py_ssize_t size = 0;
-    if (!_read_count(self, arg, size))
+    PyObject *py_format = nullptr;
+    PyObject *py_offsets = nullptr;
+    if (!PyArg_ParseTuple(args, "OO", &py_format, &py_offsets))
     {
         return nullptr;
     }
 
-    if (size > self->view.len - self->pos)
+    std::vector<Py_ssize_t> offsets;
+    if (_offsets_FromObject(py_offsets, offsets))
     {
-        PyErr_SetString(PyExc_ValueError, "Read exceeds buffer length.");
         return nullptr;
     }
-
-    PyObject *result = PyBytes_FromStringAndSize(
-        static_cast<char *>(self->view.buf) + self->pos, size);
-    if (result == nullptr)
+    StructFormatObject *format = StructFormat_FromObject(py_format);
+    if (format == nullptr)
     {
         return nullptr;
     }
-    self->pos += size;
-    return result;
+    PyObject *ret = _EndianedBytesIO_gather_struct(
+        self,
+        format,
+        static_cast<Py_ssize_t>(offsets.size()),
+        [&](Py_ssize_t i)
+        {
+            return offsets[i];
+        });
+    Py_DECREF(format);
+    return ret;
 }
 
-static PyObject *EndianedBytesIO_readuntil(EndianedBytesIO *self, PyObject *args)
+template <typename T, char endian>
+    requires EndianedOperation<T, endian>
+static PyObject *_EndianedBytesIO_read_strided(EndianedBytesIO *self, Py_ssize_t start, Py_ssize_t stride, Py_ssize_t count, bool as_array)
+{
+    return _EndianedBytesIO_gather<T, endian>(
+        self,
+        count,
+        [&](Py_ssize_t i)
+        {
+            return start + i * stride;
+        },
+        as_array);
+}
+
+typedef PyObject *(*StridedReader)(EndianedBytesIO *, Py_ssize_t, Py_ssize_t, Py_ssize_t, bool);
+
+#define _STRIDED_READERS_TYPE(T)                         \
+    {#T, _EndianedBytesIO_read_strided<T, '|'>},         \
+        {#T "_le", _EndianedBytesIO_read_strided<T, '<'>}, \
+        {#T "_be", _EndianedBytesIO_read_strided<T, '>'>}
+
+// the scalar types of read_strided, by the names of their read functions
+static const struct
+{
+    const char *name;
+    StridedReader read;
+} STRIDED_READERS[] = {
+    {"bool", _EndianedBytesIO_read_strided<bool, '|'>},
+    {"u8", _EndianedBytesIO_read_strided<u8, '|'>},
+    {"i8", _EndianedBytesIO_read_strided<i8, '|'>},
+    _STRIDED_READERS_TYPE(u16),
+    _STRIDED_READERS_TYPE(u32),
+    _STRIDED_READERS_TYPE(u64),
+    _STRIDED_READERS_TYPE(i16),
+    _STRIDED_READERS_TYPE(i32),
+    _STRIDED_READERS_TYPE(i64),
+    _STRIDED_READERS_TYPE(f16),
+    _STRIDED_READERS_TYPE(f32),
+    _STRIDED_READERS_TYPE(f64),
+};
+
+static PyObject *EndianedBytesIO_read_strided(EndianedBytesIO *self, PyObject *args, PyObject *kwds)
 {
     CHECK_CLOSED
-    PyObject *delimiter = nullptr;
-    Py_ssize_t read_size = 0;
-    if (!PyArg_ParseTuple(args, "O|n", &delimiter, &read_size))
+
+    static const char *kwlist[] = {
+        "type",
+        "start",
+        "stride",
+        "count",
+        "as_array",
+        nullptr};
+
+    PyObject *type = nullptr;
+    Py_ssize_t start = 0;
+    Py_ssize_t stride = 0;
+    Py_ssize_t count = 0;
+    int as_array = 0;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "Onnn|p",
+                                     const_cast<char **>(kwlist),
+                                     &type,
+                                     &start,
+                                     &stride,
+                                     &count,
+                                     &as_array))
     {
         return nullptr;
     }
-    if (read_size < 0 || read_size > self->view.len - self->pos)
+    if (count < 0)
     {
-        read_size = self->view.len - self->pos;
+        PyErr_SetString(PyExc_ValueError, "Count must be non-negative.");
+        return nullptr;
+    }
+    // with start within the buffer, start + i * stride can't overflow for any i < count
+    if (count > 0 && (start < 0 || start > self->view.len ||
+                      (count > 1 && (stride == PY_SSIZE_T_MIN ||
+                                     (stride != 0 && count - 1 > (PY_SSIZE_T_MAX - self->view.len) / (stride < 0 ? -stride : stride))))))
+    {
+        PyErr_SetString(PyExc_ValueError, "Read exceeds buffer length.");
+        return nullptr;
+    }
+    // reject reads that end outside of the buffer before allocating the result
+    const Py_ssize_t last = count > 0 ? start + (count - 1) * stride : 0;
+    if (last < 0 || last > self->view.len)
+    {
+        PyErr_SetString(PyExc_ValueError, "Read exceeds buffer length.");
+        return nullptr;
+    }
+
+    if (PyUnicode_Check(type))
+    {
+        for (const auto &reader : STRIDED_READERS)
+        {
+            if (unicode_equals(type, reader.name))
+            {
+                return reader.read(self, start, stride, count, as_array);
+            }
+        }
+    }
+
+    // anything else is a struct format, with a record per element
+    if (as_array)
+    {
+        PyErr_SetString(PyExc_ValueError, "as_array requires a scalar type.");
+        return nullptr;
+    }
+    StructFormatObject *format = StructFormat_FromObject(type);
+    if (format == nullptr)
+    {
+        return nullptr;
+    }
+    PyObject *ret = _EndianedBytesIO_gather_struct(
+        self,
+        format,
+        count,
+        [&](Py_ssize_t i)
+        {
+            return start + i * stride;
+        });
+    Py_DECREF(format);
+    return ret;
+}
+
+static PyObject *EndianedBytesIO_write_struct(EndianedBytesIO *self, PyObject *args)
+{
+    CHECK_CLOSED
+    if (self->view.readonly)
+    {
+        PyErr_SetString(PyExc_ValueError, "Buffer is not writable.");
+        return nullptr;
+    }
+
+    PyObject *py_format = nullptr;
+    PyObject *values = nullptr;
+    if (!PyArg_ParseTuple(args, "OO", &py_format, &values))
+    {
+        return nullptr;
+    }
+    StructFormatObject *format = StructFormat_FromObject(py_format);
+    if (format == nullptr)
+    {
+        return nullptr;
+    }
+    Py_ssize_t size = format->size;
+    bool failed = _write_struct(self, format, values, StructFormat_endian(format, self->endian));
+    Py_DECREF(format);
+    if (failed)
+    {
+        return nullptr;
+    }
+    return PyLong_FromSsize_t(size);
+}
+
+static PyObject *EndianedBytesIO_write_struct_array(EndianedBytesIO *self, PyObject *args, PyObject *kwds)
+{
+    CHECK_CLOSED
+    if (self->view.readonly)
+    {
+        PyErr_SetString(PyExc_ValueError, "Buffer is not writable.");
+        return nullptr;
+    }
+
+    static const char *kwlist[] = {
+        "format",
+        "v",
+        "write_count",
+        nullptr};
+
+    PyObject *py_format = nullptr;
+    PyObject *v = nullptr;
+    PyObject *write_count_obj = Py_True; // Default to True
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "OO|O!",
+                                     const_cast<char **>(kwlist),
+                                     &py_format,
+                                     &v,
+                                     &PyBool_Type,
+                                     &write_count_obj))
+    {
+        return nullptr;
+    }
+
+    StructFormatObject *format = StructFormat_FromObject(py_format);
+    if (format == nullptr)
+    {
+        return nullptr;
+    }
+    PyObject *seq = PySequence_Fast(v, "Argument must be a sequence.");
+    if (seq == nullptr)
+    {
+        Py_DECREF(format);
+        return nullptr;
+    }
+    Py_ssize_t count = PySequence_Fast_GET_SIZE(seq);
+    Py_ssize_t start_pos = self->pos;
+    if (((write_count_obj == Py_True) && _write_count(self, count)) ||
+        _reserve(self, self->pos + count * format->size))
+    {
+        Py_DecRef(seq);
+        Py_DECREF(format);
+        return nullptr;
+    }
+
+    const char endian = StructFormat_endian(format, self->endian);
+    PyObject **items = PySequence_Fast_ITEMS(seq);
+    for (Py_ssize_t i = 0; i < count; ++i)
+    {
+        if (_write_struct(self, format, items[i], endian))
+        {
+            Py_DecRef(seq);
+            Py_DECREF(format);
+            return nullptr;
+        }
+    }
+    Py_DecRef(seq);
+    Py_DECREF(format);
+    return PyLong_FromSsize_t(self->pos - start_pos);
+}
+
+static PyObject *EndianedBytesIO_read_schema(EndianedBytesIO *self, PyObject *arg)
+{
+    CHECK_CLOSED
+    SchemaObject *schema = Schema_FromObject(arg);
+    if (schema == nullptr)
+    {
+        return nullptr;
+    }
+    return Schema_read<EndianedBytesIO, _read_raw>(self, schema);
+}
+
+static PyObject *EndianedBytesIO_write_schema(EndianedBytesIO *self, PyObject *args)
+{
+    CHECK_CLOSED
+    PyObject *py_schema = nullptr;
+    PyObject *value = nullptr;
+    if (!PyArg_ParseTuple(args, "OO", &py_schema, &value))
+    {
+        return nullptr;
+    }
+    SchemaObject *schema = Schema_FromObject(py_schema);
+    if (schema == nullptr)
+    {
+        return nullptr;
+    }
+    return Schema_write<EndianedBytesIO, _write_raw>(self, schema, value);
+}
+
+static PyObject *EndianedBytesIO_seek(EndianedBytesIO *self, PyObject *args)
+{
+    CHECK_CLOSED
+    Py_ssize_t offset = 0;
+    int whence = SEEK_SET;
+    if (!PyArg_ParseTuple(args, "n|i", &offset, &whence))
+    {
+        return nullptr;
+    }
+    Py_ssize_t new_pos = 0;
+    switch (whence)
+    {
+    case SEEK_SET:
+        new_pos = offset;
+        break;
+    case SEEK_CUR:
+        new_pos = self->pos + offset;
+        break;
+    case SEEK_END:
+        new_pos = self->view.len + offset;
+        break;
+    default:
+        PyErr_SetString(PyExc_ValueError, "Invalid value for whence.");
+        return nullptr;
+    }
+    if (new_pos < 0)
+    {
+        PyErr_SetString(PyExc_ValueError, "Negative seek position.");
+        return nullptr;
+    }
+    self->pos = new_pos;
+    return PyLong_FromSsize_t(self->pos);
+}
+
+static PyObject *EndianedBytesIO_tell(EndianedBytesIO *self, PyObject *args)
+{
+    CHECK_CLOSED
+    return PyLong_FromSsize_t(self->pos);
+}
+
+static PyObject *EndianedBytesIO_seekable(EndianedBytesIO *self, PyObject *args)
+{
+    CHECK_CLOSED
+    Py_RETURN_TRUE;
+}
+
+static PyObject *EndianedBytesIO_readable(EndianedBytesIO *self, PyObject *args)
+{
+    CHECK_CLOSED
+    Py_RETURN_TRUE;
+}
+
+static PyObject *EndianedBytesIO_writable(EndianedBytesIO *self, PyObject *args)
+{
+    CHECK_CLOSED
+    PyObject *ret = self->view.readonly ? Py_False : Py_True;
+    Py_IncRef(ret);
+    return ret;
+}
+
+static PyObject *EndianedBytesIO_close(EndianedBytesIO *self, PyObject *args)
+{
+    if (self->exports > 0)
+    {
+        PyErr_SetString(PyExc_BufferError, "Existing exports of data: object cannot be closed.");
+        return nullptr;
+    }
+    _release_buffer(self);
+    self->closed = true;
+    Py_RETURN_NONE;
+}
+
+static PyObject *EndianedBytesIO_isatty(EndianedBytesIO *self, PyObject *args)
+{
+    CHECK_CLOSED
+    Py_RETURN_FALSE;
+}
+
+static PyObject *EndianedBytesIO_detach(EndianedBytesIO *self, PyObject *no_args)
+{
+    CHECK_CLOSED
+    PyErr_SetString(PyExc_IOError, "detach() not supported on this type of stream.");
+    return nullptr;
+}
+
+static PyObject *EndianedBytesIO_fileno(EndianedBytesIO *self, PyObject *no_args)
+{
+    CHECK_CLOSED
+    PyErr_SetString(PyExc_OSError, "fileno() not supported on this type of stream.");
+    return nullptr;
+}
+
+static PyObject *EndianedBytesIO_flush(EndianedBytesIO *self, PyObject *no_args)
+{
+    CHECK_CLOSED
+    Py_RETURN_NONE;
+}
+
+static PyObject *EndianedBytesIO_align(EndianedBytesIO *self, PyObject *arg)
+{
+    CHECK_CLOSED
+    Py_ssize_t size;
+    CHECK_SIZE_ARG(arg, size, 4)
+    if (size <= 0)
+    {
+        PyErr_SetString(PyExc_ValueError, "Invalid size argument.");
+        return nullptr;
+    }
+    Py_ssize_t pad = size - (self->pos % size);
+    if (pad != size)
+    {
+        Py_ssize_t new_pos = self->pos + pad;
+        if (new_pos > self->view.len)
+        {
+            if (self->view.readonly)
+            {
+                PyErr_SetString(PyExc_ValueError, "Alignment exceeds buffer length.");
+                return nullptr;
+            }
+            // pad writable buffers with zeros, like the python writer does
+            if (_check_size(self, pad))
+            {
+                return nullptr;
+            }
+        }
+        self->pos = new_pos;
+    }
+    return PyLong_FromSsize_t(self->pos);
+}
+
+static PyObject *EndianedBytesIO_getValue(EndianedBytesIO *self, void *closure)
+{
+    CHECK_CLOSED
+    // bytes can be shared if the view covers all of it, cursors only see a part of their source
+    if (!self->owned && self->view.obj != nullptr && PyBytes_CheckExact(self->view.obj) &&
+        self->view.buf == PyBytes_AS_STRING(self->view.obj) && self->view.len == PyBytes_GET_SIZE(self->view.obj))
+    {
+        Py_IncRef(self->view.obj);
+        return self->view.obj;
+    }
+    // only the viewed or written part, not the reserved capacity
+    return _copy_bytes(self, 0, self->view.len);
+}
+
+static PyObject *EndianedBytesIO_getbuffer(EndianedBytesIO *self, PyObject *args)
+{
+    CHECK_CLOSED
+    // export via the buffer protocol, so that the buffer can't be resized or released while the view is alive
+    return PyMemoryView_FromObject(reinterpret_cast<PyObject *>(self));
+}
+
+static PyObject *EndianedBytesIO_reserve(EndianedBytesIO *self, PyObject *arg)
+{
+    CHECK_CLOSED
+    if (self->view.readonly)
+    {
+        PyErr_SetString(PyExc_ValueError, "Buffer is not writable.");
+        return nullptr;
+    }
+    Py_ssize_t capacity = PyLong_AsSsize_t(arg);
+    if (capacity == -1 && PyErr_Occurred())
+    {
+        return nullptr;
+    }
+    if (_reserve(self, capacity))
+    {
+        return nullptr;
+    }
+    Py_RETURN_NONE;
+}
+
+static int EndianedBytesIO_bf_getbuffer(EndianedBytesIO *self, Py_buffer *view, int flags)
+{
+    if (self->closed)
+    {
+        PyErr_SetString(PyExc_ValueError, "I/O operation on closed file.");
+        return -1;
+    }
+    if (PyBuffer_FillInfo(view, reinterpret_cast<PyObject *>(self), self->view.buf, self->view.len, self->view.readonly, flags) < 0)
+    {
+        return -1;
+    }
+    self->exports++;
+    return 0;
+}
+
+static void EndianedBytesIO_bf_releasebuffer(EndianedBytesIO *self, Py_buffer *view)
+{
+    self->exports--;
+}
+
+/**
+ * @brief Finds the first occurrence of pattern in [start, end) of the buffer.
+ *
+ * @return the offset of the match or -1
+ */
+static inline Py_ssize_t _EndianedBytesIO_find(EndianedBytesIO *self, const void *pattern, Py_ssize_t pattern_size, Py_ssize_t start, Py_ssize_t end)
+{
+    const uint8_t *buffer = static_cast<const uint8_t *>(self->view.buf);
+    const uint8_t *match = nullptr;
+    _nogil(self, end - start, [&]
+           { match = byte_search(buffer + start, end - start, pattern, pattern_size); });
+    return match == nullptr ? -1 : match - buffer;
+}
+
+/**
+ * @brief Reads up to size bytes until the delimiter, which is left unread.
+ */
+static inline PyObject *_EndianedBytesIO_readuntil(EndianedBytesIO *self, const void *delimiter, Py_ssize_t delimiter_size, Py_ssize_t size)
+{
+    if (size < 0 || size > self->view.len - self->pos)
+    {
+        // the position may be behind the end of the buffer after a seek
+        size = std::max<Py_ssize_t>(self->view.len - self->pos, 0);
+    }
+    Py_ssize_t end = _EndianedBytesIO_find(self, delimiter, delimiter_size, self->pos, self->pos + size);
+    if (end < 0)
+    {
+        end = self->pos + size;
+    }
+    return _read_bytes(self, end - self->pos);
+}
+
+static PyObject *EndianedBytesIO_readline(EndianedBytesIO *self, PyObject *size)
+{
+    CHECK_CLOSED
+    Py_ssize_t read_size;
+    CHECK_SIZE_ARG(size, read_size, self->view.len - self->pos);
+    return _EndianedBytesIO_readuntil(self, "\n", 1, read_size);
+}
+
+/**
+ * @brief Decodes the null-terminated string at offset straight from the buffer.
+ *
+ * A string without a terminator ends at the end of the buffer.
+ * end receives the offset behind the terminator.
+ */
+static inline PyObject *_EndianedBytesIO_decode_cstring(EndianedBytesIO *self, const StringDecoder &decoder, Py_ssize_t offset, Py_ssize_t &end)
+{
+    const char *buffer = static_cast<const char *>(self->view.buf);
+    if (offset >= self->view.len)
+    {
+        end = offset;
+        return decoder.decode(buffer, 0);
+    }
+    const char *start = buffer + offset;
+    const char *terminator = static_cast<const char *>(memchr(start, '\0', self->view.len - offset));
+    if (terminator == nullptr)
+    {
+        end = self->view.len;
+        return decoder.decode(start, self->view.len - offset);
+    }
+    end = terminator - buffer + 1;
+    return decoder.decode(start, terminator - start);
+}
+
+static PyObject *_EndianedBytesIO_read_cstring(EndianedBytesIO *self, PyObject *args, PyObject *kwds, Py_ssize_t &pos)
+{
+    CHECK_CLOSED
+
+    static const char *kwlist[] = {
+        "encoding",
+        "errors",
+        "intern",
+        nullptr};
+
+    const char *encoding = "utf-8";         // Default encoding
+    const char *errors = "surrogateescape"; // Default error handling
+    int intern = 0;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "|ssp",
+                                     const_cast<char **>(kwlist),
+                                     &encoding,
+                                     &errors,
+                                     &intern))
+    {
+        return nullptr;
+    }
+
+    StringDecoder decoder;
+    if (EndianedIOBase_init_decoder(self, decoder, encoding, errors, intern))
+    {
+        return nullptr;
+    }
+    Py_ssize_t end = 0;
+    PyObject *result = _EndianedBytesIO_decode_cstring(self, decoder, pos, end);
+    if (result != nullptr)
+    {
+        pos = end;
+    }
+    return result;
+}
+
+static PyObject *EndianedBytesIO_read_cstring(EndianedBytesIO *self, PyObject *args, PyObject *kwds)
+{
+    return _EndianedBytesIO_read_cstring(self, args, kwds, self->pos);
+}
+
+static PyObject *EndianedBytesIO_read_cstring_array(EndianedBytesIO *self, PyObject *args, PyObject *kwds)
+{
+    CHECK_CLOSED
+
+    static const char *kwlist[] = {
+        "count",
+        "encoding",
+        "errors",
+        "intern",
+        nullptr};
+
+    PyObject *py_count = nullptr;
+    const char *encoding = "utf-8";         // Default encoding
+    const char *errors = "surrogateescape"; // Default error handling
+    int intern = 0;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "|Ossp",
+                                     const_cast<char **>(kwlist),
+                                     &py_count,
+                                     &encoding,
+                                     &errors,
+                                     &intern))
+    {
+        return nullptr;
+    }
+
+    Py_ssize_t count = 0;
+    if (!_read_count(self, py_count, count, self->pos))
+    {
+        return nullptr;
+    }
+    StringDecoder decoder;
+    if (EndianedIOBase_init_decoder(self, decoder, encoding, errors, intern))
+    {
+        return nullptr;
+    }
+    PyObject *ret = PyTuple_New(count);
+    if (ret == nullptr)
+    {
+        return nullptr;
+    }
+    // the position only moves if all strings could be decoded
+    Py_ssize_t pos = self->pos;
+    for (Py_ssize_t i = 0; i < count; ++i)
+    {
+        PyObject *item = _EndianedBytesIO_decode_cstring(self, decoder, pos, pos);
+        if (item == nullptr)
+        {
+            Py_DecRef(ret);
+            return nullptr;
+        }
+        PyTuple_SET_ITEM(ret, i, item);
+    }
+    self->pos = pos;
+    return ret;
+}
+
+static PyObject *EndianedBytesIO_read_cstring_table(EndianedBytesIO *self, PyObject *args, PyObject *kwds)
+{
+    CHECK_CLOSED
+
+    static const char *kwlist[] = {
+        "offsets",
+        "base",
+        "encoding",
+        "errors",
+        "intern",
+        nullptr};
+
+    PyObject *py_offsets = nullptr;
+    PyObject *py_base = Py_None;
+    const char *encoding = "utf-8";         // Default encoding
+    const char *errors = "surrogateescape"; // Default error handling
+    int intern = 0;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "O|Ossp",
+                                     const_cast<char **>(kwlist),
+                                     &py_offsets,
+                                     &py_base,
+                                     &encoding,
+                                     &errors,
+                                     &intern))
+    {
+        return nullptr;
+    }
+
+    Py_ssize_t base = self->pos;
+    if (py_base != Py_None)
+    {
+        base = PyLong_AsSsize_t(py_base);
+        if (base == -1 && PyErr_Occurred())
+        {
+            return nullptr;
+        }
+    }
+    StringDecoder decoder;
+    if (EndianedIOBase_init_decoder(self, decoder, encoding, errors, intern))
+    {
+        return nullptr;
+    }
+    PyObject *offsets = PySequence_Fast(py_offsets, "offsets must be a sequence of integers.");
+    if (offsets == nullptr)
+    {
+        return nullptr;
+    }
+    const Py_ssize_t count = PySequence_Fast_GET_SIZE(offsets);
+    PyObject *ret = PyTuple_New(count);
+    for (Py_ssize_t i = 0; ret != nullptr && i < count; ++i)
+    {
+        Py_ssize_t offset = PyLong_AsSsize_t(PySequence_Fast_GET_ITEM(offsets, i));
+        if (offset == -1 && PyErr_Occurred())
+        {
+            Py_CLEAR(ret);
+            break;
+        }
+        if (base + offset < 0)
+        {
+            PyErr_SetString(PyExc_ValueError, "Offset must be non-negative.");
+            Py_CLEAR(ret);
+            break;
+        }
+        Py_ssize_t end = 0;
+        PyObject *item = _EndianedBytesIO_decode_cstring(self, decoder, base + offset, end);
+        if (item == nullptr)
+        {
+            Py_CLEAR(ret);
+            break;
+        }
+        PyTuple_SET_ITEM(ret, i, item);
+    }
+    Py_DecRef(offsets);
+    return ret;
+}
+
+static PyObject *_EndianedBytesIO_read_string(EndianedBytesIO *self, PyObject *args, PyObject *kwds, Py_ssize_t &pos)
+{
+    CHECK_CLOSED
+
+    static const char *kwlist[] = {
+        "length",
+        "encoding",
+        "errors",
+        "intern",
+        nullptr};
+
+    PyObject *py_count = nullptr;
+    const char *encoding = "utf-8";         // Default encoding
+    const char *errors = "surrogateescape"; // Default error handling
+    int intern = 0;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "|Ossp",
+                                     const_cast<char **>(kwlist),
+                                     &py_count, &encoding,
+                                     &errors,
+                                     &intern))
+    {
+        return nullptr;
+    }
+
+    Py_ssize_t count = 0;
+    if (!_read_count(self, py_count, count, pos))
+    {
+        return nullptr;
+    }
+    // a read_string_at behind the end reads nothing
+    const Py_ssize_t available = pos < self->view.len ? self->view.len - pos : 0;
+    if (count < 0 || count > available)
+    {
+        count = available;
+    }
+    StringDecoder decoder;
+    if (EndianedIOBase_init_decoder(self, decoder, encoding, errors, intern))
+    {
+        return nullptr;
+    }
+    PyObject *result = decoder.decode(static_cast<char *>(self->view.buf) + pos, count);
+    if (result != nullptr)
+    {
+        pos += count;
+    }
+    return result;
+}
+
+static PyObject *EndianedBytesIO_read_string(EndianedBytesIO *self, PyObject *args, PyObject *kwds)
+{
+    return _EndianedBytesIO_read_string(self, args, kwds, self->pos);
+}
+
+static inline PyObject *_EndianedBytesIO_view(EndianedBytesIO *self, Py_ssize_t offset, Py_ssize_t size)
+{
+    // slicing a memoryview of self keeps this object exported (and so alive and unresizable) as long as the slice lives
+    PyObject *base = PyMemoryView_FromObject(reinterpret_cast<PyObject *>(self));
+    if (base == nullptr)
+    {
+        return nullptr;
+    }
+    PyObject *start = PyLong_FromSsize_t(offset);
+    PyObject *stop = PyLong_FromSsize_t(offset + size);
+    PyObject *slice = (start && stop) ? PySlice_New(start, stop, nullptr) : nullptr;
+    Py_XDECREF(start);
+    Py_XDECREF(stop);
+    if (slice == nullptr)
+    {
+        Py_DecRef(base);
+        return nullptr;
+    }
+    PyObject *view = PyObject_GetItem(base, slice);
+    Py_DecRef(slice);
+    Py_DecRef(base);
+    return view;
+}
+
+static PyObject *EndianedBytesIO_read_view(EndianedBytesIO *self, PyObject *arg)
+{
+    CHECK_CLOSED
+    Py_ssize_t size;
+    CHECK_SIZE_ARG(arg, size, -1);
+    if (size < 0 || size > self->view.len - self->pos)
+    {
+        size = std::max(self->view.len - self->pos, static_cast<Py_ssize_t>(0));
+    }
+
+    PyObject *view = _EndianedBytesIO_view(self, self->pos, size);
+    if (view == nullptr)
+    {
+        return nullptr;
+    }
+    self->pos += size;
+    return view;
+}
+
+/**
+ * @brief Creates an EndianedBytesIO over size bytes at offset of the buffer of self, without copying.
+ *
+ * The cursor holds an export of self, so self stays alive and can't be resized or closed while it exists.
+ * Skips the argument parsing and buffer request of EndianedBytesIO_init, which makes it cheap to create many of them.
+ */
+static PyObject *_EndianedBytesIO_cursor(EndianedBytesIO *self, Py_ssize_t offset, Py_ssize_t size, char endian)
+{
+    EndianedBytesIO *cursor = reinterpret_cast<EndianedBytesIO *>(
+        PyType_GenericAlloc(reinterpret_cast<PyTypeObject *>(EndianedBytesIO_OT), 0));
+    if (cursor == nullptr)
+    {
+        return nullptr;
+    }
+    if (EndianedBytesIO_bf_getbuffer(self, &cursor->view, PyBUF_ND) < 0)
+    {
+        Py_DecRef(reinterpret_cast<PyObject *>(cursor));
+        return nullptr;
+    }
+    cursor->view.buf = static_cast<char *>(cursor->view.buf) + offset;
+    cursor->view.len = size;
+    cursor->capacity = size;
+    cursor->endian = endian;
+    cursor->count_type = self->count_type;
+    return reinterpret_cast<PyObject *>(cursor);
+}
+
+static PyObject *EndianedBytesIO_cursor(EndianedBytesIO *self, PyObject *args, PyObject *kwds)
+{
+    CHECK_CLOSED
+
+    static const char *kwlist[] = {
+        "offset",
+        "length",
+        "endian",
+        nullptr};
+
+    PyObject *py_offset = Py_None;
+    PyObject *py_length = Py_None;
+    int endian = self->endian;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "|OOC",
+                                     const_cast<char **>(kwlist),
+                                     &py_offset,
+                                     &py_length,
+                                     &endian))
+    {
+        return nullptr;
+    }
+    if (endian != '<' && endian != '>')
+    {
+        PyErr_SetString(PyExc_ValueError, "Endian must be '<' or '>'.");
+        return nullptr;
+    }
+
+    Py_ssize_t offset = self->pos;
+    if (py_offset != Py_None)
+    {
+        offset = PyLong_AsSsize_t(py_offset);
+        if (offset == -1 && PyErr_Occurred())
+        {
+            return nullptr;
+        }
     }
-    if (PyUnicode_Check(delimiter))
+    if (offset < 0 || offset > self->view.len)
     {
-        PyObject *bytes = PyUnicode_AsEncodedString(delimiter, "utf-8", nullptr);
-        if (bytes == nullptr)
+        PyErr_SetString(PyExc_ValueError, "Cursor offset is out of bounds.");
+        return nullptr;
+    }
+
+    Py_ssize_t length = self->view.len - offset;
+    if (py_length != Py_None)
+    {
+        length = PyLong_AsSsize_t(py_length);
+        if (length == -1 && PyErr_Occurred())
+        {
+            return nullptr;
+        }
+        if (length < 0 || length > self->view.len - offset)
+        {
+            PyErr_SetString(PyExc_ValueError, "Cursor length exceeds the buffer.");
+            return nullptr;
+        }
+    }
+    return _EndianedBytesIO_cursor(self, offset, length, static_cast<char>(endian));
+}
+
+static PyObject *EndianedBytesIO_fork(EndianedBytesIO *self, PyObject *no_args)
+{
+    CHECK_CLOSED
+    PyObject *cursor = _EndianedBytesIO_cursor(self, 0, self->view.len, self->endian);
+    if (cursor != nullptr)
+    {
+        reinterpret_cast<EndianedBytesIO *>(cursor)->pos = self->pos;
+    }
+    return cursor;
+}
+
+// protobuf wire format
+
+enum class WireType : uint8_t
+{
+    Varint = 0,
+    I64 = 1,
+    Len = 2,
+    SGroup = 3,
+    EGroup = 4,
+    I32 = 5,
+};
+
+static inline bool _protobuf_truncated()
+{
+    PyErr_SetString(PyExc_ValueError, "Truncated protobuf message.");
+    return true;
+}
+
+/**
+ * @brief Reads a varint of a protobuf message at pos, which has to end before end.
+ *
+ * @return true on failure, false on success
+ */
+static inline bool _protobuf_varint(const uint8_t *buf, Py_ssize_t &pos, Py_ssize_t end, uint64_t &value)
+{
+    Py_ssize_t consumed = 0;
+    Py_ssize_t decoded = varint_decode_array(buf + pos, end - pos, &value, 1, consumed);
+    if (decoded < 0)
+    {
+        PyErr_SetString(PyExc_OverflowError, "Varint too large.");
+        return true;
+    }
+    if (decoded == 0)
+    {
+        return _protobuf_truncated();
+    }
+    pos += consumed;
+    return false;
+}
+
+/**
+ * @brief Skips the payload of the field with the given key, groups are skipped with all of their fields.
+ *
+ * @return true on failure, false on success
+ */
+static bool _protobuf_skip(const uint8_t *buf, Py_ssize_t &pos, Py_ssize_t end, uint64_t key)
+{
+    // field numbers of the open groups, a group ends with an EGroup key of its field
+    std::vector<uint64_t> groups;
+    while (true)
+    {
+        uint64_t size = 0;
+        switch (static_cast<WireType>(key & 7))
+        {
+        case WireType::Varint:
+            if (_protobuf_varint(buf, pos, end, size))
+            {
+                return true;
+            }
+            size = 0;
+            break;
+        case WireType::I64:
+            size = 8;
+            break;
+        case WireType::I32:
+            size = 4;
+            break;
+        case WireType::Len:
+            if (_protobuf_varint(buf, pos, end, size))
+            {
+                return true;
+            }
+            break;
+        case WireType::SGroup:
+            groups.push_back(key >> 3);
+            break;
+        case WireType::EGroup:
+            if (groups.empty() || groups.back() != key >> 3)
+            {
+                PyErr_Format(PyExc_ValueError, "Unexpected end of group %llu.", key >> 3);
+                return true;
+            }
+            groups.pop_back();
+            break;
+        default:
+            PyErr_Format(PyExc_ValueError, "Invalid wire type %d.", static_cast<int>(key & 7));
+            return true;
+        }
+        if (size > static_cast<uint64_t>(end - pos))
+        {
+            return _protobuf_truncated();
+        }
+        pos += static_cast<Py_ssize_t>(size);
+        if (groups.empty())
+        {
+            return false;
+        }
+        if (pos >= end)
+        {
+            return _protobuf_truncated();
+        }
+        if (_protobuf_varint(buf, pos, end, key))
+        {
+            return true;
+        }
+    }
+}
+
+/**
+ * @brief Appends value to the list of field in dict, creating the list if needed.
+ *
+ * @return true on failure, false on success
+ */
+static bool _protobuf_append(PyObject *dict, uint64_t field, PyObject *value)
+{
+    PyObject *key = PyLong_FromUnsignedLongLong(field);
+    if (key == nullptr)
+    {
+        return true;
+    }
+    PyObject *list = nullptr;
+    int found = dict_get_item_ref(dict, key, &list);
+    if (found == 0)
+    {
+        list = PyList_New(0);
+        if (list != nullptr && PyDict_SetItem(dict, key, list) < 0)
+        {
+            Py_DecRef(list);
+            list = nullptr;
+        }
+    }
+    Py_DecRef(key);
+    if (list == nullptr)
+    {
+        return true;
+    }
+    bool failed = PyList_Append(list, value) < 0;
+    Py_DecRef(list);
+    return failed;
+}
+
+static PyObject *EndianedBytesIO_read_protobuf(EndianedBytesIO *self, PyObject *args, PyObject *kwds)
+{
+    CHECK_CLOSED
+
+    static const char *kwlist[] = {
+        "size",
+        "fields",
+        nullptr};
+
+    PyObject *py_size = Py_None;
+    PyObject *py_fields = Py_None;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "|OO",
+                                     const_cast<char **>(kwlist),
+                                     &py_size,
+                                     &py_fields))
+    {
+        return nullptr;
+    }
+
+    Py_ssize_t end = std::max(self->view.len, self->pos);
+    if (py_size != Py_None)
+    {
+        Py_ssize_t size = PyLong_AsSsize_t(py_size);
+        if (size == -1 && PyErr_Occurred())
+        {
+            return nullptr;
+        }
+        if (size < 0 || size > self->view.len - self->pos)
+        {
+            PyErr_SetString(PyExc_ValueError, "Read exceeds buffer length.");
+            return nullptr;
+        }
+        end = self->pos + size;
+    }
+
+    std::vector<uint64_t> fields;
+    if (py_fields != Py_None)
+    {
+        if (varints_FromObject(py_fields, fields))
         {
             return nullptr;
         }
-        char *delim = PyBytes_AsString(bytes);
-        Py_ssize_t delim_len = PyBytes_Size(bytes);
-        PyObject *result = _EndianedBytesIO_readuntil(self, delim[0], read_size);
+        std::sort(fields.begin(), fields.end());
+    }
+
+    PyObject *result = PyDict_New();
+    if (result == nullptr)
+    {
+        return nullptr;
+    }
+    // the length-delimited fields are slices of a single memoryview of the buffer
+    PyObject *base = nullptr;
+    const uint8_t *buf = static_cast<const uint8_t *>(self->view.buf);
+    Py_ssize_t pos = self->pos;
+    bool failed = false;
+    while (pos < end && !failed)
+    {
+        uint64_t key = 0;
+        if (_protobuf_varint(buf, pos, end, key))
+        {
+            failed = true;
+            break;
+        }
+        const uint64_t field = key >> 3;
+        if (field == 0)
+        {
+            PyErr_SetString(PyExc_ValueError, "Invalid field number 0.");
+            failed = true;
+            break;
+        }
+        const WireType wire_type = static_cast<WireType>(key & 7);
+        if ((py_fields != Py_None && !std::binary_search(fields.begin(), fields.end(), field)) ||
+            wire_type == WireType::SGroup || wire_type == WireType::EGroup)
+        {
+            failed = _protobuf_skip(buf, pos, end, key);
+            continue;
+        }
+
+        PyObject *value = nullptr;
+        switch (wire_type)
+        {
+        case WireType::Varint:
+        {
+            uint64_t v = 0;
+            if (!_protobuf_varint(buf, pos, end, v))
+            {
+                value = PyLong_FromUnsignedLongLong(v);
+            }
+            break;
+        }
+        case WireType::I64:
+        {
+            uint64_t v = 0;
+            if (end - pos < 8)
+            {
+                _protobuf_truncated();
+                break;
+            }
+            memcpy(&v, buf + pos, sizeof(v));
+            pos += sizeof(v);
+            if constexpr (IS_BIG_ENDIAN_SYSTEM)
+            {
+                v = byteswap(v);
+            }
+            value = PyLong_FromUnsignedLongLong(v);
+            break;
+        }
+        case WireType::I32:
+        {
+            uint32_t v = 0;
+            if (end - pos < 4)
+            {
+                _protobuf_truncated();
+                break;
+            }
+            memcpy(&v, buf + pos, sizeof(v));
+            pos += sizeof(v);
+            if constexpr (IS_BIG_ENDIAN_SYSTEM)
+            {
+                v = byteswap(v);
+            }
+            value = PyLong_FromUnsignedLong(v);
+            break;
+        }
+        case WireType::Len:
+        {
+            uint64_t size = 0;
+            if (_protobuf_varint(buf, pos, end, size))
+            {
+                break;
+            }
+            if (size > static_cast<uint64_t>(end - pos))
+            {
+                _protobuf_truncated();
+                break;
+            }
+            if (base == nullptr)
+            {
+                base = PyMemoryView_FromObject(reinterpret_cast<PyObject *>(self));
+                if (base == nullptr)
+                {
+                    break;
+                }
+            }
+            value = PySequence_GetSlice(base, pos, pos + static_cast<Py_ssize_t>(size));
+            pos += static_cast<Py_ssize_t>(size);
+            break;
+        }
+        default:
+            PyErr_Format(PyExc_ValueError, "Invalid wire type %d.", static_cast<int>(wire_type));
+            break;
+        }
+        if (value == nullptr)
+        {
+            failed = true;
+            break;
+        }
+        failed = _protobuf_append(result, field, value);
+        Py_DecRef(value);
+    }
+    Py_XDECREF(base);
+    if (failed)
+    {
+        Py_DecRef(result);
+        return nullptr;
+    }
+    self->pos = end;
+    return result;
+}
+
+static PyObject *_EndianedBytesIO_read_bytes(EndianedBytesIO *self, PyObject *args, PyObject *kwds, Py_ssize_t &pos)
+{
+    CHECK_CLOSED
+
+    static const char *kwlist[] = {
+        "length",
+        "copy",
+        nullptr};
+
+    PyObject *py_count = nullptr;
+    int copy = 1;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "|Op",
+                                     const_cast<char **>(kwlist),
+                                     &py_count,
+                                     &copy))
+    {
+        return nullptr;
+    }
+
+    Py_ssize_t size = 0;
+    if (!_read_count(self, py_count, size, pos))
+    {
+        return nullptr;
+    }
+
+    if (size > self->view.len - pos)
+    {
+        PyErr_SetString(PyExc_ValueError, "Read exceeds buffer length.");
+        return nullptr;
+    }
+
+    if (copy)
+    {
+        return _read_bytes(self, size, pos);
+    }
+    PyObject *result = _EndianedBytesIO_view(self, pos, size);
+    if (result == nullptr)
+    {
+        return nullptr;
+    }
+    pos += size;
+    return result;
+}
+
+static PyObject *EndianedBytesIO_read_bytes(EndianedBytesIO *self, PyObject *args, PyObject *kwds)
+{
+    return _EndianedBytesIO_read_bytes(self, args, kwds, self->pos);
+}
+
+/**
+ * @brief Gets the bytes of a search pattern, str is encoded as UTF-8.
+ *
+ * @return true on failure, false on success, the view has to be released with PyBuffer_Release
+ */
+static bool _pattern_FromObject(PyObject *obj, Py_buffer &view)
+{
+    if (PyUnicode_Check(obj))
+    {
+        PyObject *bytes = PyUnicode_AsUTF8String(obj);
+        if (bytes == nullptr)
+        {
+            return true;
+        }
+        // the view keeps the bytes alive
+        int result = PyObject_GetBuffer(bytes, &view, PyBUF_SIMPLE);
         Py_DecRef(bytes);
-        return result;
+        if (result != 0)
+        {
+            return true;
+        }
     }
-    else if (PyBytes_Check(delimiter))
+    else if (PyObject_GetBuffer(obj, &view, PyBUF_SIMPLE) != 0)
     {
-        char *delim = PyBytes_AsString(delimiter);
-        Py_ssize_t delim_len = PyBytes_Size(delimiter);
-        return _EndianedBytesIO_readuntil(self, delim[0], read_size);
+        PyErr_SetString(PyExc_TypeError, "Pattern must be a bytes-like or string object.");
+        return true;
     }
-    else
+    if (view.len == 0)
+    {
+        PyBuffer_Release(&view);
+        PyErr_SetString(PyExc_ValueError, "Pattern must not be empty.");
+        return true;
+    }
+    return false;
+}
+
+/**
+ * @brief Converts the start and end arguments of find like slice indices, None selects the defaults.
+ *
+ * @return true on failure, false on success
+ */
+static bool _find_range(EndianedBytesIO *self, PyObject *py_start, PyObject *py_end, Py_ssize_t &start, Py_ssize_t &end)
+{
+    const Py_ssize_t len = self->view.len;
+    start = self->pos;
+    end = len;
+    for (auto [obj, index] : {std::pair<PyObject *, Py_ssize_t *>{py_start, &start}, {py_end, &end}})
+    {
+        if (obj == nullptr || obj == Py_None)
+        {
+            continue;
+        }
+        Py_ssize_t value = PyLong_AsSsize_t(obj);
+        if (value == -1 && PyErr_Occurred())
+        {
+            return true;
+        }
+        if (value < 0)
+        {
+            value += len;
+        }
+        *index = value;
+    }
+    start = std::clamp<Py_ssize_t>(start, 0, len);
+    end = std::clamp<Py_ssize_t>(end, start, len);
+    return false;
+}
+
+static PyObject *EndianedBytesIO_readuntil(EndianedBytesIO *self, PyObject *args)
+{
+    CHECK_CLOSED
+    PyObject *delimiter = nullptr;
+    Py_ssize_t read_size = -1;
+    if (!PyArg_ParseTuple(args, "O|n", &delimiter, &read_size))
+    {
+        return nullptr;
+    }
+    Py_buffer view{};
+    if (_pattern_FromObject(delimiter, view))
+    {
+        return nullptr;
+    }
+    PyObject *result = _EndianedBytesIO_readuntil(self, view.buf, view.len, read_size);
+    PyBuffer_Release(&view);
+    return result;
+}
+
+static PyObject *EndianedBytesIO_find(EndianedBytesIO *self, PyObject *args)
+{
+    CHECK_CLOSED
+    PyObject *pattern = nullptr;
+    PyObject *py_start = Py_None;
+    PyObject *py_end = Py_None;
+    if (!PyArg_ParseTuple(args, "O|OO", &pattern, &py_start, &py_end))
+    {
+        return nullptr;
+    }
+    Py_ssize_t start = 0;
+    Py_ssize_t end = 0;
+    if (_find_range(self, py_start, py_end, start, end))
+    {
+        return nullptr;
+    }
+    Py_buffer view{};
+    if (_pattern_FromObject(pattern, view))
+    {
+        return nullptr;
+    }
+    Py_ssize_t offset = _EndianedBytesIO_find(self, view.buf, view.len, start, end);
+    PyBuffer_Release(&view);
+    return PyLong_FromSsize_t(offset);
+}
+
+static PyObject *EndianedBytesIO_find_all(EndianedBytesIO *self, PyObject *args, PyObject *kwds)
+{
+    CHECK_CLOSED
+
+    static const char *kwlist[] = {
+        "pattern",
+        "start",
+        "end",
+        "as_array",
+        nullptr};
+
+    PyObject *pattern = nullptr;
+    PyObject *py_start = Py_None;
+    PyObject *py_end = Py_None;
+    int as_array = 0;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "O|OOp",
+                                     const_cast<char **>(kwlist),
+                                     &pattern,
+                                     &py_start,
+                                     &py_end,
+                                     &as_array))
+    {
+        return nullptr;
+    }
+    Py_ssize_t start = 0;
+    Py_ssize_t end = 0;
+    if (_find_range(self, py_start, py_end, start, end))
+    {
+        return nullptr;
+    }
+    Py_buffer view{};
+    if (_pattern_FromObject(pattern, view))
+    {
+        return nullptr;
+    }
+
+    // non-overlapping matches, like bytes.count
+    std::vector<int64_t> offsets;
+    const uint8_t *buffer = static_cast<const uint8_t *>(self->view.buf);
+    _nogil(self, end - start, [&]
+           {
+               for (Py_ssize_t pos = start; pos <= end - view.len;)
+               {
+                   const uint8_t *match = byte_search(buffer + pos, end - pos, view.buf, view.len);
+                   if (match == nullptr)
+                   {
+                       break;
+                   }
+                   offsets.push_back(match - buffer);
+                   pos = (match - buffer) + view.len;
+               } });
+    PyBuffer_Release(&view);
+
+    if (as_array)
+    {
+        return PyMemoryView_FromAnyArray<EndianedBytesIO, int64_t, NATIVE_ENDIAN>(
+            self, reinterpret_cast<const char *>(offsets.data()), static_cast<Py_ssize_t>(offsets.size()));
+    }
+    PyObject *ret = PyTuple_New(static_cast<Py_ssize_t>(offsets.size()));
+    if (ret == nullptr)
     {
-        PyErr_SetString(PyExc_TypeError, "Delimiter must be a bytes or string object.");
         return nullptr;
     }
+    for (size_t i = 0; i < offsets.size(); ++i)
+    {
+        PyObject *item = PyLong_FromLongLong(offsets[i]);
+        if (item == nullptr)
+        {
+            Py_DecRef(ret);
+            return nullptr;
+        }
+        PyTuple_SET_ITEM(ret, i, item);
+    }
+    return ret;
 }
 
 static PyObject *EndianedBytesIO_readlines(EndianedBytesIO *self, PyObject *size)
@@ -912,7 +2831,7 @@ static PyObject *EndianedBytesIO_readlines(EndianedBytesIO *self, PyObject *size
     while (self->pos < end)
     {
         read_size = end - self->pos;
-        PyObject *line = _EndianedBytesIO_readuntil(self, '\n', read_size);
+        PyObject *line = _EndianedBytesIO_readuntil(self, "\n", 1, read_size);
         if (line == nullptr)
         {
             Py_DecRef(result);
@@ -934,64 +2853,85 @@ static PyObject *EndianedBytesIO_readlines(EndianedBytesIO *self, PyObject *size
     return result;
 }
 
+/**
+ * @brief Decodes count varints at the current position into dst.
+ *
+ * @return true on failure, false on success
+ */
+static bool _read_varints(EndianedBytesIO *self, uint64_t *dst, Py_ssize_t count)
+{
+    const uint8_t *src = static_cast<const uint8_t *>(self->view.buf) + self->pos;
+    const Py_ssize_t size = std::max<Py_ssize_t>(0, self->view.len - self->pos);
+    Py_ssize_t consumed = 0;
+    Py_ssize_t decoded = 0;
+    _nogil(self, count, [&]
+           { decoded = varint_decode_array(src, size, dst, count, consumed); });
+    if (decoded < 0)
+    {
+        PyErr_SetString(PyExc_OverflowError, "Varint too large.");
+        return true;
+    }
+    if (decoded < count)
+    {
+        PyErr_SetString(PyExc_ValueError, "Read exceeds buffer length.");
+        return true;
+    }
+    self->pos += consumed;
+    return false;
+}
+
+template <bool zigzag>
 static PyObject *EndianedBytesIO_read_varint(EndianedBytesIO *self, PyObject *args)
 {
     CHECK_CLOSED
-    Py_ssize_t value = 0;
-    uint32_t shift = 0;
-
-    while (true)
+    uint64_t value = 0;
+    if (_read_varints(self, &value, 1))
     {
-        if (self->pos >= self->view.len)
-        {
-            PyErr_SetString(PyExc_ValueError, "Read exceeds buffer length.");
-            return nullptr;
-        }
-        unsigned char byte = static_cast<unsigned char *>(self->view.buf)[self->pos++];
-        value |= (static_cast<Py_ssize_t>(byte & 0x7F) << shift);
-        if (!(byte & 0x80))
-        {
-            break;
-        }
-        shift += 7;
-        if (shift >= sizeof(Py_ssize_t) * 8)
-        {
-            PyErr_SetString(PyExc_OverflowError, "Varint too large.");
-            return nullptr;
-        }
+        return nullptr;
     }
-    return PyLong_FromSsize_t(value);
+    return PyLong_FromVarint<zigzag>(value);
 }
 
-static PyObject *EndianedBytesIO_read_varint_array(EndianedBytesIO *self, PyObject *args)
+template <bool zigzag>
+static PyObject *EndianedBytesIO_read_varint_array(EndianedBytesIO *self, PyObject *args, PyObject *kwds)
 {
     CHECK_CLOSED
-    Py_ssize_t size = 0;
 
-    if (!_read_count(self, args, size))
+    static const char *kwlist[] = {
+        "count",
+        "as_array",
+        nullptr};
+
+    PyObject *py_count = nullptr;
+    int as_array = 0;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "|Op",
+                                     const_cast<char **>(kwlist),
+                                     &py_count,
+                                     &as_array))
+    {
+        return nullptr;
+    }
+
+    Py_ssize_t size = 0;
+    if (!_read_count(self, py_count, size, self->pos))
     {
         return nullptr;
     }
 
+    // every varint takes up at least one byte
     if (size > self->view.len - self->pos)
     {
         PyErr_SetString(PyExc_ValueError, "Read exceeds buffer length.");
         return nullptr;
     }
 
-    PyObject *ret = PyTuple_New(size);
-
-    for (Py_ssize_t i = 0; i < size; ++i)
+    std::vector<uint64_t> values(size);
+    if (_read_varints(self, values.data(), size))
     {
-        PyObject *item = EndianedBytesIO_read_varint(self, nullptr);
-        if (item == nullptr)
-        {
-            Py_DecRef(ret);
-            return nullptr;
-        }
-        PyTuple_SetItem(ret, i, item); // Steal reference, no need to DECREF
+        return nullptr;
     }
-    return ret;
+    return varints_AsObject<zigzag>(self, values, as_array);
 }
 
 PyObject *EndianedBytesIO_write(EndianedBytesIO *self, PyObject *arg)
@@ -1013,12 +2953,15 @@ PyObject *EndianedBytesIO_write(EndianedBytesIO *self, PyObject *arg)
         Py_RETURN_NONE;
     }
 
-    if (_check_size(self, sizeof(view.len)))
+    if (_check_size(self, view.len))
     {
+        PyBuffer_Release(&view);
         return nullptr; // Resize failed
     }
-    memcpy(static_cast<char *>(self->view.buf) + self->pos, view.buf, view.len);
+    char *dst = static_cast<char *>(self->view.buf) + self->pos;
     self->pos += view.len;
+    _nogil(self, view.len, [&]
+           { memcpy(dst, view.buf, view.len); });
     PyObject *ret = PyLong_FromSsize_t(view.len);
     PyBuffer_Release(&view);
     return ret;
@@ -1036,21 +2979,68 @@ PyObject *EndianedBytesIO_writelines(EndianedBytesIO *self, PyObject *arg)
     return nullptr;
 }
 
+#define _GENERATE_GATHER_FUNCTIONS_TYPE(T)                                                                                                                                  \
+    {"gather_" #T, reinterpret_cast<PyCFunction>(LOCKED(EndianedBytesIO_gather_t<T, '|'>)), METH_VARARGS | METH_KEYWORDS, "Read a " #T " value at each offset."},           \
+        {"gather_" #T "_le", reinterpret_cast<PyCFunction>(LOCKED(EndianedBytesIO_gather_t<T, '<'>)), METH_VARARGS | METH_KEYWORDS, "Read a " #T " value at each offset."}, \
+        {"gather_" #T "_be", reinterpret_cast<PyCFunction>(LOCKED(EndianedBytesIO_gather_t<T, '>'>)), METH_VARARGS | METH_KEYWORDS, "Read a " #T " value at each offset."}
+
+#define GENERATE_GATHER_FUNCTIONS                                                                                                                                   \
+    {"gather_bool", reinterpret_cast<PyCFunction>(LOCKED(EndianedBytesIO_gather_t<bool, '|'>)), METH_VARARGS | METH_KEYWORDS, "Read a bool value at each offset."}, \
+        {"gather_u8", reinterpret_cast<PyCFunction>(LOCKED(EndianedBytesIO_gather_t<u8, '|'>)), METH_VARARGS | METH_KEYWORDS, "Read a u8 value at each offset."},   \
+        {"gather_i8", reinterpret_cast<PyCFunction>(LOCKED(EndianedBytesIO_gather_t<i8, '|'>)), METH_VARARGS | METH_KEYWORDS, "Read an i8 value at each offset."},  \
+        _GENERATE_GATHER_FUNCTIONS_TYPE(u16),                                                                                                                       \
+        _GENERATE_GATHER_FUNCTIONS_TYPE(u32),                                                                                                                       \
+        _GENERATE_GATHER_FUNCTIONS_TYPE(u64),                                                                                                                       \
+        _GENERATE_GATHER_FUNCTIONS_TYPE(i16),                                                                                                                       \
+        _GENERATE_GATHER_FUNCTIONS_TYPE(i32),                                                                                                                       \
+        _GENERATE_GATHER_FUNCTIONS_TYPE(i64),                                                                                                                       \
+        _GENERATE_GATHER_FUNCTIONS_TYPE(f16),                                                                                                                       \
+        _GENERATE_GATHER_FUNCTIONS_TYPE(f32),                                                                                                                       \
+        _GENERATE_GATHER_FUNCTIONS_TYPE(f64)
+
+// the read_*_at functions read at a local offset, as the GIL is released during large reads
+template <typename T, char endian>
+constexpr auto EndianedBytesIO_read_t_at = EndianedIOBase_read_at_offset<EndianedBytesIO, _EndianedBytesIO_read_t<T, endian>>;
+template <typename T, char endian>
+constexpr auto EndianedBytesIO_read_array_t_at = EndianedIOBase_read_args_at_offset<EndianedBytesIO, _EndianedBytesIO_read_array_t<T, endian>>;
+constexpr auto EndianedBytesIO_read_cstring_at = EndianedIOBase_read_args_at_offset<EndianedBytesIO, _EndianedBytesIO_read_cstring>;
+constexpr auto EndianedBytesIO_read_string_at = EndianedIOBase_read_args_at_offset<EndianedBytesIO, _EndianedBytesIO_read_string>;
+constexpr auto EndianedBytesIO_read_bytes_at = EndianedIOBase_read_args_at_offset<EndianedBytesIO, _EndianedBytesIO_read_bytes>;
+
 static PyMethodDef EndianedBytesIO_methods[] = {
     GENERATE_ENDIANEDIOBASE_BASE_FUNCTIONS(EndianedBytesIO),
-    {"read1", reinterpret_cast<PyCFunction>(EndianedBytesIO_read), METH_O, "Read bytes from the buffer."},       // basically fullfilling it with normal read
-    {"readinto1", reinterpret_cast<PyCFunction>(EndianedBytesIO_readinto), METH_O, "Read bytes into a buffer."}, // basically fullfilling it with normal readinto
-    {"readline", reinterpret_cast<PyCFunction>(EndianedBytesIO_readline), METH_O, ""},
-    {"readlines", reinterpret_cast<PyCFunction>(EndianedBytesIO_readlines), METH_O, ""},
-    {"detach", reinterpret_cast<PyCFunction>(EndianedBytesIO_detach), METH_NOARGS, "Detach the buffer."},
-    {"getbuffer", reinterpret_cast<PyCFunction>(EndianedBytesIO_getbuffer), METH_NOARGS, "Get the buffer."},
-    {"getvalue", reinterpret_cast<PyCFunction>(EndianedBytesIO_getValue), METH_NOARGS, "Get the current value of the buffer."},
+    {"read1", reinterpret_cast<PyCFunction>(LOCKED(EndianedBytesIO_read)), METH_O, "Read bytes from the buffer."},       // basically fullfilling it with normal read
+    {"readinto1", reinterpret_cast<PyCFunction>(LOCKED(EndianedBytesIO_readinto)), METH_O, "Read bytes into a buffer."}, // basically fullfilling it with normal readinto
+    {"readline", reinterpret_cast<PyCFunction>(LOCKED(EndianedBytesIO_readline)), METH_O, ""},
+    {"readlines", reinterpret_cast<PyCFunction>(LOCKED(EndianedBytesIO_readlines)), METH_O, ""},
+    {"detach", reinterpret_cast<PyCFunction>(LOCKED(EndianedBytesIO_detach)), METH_NOARGS, "Detach the buffer."},
+    {"getbuffer", reinterpret_cast<PyCFunction>(LOCKED(EndianedBytesIO_getbuffer)), METH_NOARGS, "Get the buffer."},
+    {"getvalue", reinterpret_cast<PyCFunction>(LOCKED(EndianedBytesIO_getValue)), METH_NOARGS, "Get the current value of the buffer."},
+    {"reserve", reinterpret_cast<PyCFunction>(LOCKED(EndianedBytesIO_reserve)), METH_O, "Reserve capacity for at least n bytes."},
+    {"read_view", reinterpret_cast<PyCFunction>(LOCKED(EndianedBytesIO_read_view)), METH_O, "Read bytes as a memoryview of the buffer without copying."},
+    {"cursor", reinterpret_cast<PyCFunction>(LOCKED(EndianedBytesIO_cursor)), METH_VARARGS | METH_KEYWORDS, "Create a reader over a part of the buffer that shares it instead of copying."},
+    {"fork", reinterpret_cast<PyCFunction>(LOCKED(EndianedBytesIO_fork)), METH_NOARGS, "Create a reader over the whole buffer at the current position that shares it instead of copying."},
+    {"read_protobuf", reinterpret_cast<PyCFunction>(LOCKED(EndianedBytesIO_read_protobuf)), METH_VARARGS | METH_KEYWORDS, "Read the fields of a protobuf message into a dict of lists, length-delimited fields as memoryviews of the buffer."},
+    {"read_count", reinterpret_cast<PyCFunction>(LOCKED(EndianedBytesIO_read_count)), METH_NOARGS, "Read a length prefix as configured by count_type."},
+    {"write_count", reinterpret_cast<PyCFunction>(LOCKED(EndianedBytesIO_write_count)), METH_O, "Write a length prefix as configured by count_type."},
     // reader endian based
     GENERATE_ENDIANEDIOBASE_READ_FUNCTIONS(EndianedBytesIO),
+    GENERATE_ENDIANEDIOBASE_READ_AT_FUNCTIONS(EndianedBytesIO),
     // writer endian based
-    {"write", reinterpret_cast<PyCFunction>(EndianedBytesIO_write), METH_O, "Write bytes to the buffer."},
+    {"write", reinterpret_cast<PyCFunction>(LOCKED(EndianedBytesIO_write)), METH_O, "Write bytes to the buffer."},
     GENERATE_ENDIANEDIOBASE_WRITE_FUNCTIONS(EndianedBytesIO),
-    {"readuntil", reinterpret_cast<PyCFunction>(EndianedBytesIO_readuntil), METH_VARARGS, "Read until a delimiter."},
+    {"readuntil", reinterpret_cast<PyCFunction>(LOCKED(EndianedBytesIO_readuntil)), METH_VARARGS, "Read until a delimiter, which is left unread."},
+    {"find", reinterpret_cast<PyCFunction>(LOCKED(EndianedBytesIO_find)), METH_VARARGS, "Find the offset of the first occurrence of a pattern, -1 if there is none."},
+    {"find_all", reinterpret_cast<PyCFunction>(LOCKED(EndianedBytesIO_find_all)), METH_VARARGS | METH_KEYWORDS, "Find the offsets of all non-overlapping occurrences of a pattern."},
+    {"read_struct", reinterpret_cast<PyCFunction>(LOCKED(EndianedBytesIO_read_struct)), METH_O, "Read a record of a compiled struct format."},
+    {"read_struct_array", reinterpret_cast<PyCFunction>(LOCKED(EndianedBytesIO_read_struct_array)), METH_VARARGS | METH_KEYWORDS, "Read a list of records of a compiled struct format."},
+    {"gather_struct", reinterpret_cast<PyCFunction>(LOCKED(EndianedBytesIO_gather_struct)), METH_VARARGS, "Read a list of records of a compiled struct format at the given offsets."},
+    {"read_strided", reinterpret_cast<PyCFunction>(LOCKED(EndianedBytesIO_read_strided)), METH_VARARGS | METH_KEYWORDS, "Read count values or records starting at start, stride bytes apart."},
+    GENERATE_GATHER_FUNCTIONS,
+    {"write_struct", reinterpret_cast<PyCFunction>(LOCKED(EndianedBytesIO_write_struct)), METH_VARARGS, "Write a record of a compiled struct format."},
+    {"write_struct_array", reinterpret_cast<PyCFunction>(LOCKED(EndianedBytesIO_write_struct_array)), METH_VARARGS | METH_KEYWORDS, "Write a list of records of a compiled struct format."},
+    {"read_schema", reinterpret_cast<PyCFunction>(LOCKED(EndianedBytesIO_read_schema)), METH_O, "Read an object with a lowered serialization schema."},
+    {"write_schema", reinterpret_cast<PyCFunction>(LOCKED(EndianedBytesIO_write_schema)), METH_VARARGS, "Write an object with a lowered serialization schema."},
     {NULL} /* Sentinel */
 };
 
@@ -1070,15 +3060,443 @@ EndianedBytesIO_repr(EndianedBytesIO *self)
         self->closed ? Py_True : Py_False);
 }
 
-// Usage would be:
-static PyType_Spec EndianedBytesIO_Spec =
-    createPyTypeSpec<EndianedBytesIO>(
-        "bier.endianedbinaryio.C.EndianedBytesIO.EndianedBytesIO",
-        EndianedBytesIO_init,
-        EndianedBytesIO_dealloc,
-        EndianedBytesIO_members,
-        EndianedBytesIO_methods,
-        EndianedBytesIO_repr);
+static PyType_Slot EndianedBytesIO_slots[] = {
+    {Py_tp_new, reinterpret_cast<void *>(PyType_GenericNew)},
+    {Py_tp_init, reinterpret_cast<void *>(EndianedBytesIO_init)},
+    {Py_tp_dealloc, reinterpret_cast<void *>(EndianedBytesIO_dealloc)},
+    {Py_tp_members, EndianedBytesIO_members},
+    {Py_tp_getset, EndianedBytesIO_getseters},
+    {Py_tp_methods, EndianedBytesIO_methods},
+    {Py_tp_repr, reinterpret_cast<void *>(LOCKED(EndianedBytesIO_repr))},
+#if PY_VERSION_HEX >= 0x03090000
+    {Py_bf_getbuffer, reinterpret_cast<void *>(LOCKED(EndianedBytesIO_bf_getbuffer))},
+    {Py_bf_releasebuffer, reinterpret_cast<void *>(LOCKED(EndianedBytesIO_bf_releasebuffer))},
+#endif
+    {0, NULL},
+};
+
+#if PY_VERSION_HEX < 0x03090000
+// the buffer slots of PyType_Spec were added in 3.9, older versions get them set after the type is created
+static PyBufferProcs EndianedBytesIO_as_buffer = {
+    reinterpret_cast<getbufferproc>(LOCKED(EndianedBytesIO_bf_getbuffer)),
+    reinterpret_cast<releasebufferproc>(LOCKED(EndianedBytesIO_bf_releasebuffer)),
+};
+#endif
+
+static PyType_Spec EndianedBytesIO_Spec = {
+    "bier.endianedbinaryio.C.EndianedBytesIO.EndianedBytesIO", // const char* name;
+    sizeof(EndianedBytesIO),                                   // int basicsize;
+    0,                                                         // int itemsize;
+    Py_TPFLAGS_DEFAULT | Py_TPFLAGS_BASETYPE,                  // unsigned int flags;
+    EndianedBytesIO_slots,                                     // PyType_Slot *slots;
+};
+
+// EndianedMmapIO
+// an EndianedBytesIO over a memory mapped file, so that all the read and write functions are shared
+
+static void _unmap(void *addr, Py_ssize_t size)
+{
+    if (addr == nullptr)
+    {
+        return;
+    }
+#ifdef _WIN32
+    UnmapViewOfFile(addr);
+#else
+    munmap(addr, size);
+#endif
+}
+
+/**
+ * @brief Maps size bytes of the file descriptor.
+ *
+ * @return void* The mapping or nullptr on error
+ */
+static void *_map(int fd, Py_ssize_t size, bool writable, bool copy_on_write, bool populate)
+{
+#ifdef _WIN32
+    HANDLE file = reinterpret_cast<HANDLE>(_get_osfhandle(fd));
+    DWORD protect = copy_on_write ? PAGE_WRITECOPY : (writable ? PAGE_READWRITE : PAGE_READONLY);
+    DWORD access = copy_on_write ? FILE_MAP_COPY : (writable ? FILE_MAP_WRITE : FILE_MAP_READ);
+    // the view keeps the mapping object alive
+    HANDLE mapping = CreateFileMappingW(file, nullptr, protect, 0, 0, nullptr);
+    if (mapping == nullptr)
+    {
+        PyErr_SetFromWindowsErr(0);
+        return nullptr;
+    }
+    void *addr = MapViewOfFile(mapping, access, 0, 0, size);
+    CloseHandle(mapping);
+    if (addr == nullptr)
+    {
+        PyErr_SetFromWindowsErr(0);
+    }
+    return addr;
+#else
+    int prot = (writable || copy_on_write) ? PROT_READ | PROT_WRITE : PROT_READ;
+    int flags = copy_on_write ? MAP_PRIVATE : MAP_SHARED;
+#ifdef MAP_POPULATE
+    if (populate)
+    {
+        flags |= MAP_POPULATE;
+    }
+#endif
+    void *addr;
+    Py_BEGIN_ALLOW_THREADS
+    addr = mmap(nullptr, size, prot, flags, fd, 0);
+    Py_END_ALLOW_THREADS
+    if (addr == MAP_FAILED)
+    {
+        PyErr_SetFromErrno(PyExc_OSError);
+        return nullptr;
+    }
+    return addr;
+#endif
+}
+
+struct MmapAdvice
+{
+    const char *name;
+    int advice;
+};
+
+#ifdef _WIN32
+// madvise has no equivalent, the hints are accepted and ignored
+static const MmapAdvice MMAP_ADVICE_NAMES[] = {
+    {"normal", 0},
+    {"sequential", 0},
+    {"random", 0},
+    {"willneed", 0},
+    {"dontneed", 0},
+};
+#else
+static const MmapAdvice MMAP_ADVICE_NAMES[] = {
+    {"normal", MADV_NORMAL},
+    {"sequential", MADV_SEQUENTIAL},
+    {"random", MADV_RANDOM},
+    {"willneed", MADV_WILLNEED},
+    {"dontneed", MADV_DONTNEED},
+};
+#endif
+
+static inline int _advice_FromObject(PyObject *obj, int &out)
+{
+    if (PyUnicode_Check(obj))
+    {
+        for (const auto &entry : MMAP_ADVICE_NAMES)
+        {
+            if (unicode_equals(obj, entry.name))
+            {
+                out = entry.advice;
+                return 0;
+            }
+        }
+    }
+    PyErr_Format(PyExc_ValueError, "Invalid advice: %R, expected normal, sequential, random, willneed or dontneed.", obj);
+    return -1;
+}
+
+/**
+ * @brief Passes an access pattern hint for the byte range to the kernel.
+ *
+ * @return true on failure, false on success
+ */
+static bool _advise(EndianedBytesIO *self, int advice, Py_ssize_t start, Py_ssize_t length)
+{
+#ifndef _WIN32
+    if (self->view.buf == nullptr || length <= 0)
+    {
+        return false;
+    }
+    // madvise requires a page aligned start
+    const Py_ssize_t page_size = sysconf(_SC_PAGESIZE);
+    const Py_ssize_t aligned = start - (start % page_size);
+    int result;
+    Py_BEGIN_ALLOW_THREADS
+    result = madvise(static_cast<char *>(self->view.buf) + aligned, length + (start - aligned), advice);
+    Py_END_ALLOW_THREADS
+    if (result != 0)
+    {
+        PyErr_SetFromErrno(PyExc_OSError);
+        return true;
+    }
+#endif
+    return false;
+}
+
+static int EndianedMmapIO_init(EndianedBytesIO *self, PyObject *args, PyObject *kwds)
+{
+    if (self->exports > 0)
+    {
+        PyErr_SetString(PyExc_BufferError, "Existing exports of data: object cannot be re-initialized.");
+        return -1;
+    }
+
+    // Clear existing buffer if reinitialized
+    _release_buffer(self);
+    self->pos = 0;
+    self->endian = '<';
+    self->closed = true;
+
+    Py_buffer endian_view{};
+
+    static const char *kwlist[] = {
+        "file",
+        "mode",
+        "endian",
+        "count_type",
+        "advice",
+        "populate",
+        nullptr};
+
+    // Parse arguments
+    PyObject *file = nullptr;
+    const char *mode = "r";
+    PyObject *count_type = Py_None;
+    PyObject *py_advice = Py_None;
+    int populate = 0;
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "O|ss*OOp",
+                                     const_cast<char **>(kwlist),
+                                     &file,
+                                     &mode,
+                                     &endian_view,
+                                     &count_type,
+                                     &py_advice,
+                                     &populate))
+    {
+        return -1;
+    }
+
+    // parse endian argument
+    if (endian_view.buf != nullptr)
+    {
+        char *buf_ptr = static_cast<char *>(endian_view.buf);
+        if (endian_view.len != 1 || (buf_ptr[0] != '<' && buf_ptr[0] != '>'))
+        {
+            PyErr_SetString(PyExc_ValueError, "Endian must be '<' or '>'.");
+            PyBuffer_Release(&endian_view);
+            return -1;
+        }
+        self->endian = buf_ptr[0];
+        PyBuffer_Release(&endian_view);
+    }
+    if (CountType_FromObject(count_type, self->count_type) < 0)
+    {
+        return -1;
+    }
+    int advice = 0;
+    if (py_advice != Py_None && _advice_FromObject(py_advice, advice) < 0)
+    {
+        return -1;
+    }
+
+    // r: read-only, r+: writes go to the file, c: copy on write, writes stay private
+    bool writable = false;
+    bool copy_on_write = false;
+    if (strcmp(mode, "r") == 0 || strcmp(mode, "rb") == 0)
+    {
+    }
+    else if (strcmp(mode, "r+") == 0 || strcmp(mode, "rb+") == 0 || strcmp(mode, "r+b") == 0)
+    {
+        writable = true;
+    }
+    else if (strcmp(mode, "c") == 0)
+    {
+        copy_on_write = true;
+    }
+    else
+    {
+        PyErr_Format(PyExc_ValueError, "Invalid mode: %s, expected r, r+ or c.", mode);
+        return -1;
+    }
+
+    int fd = -1;
+    bool close_fd = false;
+    if (PyLong_Check(file))
+    {
+        fd = long_as_int(file);
+        if (fd == -1 && PyErr_Occurred())
+        {
+            return -1;
+        }
+    }
+    else
+    {
+        int flags = writable ? O_RDWR : O_RDONLY;
+#ifdef O_BINARY
+        flags |= O_BINARY;
+#endif
+        // os.open handles path-like objects and the platform specifics
+        PyObject *os = PyImport_ImportModule("os");
+        if (os == nullptr)
+        {
+            return -1;
+        }
+        PyObject *py_fd = PyObject_CallMethod(os, "open", "Oi", file, flags);
+        Py_DecRef(os);
+        if (py_fd == nullptr)
+        {
+            return -1;
+        }
+        fd = long_as_int(py_fd);
+        Py_DecRef(py_fd);
+        if (fd == -1 && PyErr_Occurred())
+        {
+            return -1;
+        }
+        close_fd = true;
+    }
+
+    // the mapping stays valid after the descriptor is closed
+#ifdef _WIN32
+    struct _stat64 st;
+    bool failed = _fstat64(fd, &st) != 0;
+#else
+    struct stat st;
+    bool failed = fstat(fd, &st) != 0;
+#endif
+    void *addr = nullptr;
+    Py_ssize_t size = 0;
+    if (failed)
+    {
+        PyErr_SetFromErrno(PyExc_OSError);
+    }
+    else
+    {
+        size = static_cast<Py_ssize_t>(st.st_size);
+        // empty files can't be mapped
+        if (size > 0)
+        {
+            addr = _map(fd, size, writable, copy_on_write, populate);
+            failed = addr == nullptr;
+        }
+    }
+    if (close_fd)
+    {
+        close(fd);
+    }
+    if (failed)
+    {
+        return -1;
+    }
+
+    PyBuffer_FillInfo(&self->view, nullptr, addr, size, !(writable || copy_on_write), PyBUF_ND);
+    self->capacity = size;
+    self->mapped = true;
+    self->closed = false;
+    if (py_advice != Py_None && _advise(self, advice, 0, size))
+    {
+        return -1;
+    }
+    return 0;
+}
+
+static PyObject *EndianedMmapIO_madvise(EndianedBytesIO *self, PyObject *args, PyObject *kwds)
+{
+    CHECK_CLOSED
+
+    static const char *kwlist[] = {
+        "advice",
+        "start",
+        "length",
+        nullptr};
+
+    PyObject *py_advice = nullptr;
+    Py_ssize_t start = 0;
+    PyObject *py_length = Py_None;
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "O|nO",
+                                     const_cast<char **>(kwlist),
+                                     &py_advice,
+                                     &start,
+                                     &py_length))
+    {
+        return nullptr;
+    }
+    int advice = 0;
+    if (_advice_FromObject(py_advice, advice) < 0)
+    {
+        return nullptr;
+    }
+    if (start < 0 || start > self->view.len)
+    {
+        PyErr_SetString(PyExc_ValueError, "madvise start out of range.");
+        return nullptr;
+    }
+    Py_ssize_t length = self->view.len - start;
+    if (py_length != Py_None)
+    {
+        length = PyLong_AsSsize_t(py_length);
+        if (length == -1 && PyErr_Occurred())
+        {
+            return nullptr;
+        }
+        length = std::min(length, self->view.len - start);
+    }
+    if (_advise(self, advice, start, length))
+    {
+        return nullptr;
+    }
+    Py_RETURN_NONE;
+}
+
+static PyObject *EndianedMmapIO_flush(EndianedBytesIO *self, PyObject *no_args)
+{
+    CHECK_CLOSED
+    if (self->view.buf == nullptr || self->view.readonly)
+    {
+        Py_RETURN_NONE;
+    }
+    int result;
+    Py_BEGIN_ALLOW_THREADS
+#ifdef _WIN32
+    result = FlushViewOfFile(self->view.buf, self->view.len) ? 0 : -1;
+#else
+    result = msync(self->view.buf, self->view.len, MS_SYNC);
+#endif
+    Py_END_ALLOW_THREADS
+    if (result != 0)
+    {
+        return PyErr_SetFromErrno(PyExc_OSError);
+    }
+    Py_RETURN_NONE;
+}
+
+static PyMethodDef EndianedMmapIO_methods[] = {
+    {"madvise", reinterpret_cast<PyCFunction>(LOCKED(EndianedMmapIO_madvise)), METH_VARARGS | METH_KEYWORDS, "Hint the expected access pattern of the mapping, or a part of it, to the kernel."},
+    {"flush", reinterpret_cast<PyCFunction>(LOCKED(EndianedMmapIO_flush)), METH_NOARGS, "Write the changes of a writable mapping back to the file."},
+    {NULL} /* Sentinel */
+};
+
+static PyObject *
+EndianedMmapIO_repr(EndianedBytesIO *self)
+{
+    if (self->closed)
+    {
+        return PyUnicode_FromString("<EndianedMmapIO [closed]>");
+    }
+
+    return PyUnicode_FromFormat(
+        "<EndianedMmapIO pos=%zd len=%zd endian='%c' readonly=%R>",
+        self->pos,
+        self->view.len,
+        self->endian,
+        self->view.readonly ? Py_True : Py_False);
+}
+
+static PyType_Slot EndianedMmapIO_slots[] = {
+    {Py_tp_init, reinterpret_cast<void *>(EndianedMmapIO_init)},
+    {Py_tp_methods, EndianedMmapIO_methods},
+    {Py_tp_repr, reinterpret_cast<void *>(LOCKED(EndianedMmapIO_repr))},
+    {0, NULL},
+};
+
+static PyType_Spec EndianedMmapIO_Spec = {
+    "bier.endianedbinaryio.C.EndianedBytesIO.EndianedMmapIO", // const char* name;
+    sizeof(EndianedBytesIO),                                  // int basicsize;
+    0,                                                        // int itemsize;
+    Py_TPFLAGS_DEFAULT | Py_TPFLAGS_BASETYPE,                 // unsigned int flags;
+    EndianedMmapIO_slots,                                     // PyType_Slot *slots;
+};
 
 static PyModuleDef EndianedBytesIO_module = {
     PyModuleDef_HEAD_INIT,
@@ -1111,11 +3529,36 @@ PyMODINIT_FUNC PyInit_EndianedBytesIO(void)
     {
         return NULL;
     }
+    module_set_gil_not_used(m);
     // init_format_num();
+    if (StructFormat_import() < 0 || Schema_import() < 0)
+    {
+        Py_DecRef(m);
+        return NULL;
+    }
     EndianedBytesIO_OT = PyType_FromSpec(&EndianedBytesIO_Spec);
+#if PY_VERSION_HEX < 0x03090000
+    if (EndianedBytesIO_OT != nullptr)
+    {
+        reinterpret_cast<PyTypeObject *>(EndianedBytesIO_OT)->tp_as_buffer = &EndianedBytesIO_as_buffer;
+    }
+#endif
     if (add_object(m, "EndianedBytesIO", EndianedBytesIO_OT) < 0)
     {
         return NULL;
     }
+    // a single class as bases is only accepted since 3.10
+    PyObject *bases = PyTuple_Pack(1, EndianedBytesIO_OT);
+    if (bases == nullptr)
+    {
+        Py_DecRef(m);
+        return NULL;
+    }
+    PyObject *EndianedMmapIO_OT = PyType_FromSpecWithBases(&EndianedMmapIO_Spec, bases);
+    Py_DecRef(bases);
+    if (EndianedMmapIO_OT == nullptr || add_object(m, "EndianedMmapIO", EndianedMmapIO_OT) < 0)
+    {
+        return NULL;
+    }
     return m;
 }
@@ -0,0 +1,1161 @@
+#include <concepts>
+#include <cstdint>
+#include <bit>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#ifdef _WIN32
+#include <io.h>
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+#include "Python.h"
+#include "structmember.h"
+
+#include "PyConverter.hpp"
+#include "EndianedIOBase.hpp"
+#include "StructFormat.hpp"
+#include "Schema.hpp"
+#include <algorithm>
+
+PyObject *EndianedFileIO_OT = nullptr;
+PyObject *UnsupportedOperation = nullptr; // io.UnsupportedOperation
+
+typedef struct
+{
+    PyObject_HEAD char endian;
+    int fd;               // file descriptor, -1 if closed
+    int64_t pos;          // position of the file descriptor, the logical position differs by the buffered bytes
+    PyObject *name;       // the file argument of the constructor
+    bool readable;        // opened for reading
+    bool writable;        // opened for writing
+    bool closefd;         // close fd on close
+    bool append;          // writes go to the end of the file
+    CountType count_type; // encoding of length prefixes
+    Py_ssize_t buffer_size; // size of the read-ahead and write buffers, 0 if disabled
+    // read-ahead buffer, pos is ahead of the logical position by the unread bytes
+    std::vector<char> *read_buffer; // nullptr if disabled
+    Py_ssize_t read_buffer_pos;     // position of the next unread byte
+    Py_ssize_t read_buffer_len;     // number of valid bytes
+    // write buffer, pos is behind the logical position by its size
+    std::vector<char> *write_buffer; // nullptr if disabled
+    StringInternCache *string_cache; // interned strings of the reads with intern=True, nullptr until the first one
+    IOLock io_lock;                  // serializes the calls, the GIL is released during the syscalls
+} EndianedFileIO;
+
+#define DEFAULT_READ_BUFFER_SIZE 65536
+
+// positional io doesn't touch the offset of the file descriptor,
+// so the same descriptor can be shared with other readers
+#ifdef _WIN32
+static Py_ssize_t _pread(int fd, void *dst, Py_ssize_t size, int64_t offset)
+{
+    HANDLE handle = reinterpret_cast<HANDLE>(_get_osfhandle(fd));
+    OVERLAPPED overlapped{};
+    overlapped.Offset = static_cast<DWORD>(offset);
+    overlapped.OffsetHigh = static_cast<DWORD>(offset >> 32);
+    DWORD read_size = 0;
+    if (!ReadFile(handle, dst, static_cast<DWORD>(std::min<Py_ssize_t>(size, MAXDWORD)), &read_size, &overlapped))
+    {
+        if (GetLastError() == ERROR_HANDLE_EOF)
+        {
+            return 0;
+        }
+        errno = EIO;
+        return -1;
+    }
+    return read_size;
+}
+
+static Py_ssize_t _pwrite(int fd, const void *src, Py_ssize_t size, int64_t offset)
+{
+    HANDLE handle = reinterpret_cast<HANDLE>(_get_osfhandle(fd));
+    OVERLAPPED overlapped{};
+    overlapped.Offset = static_cast<DWORD>(offset);
+    overlapped.OffsetHigh = static_cast<DWORD>(offset >> 32);
+    DWORD written = 0;
+    if (!WriteFile(handle, src, static_cast<DWORD>(std::min<Py_ssize_t>(size, MAXDWORD)), &written, &overlapped))
+    {
+        errno = EIO;
+        return -1;
+    }
+    return written;
+}
+
+static int _file_size(int fd, int64_t &size)
+{
+    struct _stat64 st;
+    if (_fstat64(fd, &st) != 0)
+    {
+        return -1;
+    }
+    size = st.st_size;
+    return 0;
+}
+
+#define ftruncate _chsize_s
+#else
+#define _pread pread
+#define _pwrite pwrite
+
+static int _file_size(int fd, int64_t &size)
+{
+    struct stat st;
+    if (fstat(fd, &st) != 0)
+    {
+        return -1;
+    }
+    size = st.st_size;
+    return 0;
+}
+#endif
+
+#define CHECK_FILE_OPEN(ret)                                                \
+    if (self->fd < 0)                                                       \
+    {                                                                       \
+        PyErr_SetString(PyExc_ValueError, "I/O operation on closed file."); \
+        return ret;                                                         \
+    }
+
+// raised like io.FileIO does when the mode doesn't allow the operation
+#define CHECK_FILE_MODE(mode, operation, ret)                                      \
+    if (!self->mode)                                                               \
+    {                                                                              \
+        PyErr_SetString(UnsupportedOperation, "File not open for " operation "."); \
+        return ret;                                                                \
+    }
+
+/**
+ * @brief Reads up to size bytes at the file position into dst, bypassing the read-ahead buffer.
+ *
+ * The GIL is released during the syscalls.
+ *
+ * @return Py_ssize_t The number of bytes read, less than size only at the end of the file, or -1 on error
+ */
+static Py_ssize_t _file_readinto(EndianedFileIO *self, char *dst, Py_ssize_t size)
+{
+    CHECK_FILE_OPEN(-1)
+    Py_ssize_t total = 0;
+    while (total < size)
+    {
+        Py_ssize_t read_size;
+        Py_BEGIN_ALLOW_THREADS
+        read_size = _pread(self->fd, dst + total, size - total, self->pos + total);
+        Py_END_ALLOW_THREADS
+        if (read_size < 0)
+        {
+            if (errno == EINTR && PyErr_CheckSignals() == 0)
+            {
+                continue;
+            }
+            if (!PyErr_Occurred())
+            {
+                PyErr_SetFromErrno(PyExc_OSError);
+            }
+            return -1;
+        }
+        if (read_size == 0)
+        {
+            break;
+        }
+        total += read_size;
+    }
+    self->pos += total;
+    return total;
+}
+
+/**
+ * @brief Moves the file position to the end of the file.
+ *
+ * @return true on failure, false on success
+ */
+static bool _seek_end(EndianedFileIO *self)
+{
+    if (_file_size(self->fd, self->pos) != 0)
+    {
+        PyErr_SetFromErrno(PyExc_OSError);
+        return true;
+    }
+    return false;
+}
+
+/**
+ * @brief Writes size bytes at the file position, bypassing the write buffer.
+ *
+ * In append mode the data goes to the current end of the file instead,
+ * pwrite doesn't honor O_APPEND on every platform.
+ * The GIL is released during the syscalls.
+ *
+ * @return true on failure, false on success
+ */
+static bool _file_write(EndianedFileIO *self, const char *src, Py_ssize_t size)
+{
+    CHECK_FILE_OPEN(true)
+    if (self->append && _seek_end(self))
+    {
+        return true;
+    }
+    while (size > 0)
+    {
+        Py_ssize_t written;
+        Py_BEGIN_ALLOW_THREADS
+        written = _pwrite(self->fd, src, size, self->pos);
+        Py_END_ALLOW_THREADS
+        if (written < 0)
+        {
+            if (errno == EINTR && PyErr_CheckSignals() == 0)
+            {
+                continue;
+            }
+            if (!PyErr_Occurred())
+            {
+                PyErr_SetFromErrno(PyExc_OSError);
+            }
+            return true;
+        }
+        if (written == 0)
+        {
+            PyErr_SetString(PyExc_OSError, "The file didn't accept any data.");
+            return true;
+        }
+        self->pos += written;
+        src += written;
+        size -= written;
+    }
+    return false;
+}
+
+/**
+ * @brief Writes the pending bytes of the write buffer to the file.
+ *
+ * @return true on failure, false on success
+ */
+static bool _flush_write_buffer(EndianedFileIO *self)
+{
+    return EndianedIOBase_flush_write_buffer<EndianedFileIO, _file_write>(self);
+}
+
+/**
+ * @brief Reads up to size bytes into dst, served from the read-ahead buffer.
+ *
+ * Reads that are larger than the buffer go directly into dst.
+ *
+ * @return Py_ssize_t The number of bytes read, less than size only at the end of the file, or -1 on error
+ */
+static Py_ssize_t _read_into(EndianedFileIO *self, char *dst, Py_ssize_t size)
+{
+    CHECK_FILE_OPEN(-1)
+    CHECK_FILE_MODE(readable, "reading", -1)
+    return EndianedIOBase_read_into<EndianedFileIO, _file_readinto, _file_write>(self, dst, size);
+}
+
+/**
+ * @brief Moves the file position back over the unread buffered bytes.
+ *
+ * Unlike for streams, this is pure bookkeeping and can't fail.
+ */
+static void _drop_read_buffer(EndianedFileIO *self)
+{
+    self->pos -= self->read_buffer_len - self->read_buffer_pos;
+    self->read_buffer_pos = 0;
+    self->read_buffer_len = 0;
+}
+
+/**
+ * @brief Flushes the write buffer and drops the read-ahead buffer,
+ * so that the file position is the logical position.
+ *
+ * @return true on failure, false on success
+ */
+static bool _sync_file(EndianedFileIO *self)
+{
+    _drop_read_buffer(self);
+    return _flush_write_buffer(self);
+}
+
+/**
+ * @brief Writes size bytes, collected in the write buffer if enabled.
+ *
+ * @return true on failure, false on success
+ */
+static bool _write_raw(EndianedFileIO *self, const void *src, Py_ssize_t size)
+{
+    CHECK_FILE_OPEN(true)
+    CHECK_FILE_MODE(writable, "writing", true)
+    _drop_read_buffer(self);
+    // a buffered run starts at the end already, so that tell() is right before the flush
+    if (self->append && self->write_buffer != nullptr && self->write_buffer->empty() && _seek_end(self))
+    {
+        return true;
+    }
+    return EndianedIOBase_write_buffered<EndianedFileIO, _file_write>(self, src, size, self->buffer_size);
+}
+
+static inline bool _read_raw(EndianedFileIO *self, void *dst, Py_ssize_t size)
+{
+    return EndianedIOBase_read_raw<EndianedFileIO, _read_into>(self, dst, size);
+}
+
+/**
+ * @brief Gets the logical position, the file position corrected by the buffered bytes.
+ *
+ * @return true on failure, false on success
+ */
+static bool _tell(EndianedFileIO *self, Py_ssize_t &pos)
+{
+    CHECK_FILE_OPEN(true)
+    pos = static_cast<Py_ssize_t>(self->pos) - (self->read_buffer_len - self->read_buffer_pos);
+    if (self->write_buffer != nullptr)
+    {
+        pos += self->write_buffer->size();
+    }
+    return false;
+}
+
+/**
+ * @brief Seeks to a logical position, within the read-ahead buffer if possible.
+ *
+ * @return PyObject* The new position or nullptr on error
+ */
+static PyObject *_seek(EndianedFileIO *self, Py_ssize_t offset, int whence)
+{
+    Py_ssize_t pos = 0;
+    if (_tell(self, pos))
+    {
+        return nullptr;
+    }
+    Py_ssize_t target = 0;
+    switch (whence)
+    {
+    case SEEK_SET:
+        target = offset;
+        break;
+    case SEEK_CUR:
+        target = pos + offset;
+        break;
+    case SEEK_END:
+    {
+        // the pending writes might extend the file
+        if (_flush_write_buffer(self))
+        {
+            return nullptr;
+        }
+        int64_t size = 0;
+        if (_file_size(self->fd, size) != 0)
+        {
+            return PyErr_SetFromErrno(PyExc_OSError);
+        }
+        target = static_cast<Py_ssize_t>(size) + offset;
+        break;
+    }
+    default:
+        PyErr_Format(PyExc_ValueError, "Invalid whence (%d, should be 0, 1 or 2).", whence);
+        return nullptr;
+    }
+    if (target < 0)
+    {
+        PyErr_Format(PyExc_OSError, "Negative seek position %zd.", target);
+        return nullptr;
+    }
+
+    const Py_ssize_t buffer_start = pos - self->read_buffer_pos;
+    if (self->read_buffer_len > 0 && target >= buffer_start && target <= buffer_start + self->read_buffer_len)
+    {
+        self->read_buffer_pos = target - buffer_start;
+        return PyLong_FromSsize_t(target);
+    }
+    if (_sync_file(self))
+    {
+        return nullptr;
+    }
+    self->pos = target;
+    return PyLong_FromSsize_t(target);
+}
+
+/**
+ * @brief Reads up to size bytes, everything that is left if size is negative.
+ */
+static PyObject *_read_bytes(EndianedFileIO *self, Py_ssize_t size)
+{
+    if (size < 0)
+    {
+        Py_ssize_t pos = 0;
+        int64_t file_size = 0;
+        if (_flush_write_buffer(self) || _tell(self, pos))
+        {
+            return nullptr;
+        }
+        if (_file_size(self->fd, file_size) != 0)
+        {
+            return PyErr_SetFromErrno(PyExc_OSError);
+        }
+        size = std::max<Py_ssize_t>(static_cast<Py_ssize_t>(file_size) - pos, 0);
+    }
+
+    PyObject *ret = PyBytes_FromStringAndSize(nullptr, size);
+    if (ret == nullptr)
+    {
+        return nullptr;
+    }
+    Py_ssize_t read_size = _read_into(self, PyBytes_AsString(ret), size);
+    if (read_size < 0)
+    {
+        Py_DecRef(ret);
+        return nullptr;
+    }
+    if (read_size != size && _PyBytes_Resize(&ret, read_size) < 0)
+    {
+        return nullptr;
+    }
+    return ret;
+}
+
+/**
+ * @brief Closes the file, flushing the pending writes first.
+ *
+ * @return true if the flush or close failed, false on success
+ */
+static bool _close_file(EndianedFileIO *self)
+{
+    if (self->fd < 0)
+    {
+        return false;
+    }
+    bool failed = _flush_write_buffer(self);
+    self->read_buffer_pos = 0;
+    self->read_buffer_len = 0;
+    if (self->closefd)
+    {
+        int result;
+        Py_BEGIN_ALLOW_THREADS
+        result = close(self->fd);
+        Py_END_ALLOW_THREADS
+        if (result != 0 && !failed)
+        {
+            PyErr_SetFromErrno(PyExc_OSError);
+            failed = true;
+        }
+    }
+    self->fd = -1;
+    return failed;
+}
+
+/**
+ * @brief Closes the file before the object is destroyed.
+ *
+ * Runs as tp_finalize like in io.FileIO, so that the object is still alive
+ * when a failed close is reported as unraisable.
+ */
+void EndianedFileIO_finalize(EndianedFileIO *self)
+{
+    if (self->fd < 0)
+    {
+        return;
+    }
+    // errors can't be raised anymore
+    SavedException exc;
+    if (_close_file(self))
+    {
+        PyErr_WriteUnraisable(reinterpret_cast<PyObject *>(self));
+    }
+    exc.restore();
+}
+
+void EndianedFileIO_dealloc(EndianedFileIO *self)
+{
+    if (PyObject_CallFinalizerFromDealloc(reinterpret_cast<PyObject *>(self)) < 0)
+    {
+        // resurrected by the finalizer
+        return;
+    }
+    Py_XDECREF(self->name);
+    delete self->read_buffer;
+    delete self->write_buffer;
+    delete self->string_cache;
+    IOLock_free(self->io_lock);
+    EndianedIOBase_free(reinterpret_cast<PyObject *>(self));
+}
+
+/**
+ * @brief Parses a FileIO mode into open flags.
+ *
+ * @return true on failure, false on success
+ */
+static bool _parse_mode(EndianedFileIO *self, const char *mode, int &flags, bool &append)
+{
+    int rwa = 0;
+    bool plus = false;
+    flags = 0;
+    append = false;
+    self->readable = false;
+    self->writable = false;
+    for (const char *c = mode; *c; ++c)
+    {
+        switch (*c)
+        {
+        case 'r':
+            rwa++;
+            self->readable = true;
+            break;
+        case 'w':
+            rwa++;
+            self->writable = true;
+            flags |= O_CREAT | O_TRUNC;
+            break;
+        case 'x':
+            rwa++;
+            self->writable = true;
+            flags |= O_CREAT | O_EXCL;
+            break;
+        case 'a':
+            rwa++;
+            self->writable = true;
+            append = true;
+            flags |= O_CREAT | O_APPEND;
+            break;
+        case '+':
+            if (plus)
+            {
+                rwa = 2;
+            }
+            plus = true;
+            self->readable = true;
+            self->writable = true;
+            break;
+        case 'b':
+            break;
+        default:
+            PyErr_Format(PyExc_ValueError, "invalid mode: %s", mode);
+            return true;
+        }
+    }
+    if (rwa != 1)
+    {
+        PyErr_SetString(PyExc_ValueError, "Must have exactly one of create/read/write/append mode and at most one plus");
+        return true;
+    }
+    flags |= (self->readable && self->writable) ? O_RDWR : (self->readable ? O_RDONLY : O_WRONLY);
+#ifdef O_BINARY
+    flags |= O_BINARY;
+#endif
+    return false;
+}
+
+int EndianedFileIO_init(EndianedFileIO *self, PyObject *args, PyObject *kwds)
+{
+    if (IOLock_init(self->io_lock))
+    {
+        return -1;
+    }
+    if (self->fd >= 0 && _close_file(self))
+    {
+        return -1;
+    }
+    self->endian = '<'; // default to little-endian
+
+    Py_buffer endian_view{};
+
+    static const char *kwlist[] = {
+        "file",
+        "mode",
+        "closefd",
+        "opener",
+        "endian",
+        "count_type",
+        "buffer_size",
+        nullptr};
+
+    // Parse arguments
+    PyObject *file = nullptr;
+    const char *mode = "r";
+    int closefd = 1;
+    PyObject *opener = Py_None;
+    PyObject *count_type = Py_None;
+    Py_ssize_t buffer_size = DEFAULT_READ_BUFFER_SIZE;
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "O|spOs*On",
+                                     const_cast<char **>(kwlist),
+                                     &file,
+                                     &mode,
+                                     &closefd,
+                                     &opener,
+                                     &endian_view,
+                                     &count_type,
+                                     &buffer_size))
+    {
+        return -1;
+    }
+
+    // parse endian argument
+    if (endian_view.buf != nullptr)
+    {
+        char *buf_ptr = static_cast<char *>(endian_view.buf);
+        bool valid = endian_view.len == 1 && (buf_ptr[0] == '<' || buf_ptr[0] == '>');
+        if (valid)
+        {
+            self->endian = buf_ptr[0];
+        }
+        PyBuffer_Release(&endian_view);
+        if (!valid)
+        {
+            PyErr_SetString(PyExc_ValueError, "Endian must be '<' or '>'.");
+            return -1;
+        }
+    }
+    if (buffer_size < 0)
+    {
+        PyErr_SetString(PyExc_ValueError, "buffer_size must be non-negative.");
+        return -1;
+    }
+    if (CountType_FromObject(count_type, self->count_type) < 0)
+    {
+        return -1;
+    }
+
+    int flags = 0;
+    bool append = false;
+    if (_parse_mode(self, mode, flags, append))
+    {
+        return -1;
+    }
+
+    int fd = -1;
+    if (PyLong_Check(file))
+    {
+        fd = long_as_int(file);
+        if (fd == -1 && PyErr_Occurred())
+        {
+            return -1;
+        }
+        if (fd < 0)
+        {
+            PyErr_SetString(PyExc_ValueError, "negative file descriptor");
+            return -1;
+        }
+    }
+    else
+    {
+        if (!closefd)
+        {
+            PyErr_SetString(PyExc_ValueError, "Cannot use closefd=False with file name");
+            return -1;
+        }
+        // os.open handles path-like objects, non-inheritable descriptors and the platform specifics
+        PyObject *py_fd = nullptr;
+        if (opener == Py_None)
+        {
+            PyObject *os = PyImport_ImportModule("os");
+            if (os == nullptr)
+            {
+                return -1;
+            }
+            py_fd = PyObject_CallMethod(os, "open", "Oii", file, flags, 0666);
+            Py_DecRef(os);
+        }
+        else
+        {
+            py_fd = PyObject_CallFunction(opener, "Oi", file, flags);
+        }
+        if (py_fd == nullptr)
+        {
+            return -1;
+        }
+        fd = long_as_int(py_fd);
+        Py_DecRef(py_fd);
+        if (fd == -1 && PyErr_Occurred())
+        {
+            return -1;
+        }
+        if (fd < 0)
+        {
+            PyErr_Format(PyExc_ValueError, "opener returned %d", fd);
+            return -1;
+        }
+    }
+
+    self->fd = fd;
+    self->closefd = closefd;
+    self->append = append;
+    Py_IncRef(file);
+    Py_XDECREF(self->name);
+    self->name = file;
+
+    // start at the offset of the descriptor, or at the end when appending
+    self->pos = 0;
+    if (append)
+    {
+        if (_seek_end(self))
+        {
+            return -1;
+        }
+    }
+    else
+    {
+#ifdef _WIN32
+        int64_t offset = _lseeki64(fd, 0, SEEK_CUR);
+#else
+        int64_t offset = lseek(fd, 0, SEEK_CUR);
+#endif
+        self->pos = std::max<int64_t>(offset, 0);
+    }
+
+    self->buffer_size = buffer_size;
+    delete self->read_buffer;
+    delete self->write_buffer;
+    self->read_buffer = nullptr;
+    self->write_buffer = nullptr;
+    self->read_buffer_pos = 0;
+    self->read_buffer_len = 0;
+    if (buffer_size > 0)
+    {
+        self->read_buffer = new std::vector<char>(buffer_size);
+        self->write_buffer = new std::vector<char>();
+        self->write_buffer->reserve(buffer_size);
+    }
+    return 0;
+};
+
+static PyObject *EndianedFileIO_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
+{
+    EndianedFileIO *self = reinterpret_cast<EndianedFileIO *>(PyType_GenericNew(type, args, kwds));
+    if (self != nullptr)
+    {
+        self->fd = -1;
+    }
+    return reinterpret_cast<PyObject *>(self);
+}
+
+PyMemberDef EndianedFileIO_members[] = {
+    {"endian", T_CHAR, offsetof(EndianedFileIO, endian), 0, "endian"},
+    {"name", T_OBJECT, offsetof(EndianedFileIO, name), READONLY, "The file name or descriptor passed to the constructor."},
+    {"buffer_size", T_PYSSIZET, offsetof(EndianedFileIO, buffer_size), READONLY, "The size of the read-ahead and write buffers, 0 if disabled."},
+    {NULL} /* Sentinel */
+};
+
+PyObject *EndianedFileIO_get_closed(EndianedFileIO *self, void *closure)
+{
+    return PyBool_FromLong(self->fd < 0);
+}
+
+PyObject *EndianedFileIO_get_closefd(EndianedFileIO *self, void *closure)
+{
+    return PyBool_FromLong(self->closefd);
+}
+
+PyObject *EndianedFileIO_get_count_type(EndianedFileIO *self, void *closure)
+{
+    return CountType_AsObject(self->count_type);
+}
+
+int EndianedFileIO_set_count_type(EndianedFileIO *self, PyObject *value, void *closure)
+{
+    return CountType_FromObject(value, self->count_type);
+}
+
+PyGetSetDef EndianedFileIO_getseters[] = {
+    {"closed", (getter)LOCKED(EndianedFileIO_get_closed), nullptr, "closed", nullptr},
+    {"closefd", (getter)LOCKED(EndianedFileIO_get_closefd), nullptr, "Whether the file descriptor is closed with the object.", nullptr},
+    {"count_type", (getter)LOCKED(EndianedFileIO_get_count_type), (setter)LOCKED(EndianedFileIO_set_count_type), "The encoding of length prefixes, None uses read_count/write_count.", nullptr},
+    {nullptr} /* Sentinel */
+};
+
+
+static PyObject *EndianedFileIO_read(EndianedFileIO *self, PyObject *args)
+{
+    Py_ssize_t size = -1;
+    PyObject *py_size = Py_None;
+    if (!PyArg_ParseTuple(args, "|O", &py_size))
+    {
+        return nullptr;
+    }
+    if (py_size != Py_None)
+    {
+        size = PyLong_AsSsize_t(py_size);
+        if (size == -1 && PyErr_Occurred())
+        {
+            return nullptr;
+        }
+    }
+    return _read_bytes(self, size);
+}
+
+static PyObject *EndianedFileIO_readinto(EndianedFileIO *self, PyObject *arg)
+{
+    Py_buffer view{};
+    if (PyObject_GetBuffer(arg, &view, PyBUF_WRITABLE) != 0)
+    {
+        return nullptr;
+    }
+    Py_ssize_t read_size = _read_into(self, static_cast<char *>(view.buf), view.len);
+    PyBuffer_Release(&view);
+    if (read_size < 0)
+    {
+        return nullptr;
+    }
+    return PyLong_FromSsize_t(read_size);
+}
+
+static PyObject *EndianedFileIO_tell(EndianedFileIO *self, PyObject *unused)
+{
+    Py_ssize_t pos = 0;
+    if (_tell(self, pos))
+    {
+        return nullptr;
+    }
+    return PyLong_FromSsize_t(pos);
+}
+
+static PyObject *EndianedFileIO_seek(EndianedFileIO *self, PyObject *args)
+{
+    Py_ssize_t offset = 0;
+    int whence = SEEK_SET;
+    if (!PyArg_ParseTuple(args, "n|i", &offset, &whence))
+    {
+        return nullptr;
+    }
+    return _seek(self, offset, whence);
+}
+
+static PyObject *EndianedFileIO_write(EndianedFileIO *self, PyObject *arg)
+{
+    Py_buffer view{};
+    if (PyObject_GetBuffer(arg, &view, PyBUF_SIMPLE) != 0)
+    {
+        return nullptr;
+    }
+    bool failed = _write_raw(self, view.buf, view.len);
+    PyBuffer_Release(&view);
+    if (failed)
+    {
+        return nullptr;
+    }
+    return PyLong_FromSsize_t(view.len);
+}
+
+static PyObject *EndianedFileIO_flush(EndianedFileIO *self, PyObject *unused)
+{
+    CHECK_FILE_OPEN(nullptr)
+    if (_flush_write_buffer(self))
+    {
+        return nullptr;
+    }
+    Py_RETURN_NONE;
+}
+
+static PyObject *EndianedFileIO_close(EndianedFileIO *self, PyObject *unused)
+{
+    if (_close_file(self))
+    {
+        return nullptr;
+    }
+    Py_RETURN_NONE;
+}
+
+static PyObject *EndianedFileIO_truncate(EndianedFileIO *self, PyObject *args)
+{
+    PyObject *py_size = Py_None;
+    if (!PyArg_ParseTuple(args, "|O", &py_size))
+    {
+        return nullptr;
+    }
+    Py_ssize_t size = 0;
+    if (_tell(self, size) || _sync_file(self))
+    {
+        return nullptr;
+    }
+    if (py_size != Py_None)
+    {
+        size = PyLong_AsSsize_t(py_size);
+        if (size == -1 && PyErr_Occurred())
+        {
+            return nullptr;
+        }
+    }
+    int result;
+    Py_BEGIN_ALLOW_THREADS
+    result = ftruncate(self->fd, size);
+    Py_END_ALLOW_THREADS
+    if (result != 0)
+    {
+        return PyErr_SetFromErrno(PyExc_OSError);
+    }
+    return PyLong_FromSsize_t(size);
+}
+
+static PyObject *EndianedFileIO_fileno(EndianedFileIO *self, PyObject *unused)
+{
+    CHECK_FILE_OPEN(nullptr)
+    return PyLong_FromLong(self->fd);
+}
+
+static PyObject *EndianedFileIO_readable(EndianedFileIO *self, PyObject *unused)
+{
+    CHECK_FILE_OPEN(nullptr)
+    return PyBool_FromLong(self->readable);
+}
+
+static PyObject *EndianedFileIO_writable(EndianedFileIO *self, PyObject *unused)
+{
+    CHECK_FILE_OPEN(nullptr)
+    return PyBool_FromLong(self->writable);
+}
+
+static PyObject *EndianedFileIO_seekable(EndianedFileIO *self, PyObject *unused)
+{
+    CHECK_FILE_OPEN(nullptr)
+    Py_RETURN_TRUE;
+}
+
+static PyObject *EndianedFileIO_isatty(EndianedFileIO *self, PyObject *unused)
+{
+    CHECK_FILE_OPEN(nullptr)
+    int result;
+    Py_BEGIN_ALLOW_THREADS
+    result = isatty(self->fd);
+    Py_END_ALLOW_THREADS
+    return PyBool_FromLong(result);
+}
+
+GENERATE_ENDIANEDIOBASE_BUFFERED_METHODS(EndianedFileIO);
+
+static PyObject *EndianedFileIO_read_schema(EndianedFileIO *self, PyObject *arg)
+{
+    SchemaObject *schema = Schema_FromObject(arg);
+    if (schema == nullptr)
+    {
+        return nullptr;
+    }
+    return Schema_read<EndianedFileIO, _read_raw>(self, schema);
+}
+
+static PyObject *EndianedFileIO_write_schema(EndianedFileIO *self, PyObject *args)
+{
+    PyObject *py_schema = nullptr;
+    PyObject *value = nullptr;
+    if (!PyArg_ParseTuple(args, "OO", &py_schema, &value))
+    {
+        return nullptr;
+    }
+    SchemaObject *schema = Schema_FromObject(py_schema);
+    if (schema == nullptr)
+    {
+        return nullptr;
+    }
+    return Schema_write<EndianedFileIO, _write_raw>(self, schema, value);
+}
+
+// the position hooks of the read_*_at functions
+static inline bool EndianedFileIO_get_pos(EndianedFileIO *self, Py_ssize_t &pos)
+{
+    return _tell(self, pos);
+}
+
+static inline bool EndianedFileIO_set_pos(EndianedFileIO *self, Py_ssize_t pos)
+{
+    PyObject *ret = _seek(self, pos, SEEK_SET);
+    Py_XDECREF(ret);
+    return ret == nullptr;
+}
+
+// the IOLock keeps other calls out while these have the position at the offset
+GENERATE_ENDIANEDIOBASE_SEEKING_AT_METHODS(EndianedFileIO);
+
+static PyObject *EndianedFileIO_read_cstring_table(EndianedFileIO *self, PyObject *args, PyObject *kwds)
+{
+    return EndianedIOBase_read_cstring_table<EndianedFileIO, EndianedFileIO_get_pos, EndianedFileIO_set_pos, EndianedIOBase_read_cstring_raw<EndianedFileIO, _read_into>>(self, args, kwds);
+}
+
+PyMethodDef EndianedFileIO_methods[] = {
+    GENERATE_ENDIANEDIOBASE_READ_FUNCTIONS(EndianedFileIO),
+    GENERATE_ENDIANEDIOBASE_READ_AT_FUNCTIONS(EndianedFileIO),
+    GENERATE_ENDIANEDIOBASE_WRITE_FUNCTIONS(EndianedFileIO),
+    {"read",
+     (PyCFunction)LOCKED(EndianedFileIO_read),
+     METH_VARARGS,
+     "Read up to size bytes, everything that is left if size is omitted or negative."},
+    {"readinto",
+     (PyCFunction)LOCKED(EndianedFileIO_readinto),
+     METH_O,
+     "Read bytes into a writable buffer."},
+    {"seek",
+     (PyCFunction)LOCKED(EndianedFileIO_seek),
+     METH_VARARGS,
+     "Seek to a position in the file."},
+    {"tell",
+     (PyCFunction)LOCKED(EndianedFileIO_tell),
+     METH_NOARGS,
+     "Get the current position in the file."},
+    {"write",
+     (PyCFunction)LOCKED(EndianedFileIO_write),
+     METH_O,
+     "Write bytes to the file."},
+    {"flush",
+     (PyCFunction)LOCKED(EndianedFileIO_flush),
+     METH_NOARGS,
+     "Write the buffered data to the file."},
+    {"close",
+     (PyCFunction)LOCKED(EndianedFileIO_close),
+     METH_NOARGS,
+     "Flush the buffered data and close the file."},
+    {"truncate",
+     (PyCFunction)LOCKED(EndianedFileIO_truncate),
+     METH_VARARGS,
+     "Truncate the file to size bytes, the current position if size is omitted."},
+    {"fileno",
+     (PyCFunction)LOCKED(EndianedFileIO_fileno),
+     METH_NOARGS,
+     "Get the file descriptor."},
+    {"readable",
+     (PyCFunction)LOCKED(EndianedFileIO_readable),
+     METH_NOARGS,
+     "Check if the file was opened for reading."},
+    {"writable",
+     (PyCFunction)LOCKED(EndianedFileIO_writable),
+     METH_NOARGS,
+     "Check if the file was opened for writing."},
+    {"seekable",
+     (PyCFunction)LOCKED(EndianedFileIO_seekable),
+     METH_NOARGS,
+     "Check if the file is seekable."},
+    {"isatty",
+     (PyCFunction)LOCKED(EndianedFileIO_isatty),
+     METH_NOARGS,
+     "Check if the file is a TTY."},
+    {"align",
+     (PyCFunction)LOCKED(EndianedFileIO_align),
+     METH_O,
+     "Align the file position to the specified size."},
+    {"read_view",
+     (PyCFunction)LOCKED(EndianedFileIO_read_view),
+     METH_O,
+     "Read bytes as a memoryview."},
+    {"read_struct",
+     (PyCFunction)LOCKED(EndianedFileIO_read_struct),
+     METH_O,
+     "Read a record of a compiled struct format."},
+    {"read_struct_array",
+     (PyCFunction)LOCKED(EndianedFileIO_read_struct_array),
+     METH_VARARGS | METH_KEYWORDS,
+     "Read a list of records of a compiled struct format."},
+    {"write_struct",
+     (PyCFunction)LOCKED(EndianedFileIO_write_struct),
+     METH_VARARGS,
+     "Write a record of a compiled struct format."},
+    {"write_struct_array",
+     (PyCFunction)LOCKED(EndianedFileIO_write_struct_array),
+     METH_VARARGS | METH_KEYWORDS,
+     "Write a list of records of a compiled struct format."},
+    {"read_schema",
+     (PyCFunction)LOCKED(EndianedFileIO_read_schema),
+     METH_O,
+     "Read an object with a lowered serialization schema."},
+    {"write_schema",
+     (PyCFunction)LOCKED(EndianedFileIO_write_schema),
+     METH_VARARGS,
+     "Write an object with a lowered serialization schema."},
+    {"read_count",
+     (PyCFunction)LOCKED(EndianedFileIO_read_count),
+     METH_NOARGS,
+     "Read a length prefix as configured by count_type."},
+    {"write_count",
+     (PyCFunction)LOCKED(EndianedFileIO_write_count),
+     METH_O,
+     "Write a length prefix as configured by count_type."},
+    {NULL} /* Sentinel */
+};
+
+PyObject *EndianedFileIO_repr(PyObject *self)
+{
+    EndianedFileIO *node = (EndianedFileIO *)self;
+    if (node->name == nullptr)
+    {
+        return PyUnicode_FromFormat("<EndianedFileIO endian='%c' [closed]>", node->endian);
+    }
+    return PyUnicode_FromFormat(
+        "<EndianedFileIO endian='%c' name=%R fd=%d>",
+        node->endian,
+        node->name,
+        node->fd);
+}
+
+PyType_Slot EndianedFileIO_slots[] = {
+    {Py_tp_new, reinterpret_cast<void *>(EndianedFileIO_new)},
+    {Py_tp_init, reinterpret_cast<void *>(EndianedFileIO_init)},
+    {Py_tp_dealloc, reinterpret_cast<void *>(EndianedFileIO_dealloc)},
+    {Py_tp_finalize, reinterpret_cast<void *>(EndianedFileIO_finalize)},
+    {Py_tp_members, EndianedFileIO_members},
+    {Py_tp_getset, EndianedFileIO_getseters},
+    {Py_tp_methods, EndianedFileIO_methods},
+    {Py_tp_repr, reinterpret_cast<void *>(LOCKED(EndianedFileIO_repr))},
+    {0, NULL},
+};
+
+PyType_Spec EndianedFileIO_Spec = {
+    "bier.endianedbinaryio.C.EndianedFileIO.EndianedFileIO", // const char* name;
+    sizeof(EndianedFileIO),                                  // int basicsize;
+    0,                                                       // int itemsize;
+    Py_TPFLAGS_DEFAULT | Py_TPFLAGS_BASETYPE,                // unsigned int flags;
+    EndianedFileIO_slots,                                    // PyType_Slot *slots;
+};
+
+static PyModuleDef EndianedFileIO_module = {
+    PyModuleDef_HEAD_INIT,
+    "bier.endianedbinaryio.C.EndianedFileIO", // Module name
+    "",
+    -1,   // Optional size of the module state memory
+    NULL, // Optional table of module-level functions
+    NULL, // Optional slot definitions
+    NULL, // Optional traversal function
+    NULL, // Optional clear function
+    NULL  // Optional module deallocation function
+};
+
+int add_object(PyObject *module, const char *name, PyObject *object)
+{
+    Py_IncRef(object);
+    if (PyModule_AddObject(module, name, object) < 0)
+    {
+        Py_DecRef(object);
+        Py_DecRef(module);
+        return -1;
+    }
+    return 0;
+}
+
+PyMODINIT_FUNC PyInit_EndianedFileIO(void)
+{
+    PyObject *m = PyModule_Create(&EndianedFileIO_module);
+    if (m == NULL)
+    {
+        return NULL;
+    }
+    module_set_gil_not_used(m);
+    if (StructFormat_import() < 0 || Schema_import() < 0)
+    {
+        Py_DecRef(m);
+        return NULL;
+    }
+    PyObject *io = PyImport_ImportModule("io");
+    if (io == nullptr)
+    {
+        Py_DecRef(m);
+        return NULL;
+    }
+    UnsupportedOperation = PyObject_GetAttrString(io, "UnsupportedOperation");
+    Py_DecRef(io);
+    if (UnsupportedOperation == nullptr)
+    {
+        Py_DecRef(m);
+        return NULL;
+    }
+    EndianedFileIO_OT = PyType_FromSpec(&EndianedFileIO_Spec);
+    if (add_object(m, "EndianedFileIO", EndianedFileIO_OT) < 0)
+    {
+        return NULL;
+    }
+    return m;
+}
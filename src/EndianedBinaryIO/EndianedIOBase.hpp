@@ -1,5 +1,14 @@
 #pragma once
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <new>
+#include <string>
+#include <string_view>
+#include <vector>
 #include "PyConverter.hpp"
+#include "ByteSearch.hpp"
+#include "StructFormat.hpp"
 
 #define u8 uint8_t
 #define u16 uint16_t
@@ -35,83 +44,411 @@
         return nullptr;                                                           \
     }
 
-#define _GENERATE_ENDIANEDIOBASE_READ_FUNCTIONS_TYPE(EndianedIOClass, T)                                                                 \
-    {"read_" #T, reinterpret_cast<PyCFunction>(EndianedIOClass##_read_t<T, '|'>), METH_NOARGS, "Read a " #T " value."},                  \
-        {"read_" #T "_le", reinterpret_cast<PyCFunction>(EndianedIOClass##_read_t<T, '<'>), METH_NOARGS, "Read a " #T " value."},        \
-        {"read_" #T "_be", reinterpret_cast<PyCFunction>(EndianedIOClass##_read_t<T, '>'>), METH_NOARGS, "Read a " #T " value."},        \
-        {"read_" #T "_array", reinterpret_cast<PyCFunction>(EndianedIOClass##_read_array_t<T, '|'>), METH_O, "Read a " #T " array."},    \
-        {"read_" #T "_le_array", reinterpret_cast<PyCFunction>(EndianedIOClass##_read_array_t<T, '<'>), METH_O, "Read a " #T " array."}, \
-        {"read_" #T "_be_array", reinterpret_cast<PyCFunction>(EndianedIOClass##_read_array_t<T, '>'>), METH_O, "Read a " #T " array."}
-
-#define GENERATE_ENDIANEDIOBASE_READ_FUNCTIONS(EndianedIOClass)                                                                                         \
-    {"read_bool", reinterpret_cast<PyCFunction>(EndianedIOClass##_read_t<bool, '|'>), METH_NOARGS, "Read a bool value."},                               \
-        {"read_bool_array", reinterpret_cast<PyCFunction>(EndianedIOClass##_read_array_t<bool, '|'>), METH_O, "Read a bool array."},                    \
-        {"read_u8", reinterpret_cast<PyCFunction>(EndianedIOClass##_read_t<u8, '|'>), METH_NOARGS, "Read a u8 value."},                                 \
-        {"read_u8_array", reinterpret_cast<PyCFunction>(EndianedIOClass##_read_array_t<u8, '|'>), METH_O, "Read a u8 array."},                          \
-        {"read_i8", reinterpret_cast<PyCFunction>(EndianedIOClass##_read_t<i8, '|'>), METH_NOARGS, "Read an i8 value."},                                \
-        {"read_i8_array", reinterpret_cast<PyCFunction>(EndianedIOClass##_read_array_t<i8, '|'>), METH_O, "Read a i8 array."},                          \
-        _GENERATE_ENDIANEDIOBASE_READ_FUNCTIONS_TYPE(EndianedIOClass, u16),                                                                             \
-        _GENERATE_ENDIANEDIOBASE_READ_FUNCTIONS_TYPE(EndianedIOClass, u32),                                                                             \
-        _GENERATE_ENDIANEDIOBASE_READ_FUNCTIONS_TYPE(EndianedIOClass, u64),                                                                             \
-        _GENERATE_ENDIANEDIOBASE_READ_FUNCTIONS_TYPE(EndianedIOClass, i16),                                                                             \
-        _GENERATE_ENDIANEDIOBASE_READ_FUNCTIONS_TYPE(EndianedIOClass, i32),                                                                             \
-        _GENERATE_ENDIANEDIOBASE_READ_FUNCTIONS_TYPE(EndianedIOClass, i64),                                                                             \
-        _GENERATE_ENDIANEDIOBASE_READ_FUNCTIONS_TYPE(EndianedIOClass, f16),                                                                             \
-        _GENERATE_ENDIANEDIOBASE_READ_FUNCTIONS_TYPE(EndianedIOClass, f32),                                                                             \
-        _GENERATE_ENDIANEDIOBASE_READ_FUNCTIONS_TYPE(EndianedIOClass, f64),                                                                             \
-        {"read_cstring", reinterpret_cast<PyCFunction>(EndianedIOClass##_read_cstring), METH_VARARGS | METH_KEYWORDS, "Read until a null terminator."}, \
-        {"read_string", reinterpret_cast<PyCFunction>(EndianedIOClass##_read_string), METH_VARARGS | METH_KEYWORDS, "Read a string."},                  \
-        {"read_bytes", reinterpret_cast<PyCFunction>(EndianedIOClass##_read_bytes), METH_O, "Read a byte array."},                                      \
-        {"read_varint", reinterpret_cast<PyCFunction>(EndianedIOClass##_read_varint), METH_NOARGS, "Read a variable-length integer."},                  \
-        {"read_varint_array", reinterpret_cast<PyCFunction>(EndianedIOClass##_read_varint_array), METH_O, "Read a variable-length integer array."}
-
-#define GENERATE_ENDIANEDIOBASE_BASE_FUNCTIONS(EndianedIOClass)                                                                          \
-    {"read", reinterpret_cast<PyCFunction>(EndianedIOClass##_read), METH_O, "Read bytes from the buffer."},                              \
-        {"readinto", reinterpret_cast<PyCFunction>(EndianedIOClass##_readinto), METH_O, "Read bytes into a buffer."},                    \
-        {"seek", reinterpret_cast<PyCFunction>(EndianedIOClass##_seek), METH_VARARGS, "Seek to a position in the buffer."},              \
-        {"tell", reinterpret_cast<PyCFunction>(EndianedIOClass##_tell), METH_NOARGS, "Get the current position in the buffer."},         \
-        {"flush", reinterpret_cast<PyCFunction>(EndianedIOClass##_flush), METH_NOARGS, "Flush the buffer."},                             \
-        {"fileno", reinterpret_cast<PyCFunction>(EndianedIOClass##_fileno), METH_NOARGS, "Get the file descriptor."},                    \
-        {"isatty", reinterpret_cast<PyCFunction>(EndianedIOClass##_isatty), METH_NOARGS, "Check if the buffer is a TTY."},               \
-        {"close", reinterpret_cast<PyCFunction>(EndianedIOClass##_close), METH_NOARGS, "Close the buffer."},                             \
-        {"readable", reinterpret_cast<PyCFunction>(EndianedIOClass##_readable), METH_NOARGS, "Check if the buffer is readable."},        \
-        {"writable", reinterpret_cast<PyCFunction>(EndianedIOClass##_writable), METH_NOARGS, "Check if the buffer is writable."},        \
-        {"seekable", reinterpret_cast<PyCFunction>(EndianedIOClass##_seekable), METH_NOARGS, "Check if the buffer is seekable."},        \
-        {"readline", reinterpret_cast<PyCFunction>(EndianedIOClass##_readline), METH_VARARGS, "Read a line from the buffer."},           \
-        {"readlines", reinterpret_cast<PyCFunction>(EndianedIOClass##_readlines), METH_VARARGS, "Read multiple lines from the buffer."}, \
-        {"align", reinterpret_cast<PyCFunction>(EndianedIOClass##_align), METH_O, "Align the position of the buffer."},                  \
-        {"write", reinterpret_cast<PyCFunction>(EndianedIOClass##_write), METH_O, "Write bytes to the buffer."},                         \
-        {"writelines", reinterpret_cast<PyCFunction>(EndianedIOClass##_writelines), METH_O, "Write multiple lines to the buffer."}
-
-#define _GENERATE_ENDIANEDIOBASE_WRITE_FUNCTIONS_TYPE(EndianedIOClass, T)                                                                                         \
-    {"write_" #T, reinterpret_cast<PyCFunction>(EndianedIOClass##_write_t<T, '|'>), METH_O, "Write a " #T " value."},                                             \
-        {"write_" #T "_le", reinterpret_cast<PyCFunction>(EndianedIOClass##_write_t<T, '<'>), METH_O, "Write a " #T " value."},                                   \
-        {"write_" #T "_be", reinterpret_cast<PyCFunction>(EndianedIOClass##_write_t<T, '>'>), METH_O, "Write a " #T " value."},                                   \
-        {"write_" #T "_array", reinterpret_cast<PyCFunction>(EndianedIOClass##_write_array_t<T, '|'>), METH_VARARGS | METH_KEYWORDS, "Write a " #T " array."},    \
-        {"write_" #T "_le_array", reinterpret_cast<PyCFunction>(EndianedIOClass##_write_array_t<T, '<'>), METH_VARARGS | METH_KEYWORDS, "Write a " #T " array."}, \
-        {"write_" #T "_be_array", reinterpret_cast<PyCFunction>(EndianedIOClass##_write_array_t<T, '>'>), METH_VARARGS | METH_KEYWORDS, "Write a " #T " array."}
-
-#define GENERATE_ENDIANEDIOBASE_WRITE_FUNCTIONS(EndianedIOClass)                                                                                              \
-    {"write_bool", reinterpret_cast<PyCFunction>(EndianedIOClass##_write_t<bool, '|'>), METH_O, "Write a bool value."},                                       \
-        {"write_bool_array", reinterpret_cast<PyCFunction>(EndianedIOClass##_write_array_t<bool, '|'>), METH_VARARGS | METH_KEYWORDS, "Write a bool array."}, \
-        {"write_u8", reinterpret_cast<PyCFunction>(EndianedIOClass##_write_t<u8, '|'>), METH_O, "Write a u8 value."},                                         \
-        {"write_u8_array", reinterpret_cast<PyCFunction>(EndianedIOClass##_write_array_t<u8, '|'>), METH_VARARGS | METH_KEYWORDS, "Write a u8 array."},       \
-        {"write_i8", reinterpret_cast<PyCFunction>(EndianedIOClass##_write_t<i8, '|'>), METH_O, "Write an i8 value."},                                        \
-        {"write_i8_array", reinterpret_cast<PyCFunction>(EndianedIOClass##_write_array_t<i8, '|'>), METH_VARARGS | METH_KEYWORDS, "Write a i8 array."},       \
-        _GENERATE_ENDIANEDIOBASE_WRITE_FUNCTIONS_TYPE(EndianedIOClass, u16),                                                                                  \
-        _GENERATE_ENDIANEDIOBASE_WRITE_FUNCTIONS_TYPE(EndianedIOClass, u32),                                                                                  \
-        _GENERATE_ENDIANEDIOBASE_WRITE_FUNCTIONS_TYPE(EndianedIOClass, u64),                                                                                  \
-        _GENERATE_ENDIANEDIOBASE_WRITE_FUNCTIONS_TYPE(EndianedIOClass, i16),                                                                                  \
-        _GENERATE_ENDIANEDIOBASE_WRITE_FUNCTIONS_TYPE(EndianedIOClass, i32),                                                                                  \
-        _GENERATE_ENDIANEDIOBASE_WRITE_FUNCTIONS_TYPE(EndianedIOClass, i64),                                                                                  \
-        _GENERATE_ENDIANEDIOBASE_WRITE_FUNCTIONS_TYPE(EndianedIOClass, f16),                                                                                  \
-        _GENERATE_ENDIANEDIOBASE_WRITE_FUNCTIONS_TYPE(EndianedIOClass, f32),                                                                                  \
-        _GENERATE_ENDIANEDIOBASE_WRITE_FUNCTIONS_TYPE(EndianedIOClass, f64),                                                                                  \
-        {"write_cstring", reinterpret_cast<PyCFunction>(EndianedIOClass##_write_cstring), METH_VARARGS | METH_KEYWORDS, "Write a C-style string."},           \
-        {"write_string", reinterpret_cast<PyCFunction>(EndianedIOClass##_write_string), METH_VARARGS | METH_KEYWORDS, "Write a string."},                     \
-        {"write_bytes", reinterpret_cast<PyCFunction>(EndianedIOClass##_write_bytes), METH_O, "Write a byte array."},                                         \
-        {"write_varint", reinterpret_cast<PyCFunction>(EndianedIOClass##_write_varint), METH_O, "Write a variable-length integer."},                          \
-        {"write_varint_array", reinterpret_cast<PyCFunction>(EndianedIOClass##_write_varint_array), METH_VARARGS | METH_KEYWORDS, "Write a variable-length integer array."}
+/**
+ * @brief Per-object lock of the buffered backends, which release the GIL while their buffers and position are in flux.
+ *
+ * Like the lock of io.BufferedReader, it's held for a whole call and waiting for it releases the GIL.
+ * Nested calls on the same thread, e.g. through an overridden read_count, pass through.
+ */
+struct IOLock
+{
+    PyThread_type_lock lock; // nullptr until the object is initialized
+    unsigned long owner;     // thread ident of the holder, 0 if free
+    Py_ssize_t depth;        // nesting depth of the holder
+};
+
+/**
+ * @brief Allocates the lock, the object memory starts zeroed.
+ *
+ * @return true on failure, false on success
+ */
+static inline bool IOLock_init(IOLock &lock)
+{
+    if (lock.lock == nullptr)
+    {
+        lock.lock = PyThread_allocate_lock();
+        if (lock.lock == nullptr)
+        {
+            PyErr_NoMemory();
+            return true;
+        }
+    }
+    return false;
+}
+
+static inline void IOLock_free(IOLock &lock)
+{
+    if (lock.lock != nullptr)
+    {
+        PyThread_free_lock(lock.lock);
+        lock.lock = nullptr;
+    }
+}
+
+/**
+ * @brief Holds the IOLock of self for its lifetime, does nothing for types without one.
+ */
+template <typename Self>
+class IOLockGuard
+{
+public:
+    explicit IOLockGuard(Self *self)
+    {
+        if constexpr (requires { self->io_lock; })
+        {
+            IOLock &io_lock = self->io_lock;
+            if (io_lock.lock == nullptr)
+            {
+                return;
+            }
+            const unsigned long ident = PyThread_get_thread_ident();
+            // only the holder itself can find its own ident here
+            if (std::atomic_ref<unsigned long>(io_lock.owner).load(std::memory_order_relaxed) != ident)
+            {
+                if (!PyThread_acquire_lock(io_lock.lock, NOWAIT_LOCK))
+                {
+                    Py_BEGIN_ALLOW_THREADS
+                    PyThread_acquire_lock(io_lock.lock, WAIT_LOCK);
+                    Py_END_ALLOW_THREADS
+                }
+                std::atomic_ref<unsigned long>(io_lock.owner).store(ident, std::memory_order_relaxed);
+            }
+            io_lock.depth++;
+            held = &io_lock;
+        }
+    }
+
+    ~IOLockGuard()
+    {
+        if (held != nullptr && --held->depth == 0)
+        {
+            std::atomic_ref<unsigned long>(held->owner).store(0, std::memory_order_relaxed);
+            PyThread_release_lock(held->lock);
+        }
+    }
+
+    IOLockGuard(const IOLockGuard &) = delete;
+    IOLockGuard &operator=(const IOLockGuard &) = delete;
+
+private:
+    IOLock *held = nullptr;
+};
+
+/**
+ * @brief Calls fn with the IOLock of self held, if its type has one.
+ *
+ * Without the GIL, calls on the same object could otherwise race on pos and the buffers,
+ * so fn runs within a critical section of self there.
+ * Like the GIL, the critical section is suspended while the thread blocks,
+ * e.g. in nested calls on the same object, so it can't deadlock.
+ */
+template <auto fn>
+struct Locked;
+
+template <typename R, typename Self, typename... Args, R (*fn)(Self *, Args...)>
+struct Locked<fn>
+{
+    static R call(Self *self, Args... args)
+    {
+        IOLockGuard<Self> io_guard(self);
+#ifdef Py_GIL_DISABLED
+        if constexpr (std::is_void_v<R>)
+        {
+            Py_BEGIN_CRITICAL_SECTION(self);
+            fn(self, args...);
+            Py_END_CRITICAL_SECTION();
+        }
+        else
+        {
+            R ret;
+            Py_BEGIN_CRITICAL_SECTION(self);
+            ret = fn(self, args...);
+            Py_END_CRITICAL_SECTION();
+            return ret;
+        }
+#else
+        return fn(self, args...);
+#endif
+    }
+};
+
+#define LOCKED(...) (Locked<__VA_ARGS__>::call)
+
+#define _GENERATE_ENDIANEDIOBASE_READ_FUNCTIONS_TYPE(EndianedIOClass, T)                                                                                                                       \
+    {"read_" #T, reinterpret_cast<PyCFunction>(LOCKED(EndianedIOClass##_read_t<T, '|'>)), METH_NOARGS, "Read a " #T " value."},                                                                \
+        {"read_" #T "_le", reinterpret_cast<PyCFunction>(LOCKED(EndianedIOClass##_read_t<T, '<'>)), METH_NOARGS, "Read a " #T " value."},                                                      \
+        {"read_" #T "_be", reinterpret_cast<PyCFunction>(LOCKED(EndianedIOClass##_read_t<T, '>'>)), METH_NOARGS, "Read a " #T " value."},                                                      \
+        {"read_" #T "_array", reinterpret_cast<PyCFunction>(LOCKED(EndianedIOClass##_read_array_t<T, '|'>)), METH_VARARGS | METH_KEYWORDS, "Read a " #T " array."},                            \
+        {"read_" #T "_le_array", reinterpret_cast<PyCFunction>(LOCKED(EndianedIOClass##_read_array_t<T, '<'>)), METH_VARARGS | METH_KEYWORDS, "Read a " #T " array."},                         \
+        {"read_" #T "_be_array", reinterpret_cast<PyCFunction>(LOCKED(EndianedIOClass##_read_array_t<T, '>'>)), METH_VARARGS | METH_KEYWORDS, "Read a " #T " array."},                         \
+        {"read_" #T "_array_into", reinterpret_cast<PyCFunction>(LOCKED(EndianedIOClass##_read_array_into_t<T, '|'>)), METH_VARARGS | METH_KEYWORDS, "Read a " #T " array into a buffer."},    \
+        {"read_" #T "_le_array_into", reinterpret_cast<PyCFunction>(LOCKED(EndianedIOClass##_read_array_into_t<T, '<'>)), METH_VARARGS | METH_KEYWORDS, "Read a " #T " array into a buffer."}, \
+        {"read_" #T "_be_array_into", reinterpret_cast<PyCFunction>(LOCKED(EndianedIOClass##_read_array_into_t<T, '>'>)), METH_VARARGS | METH_KEYWORDS, "Read a " #T " array into a buffer."}
+
+#define GENERATE_ENDIANEDIOBASE_READ_FUNCTIONS(EndianedIOClass)                                                                                                                            \
+    {"read_bool", reinterpret_cast<PyCFunction>(LOCKED(EndianedIOClass##_read_t<bool, '|'>)), METH_NOARGS, "Read a bool value."},                                                          \
+        {"read_bool_array", reinterpret_cast<PyCFunction>(LOCKED(EndianedIOClass##_read_array_t<bool, '|'>)), METH_VARARGS | METH_KEYWORDS, "Read a bool array."},                         \
+        {"read_bool_array_into", reinterpret_cast<PyCFunction>(LOCKED(EndianedIOClass##_read_array_into_t<bool, '|'>)), METH_VARARGS | METH_KEYWORDS, "Read a bool array into a buffer."}, \
+        {"read_u8", reinterpret_cast<PyCFunction>(LOCKED(EndianedIOClass##_read_t<u8, '|'>)), METH_NOARGS, "Read a u8 value."},                                                            \
+        {"read_u8_array", reinterpret_cast<PyCFunction>(LOCKED(EndianedIOClass##_read_array_t<u8, '|'>)), METH_VARARGS | METH_KEYWORDS, "Read a u8 array."},                               \
+        {"read_u8_array_into", reinterpret_cast<PyCFunction>(LOCKED(EndianedIOClass##_read_array_into_t<u8, '|'>)), METH_VARARGS | METH_KEYWORDS, "Read a u8 array into a buffer."},       \
+        {"read_i8", reinterpret_cast<PyCFunction>(LOCKED(EndianedIOClass##_read_t<i8, '|'>)), METH_NOARGS, "Read an i8 value."},                                                           \
+        {"read_i8_array", reinterpret_cast<PyCFunction>(LOCKED(EndianedIOClass##_read_array_t<i8, '|'>)), METH_VARARGS | METH_KEYWORDS, "Read a i8 array."},                               \
+        {"read_i8_array_into", reinterpret_cast<PyCFunction>(LOCKED(EndianedIOClass##_read_array_into_t<i8, '|'>)), METH_VARARGS | METH_KEYWORDS, "Read a i8 array into a buffer."},       \
+        _GENERATE_ENDIANEDIOBASE_READ_FUNCTIONS_TYPE(EndianedIOClass, u16),                                                                                                                \
+        _GENERATE_ENDIANEDIOBASE_READ_FUNCTIONS_TYPE(EndianedIOClass, u32),                                                                                                                \
+        _GENERATE_ENDIANEDIOBASE_READ_FUNCTIONS_TYPE(EndianedIOClass, u64),                                                                                                                \
+        _GENERATE_ENDIANEDIOBASE_READ_FUNCTIONS_TYPE(EndianedIOClass, i16),                                                                                                                \
+        _GENERATE_ENDIANEDIOBASE_READ_FUNCTIONS_TYPE(EndianedIOClass, i32),                                                                                                                \
+        _GENERATE_ENDIANEDIOBASE_READ_FUNCTIONS_TYPE(EndianedIOClass, i64),                                                                                                                \
+        _GENERATE_ENDIANEDIOBASE_READ_FUNCTIONS_TYPE(EndianedIOClass, f16),                                                                                                                \
+        _GENERATE_ENDIANEDIOBASE_READ_FUNCTIONS_TYPE(EndianedIOClass, f32),                                                                                                                \
+        _GENERATE_ENDIANEDIOBASE_READ_FUNCTIONS_TYPE(EndianedIOClass, f64),                                                                                                                \
+        {"read_cstring", reinterpret_cast<PyCFunction>(LOCKED(EndianedIOClass##_read_cstring)), METH_VARARGS | METH_KEYWORDS, "Read until a null terminator."},                            \
+        {"read_cstring_array", reinterpret_cast<PyCFunction>(LOCKED(EndianedIOClass##_read_cstring_array)), METH_VARARGS | METH_KEYWORDS, "Read an array of null-terminated strings."},    \
+        {"read_string", reinterpret_cast<PyCFunction>(LOCKED(EndianedIOClass##_read_string)), METH_VARARGS | METH_KEYWORDS, "Read a string."},                                             \
+        {"read_bytes", reinterpret_cast<PyCFunction>(LOCKED(EndianedIOClass##_read_bytes)), METH_VARARGS | METH_KEYWORDS, "Read a byte array."},                                           \
+        {"read_varint", reinterpret_cast<PyCFunction>(LOCKED(EndianedIOClass##_read_varint<false>)), METH_NOARGS, "Read a variable-length integer."},                                      \
+        {"read_varint_array", reinterpret_cast<PyCFunction>(LOCKED(EndianedIOClass##_read_varint_array<false>)), METH_VARARGS | METH_KEYWORDS, "Read a variable-length integer array."},                    \
+        {"read_svarint", reinterpret_cast<PyCFunction>(LOCKED(EndianedIOClass##_read_varint<true>)), METH_NOARGS, "Read a zigzag signed varint."},                                         \
+        {"read_svarint_array", reinterpret_cast<PyCFunction>(LOCKED(EndianedIOClass##_read_varint_array<true>)), METH_VARARGS | METH_KEYWORDS, "Read a zigzag signed varint array."}
+
+/**
+ * @brief Parses the offset of a read_*_at.
+ *
+ * @return true on failure, false on success
+ */
+static inline bool EndianedIOBase_offset_arg(PyObject *py_offset, Py_ssize_t &offset)
+{
+    offset = PyLong_AsSsize_t(py_offset);
+    if (offset == -1 && PyErr_Occurred())
+    {
+        return true;
+    }
+    if (offset < 0)
+    {
+        PyErr_SetString(PyExc_ValueError, "Offset must be non-negative.");
+        return true;
+    }
+    return false;
+}
+
+/**
+ * @brief Splits the offset in front of the arguments of a read_*_at off.
+ *
+ * @return true on failure, false on success, fn_args is a new reference then
+ */
+static inline bool EndianedIOBase_offset_args(PyObject *args, Py_ssize_t &offset, PyObject *&fn_args)
+{
+    Py_ssize_t nargs = PyTuple_Size(args);
+    if (nargs < 1)
+    {
+        PyErr_SetString(PyExc_TypeError, "Missing the offset argument.");
+        return true;
+    }
+    if (EndianedIOBase_offset_arg(PyTuple_GET_ITEM(args, 0), offset))
+    {
+        return true;
+    }
+    fn_args = PyTuple_GetSlice(args, 1, nargs);
+    return fn_args == nullptr;
+}
+
+/**
+ * @brief Calls read at offset and restores the position afterwards, even if read fails.
+ *
+ * Other calls see the offset as position while read runs,
+ * so this is only for backends that hold their IOLock for the whole call.
+ * get_pos and set_pos return true on failure.
+ */
+template <typename EI, bool (*get_pos)(EI *, Py_ssize_t &), bool (*set_pos)(EI *, Py_ssize_t), typename F>
+static inline PyObject *EndianedIOBase_call_at(EI *self, Py_ssize_t offset, F &&read)
+{
+    Py_ssize_t pos = 0;
+    if (get_pos(self, pos) || set_pos(self, offset))
+    {
+        return nullptr;
+    }
+    PyObject *ret = read();
+    SavedException exc;
+    if (set_pos(self, pos))
+    {
+        exc.discard();
+        Py_XDECREF(ret);
+        return nullptr;
+    }
+    exc.restore();
+    return ret;
+}
+
+/**
+ * @brief read_*_at of a METH_NOARGS read, takes the offset as only argument.
+ */
+template <typename EI, bool (*get_pos)(EI *, Py_ssize_t &), bool (*set_pos)(EI *, Py_ssize_t), PyObject *(*fn)(EI *, PyObject *)>
+static PyObject *EndianedIOBase_read_at(EI *self, PyObject *py_offset)
+{
+    Py_ssize_t offset = 0;
+    if (EndianedIOBase_offset_arg(py_offset, offset))
+    {
+        return nullptr;
+    }
+    return EndianedIOBase_call_at<EI, get_pos, set_pos>(
+        self,
+        offset,
+        [&]
+        {
+            return fn(self, nullptr);
+        });
+}
+
+/**
+ * @brief read_*_at of a METH_VARARGS | METH_KEYWORDS read, takes the offset in front of the arguments of fn.
+ */
+template <typename EI, bool (*get_pos)(EI *, Py_ssize_t &), bool (*set_pos)(EI *, Py_ssize_t), PyObject *(*fn)(EI *, PyObject *, PyObject *)>
+static PyObject *EndianedIOBase_read_args_at(EI *self, PyObject *args, PyObject *kwds)
+{
+    Py_ssize_t offset = 0;
+    PyObject *fn_args = nullptr;
+    if (EndianedIOBase_offset_args(args, offset, fn_args))
+    {
+        return nullptr;
+    }
+    PyObject *ret = EndianedIOBase_call_at<EI, get_pos, set_pos>(
+        self,
+        offset,
+        [&]
+        {
+            return fn(self, fn_args, kwds);
+        });
+    Py_DecRef(fn_args);
+    return ret;
+}
+
+/**
+ * @brief read_*_at of a read that takes the position it starts at and advances, takes the offset as only argument.
+ *
+ * The position of the object stays untouched, so this is safe while other threads use the object.
+ */
+template <typename EI, PyObject *(*fn)(EI *, Py_ssize_t &)>
+static PyObject *EndianedIOBase_read_at_offset(EI *self, PyObject *py_offset)
+{
+    Py_ssize_t offset = 0;
+    if (EndianedIOBase_offset_arg(py_offset, offset))
+    {
+        return nullptr;
+    }
+    return fn(self, offset);
+}
+
+/**
+ * @brief read_*_at of a read that takes the position it starts at and advances, takes the offset in front of the arguments of fn.
+ */
+template <typename EI, PyObject *(*fn)(EI *, PyObject *, PyObject *, Py_ssize_t &)>
+static PyObject *EndianedIOBase_read_args_at_offset(EI *self, PyObject *args, PyObject *kwds)
+{
+    Py_ssize_t offset = 0;
+    PyObject *fn_args = nullptr;
+    if (EndianedIOBase_offset_args(args, offset, fn_args))
+    {
+        return nullptr;
+    }
+    PyObject *ret = fn(self, fn_args, kwds, offset);
+    Py_DecRef(fn_args);
+    return ret;
+}
+
+// read_*_at that move the position of the object to the offset and back, needs EndianedIOClass##_get_pos and EndianedIOClass##_set_pos
+#define GENERATE_ENDIANEDIOBASE_SEEKING_AT_METHODS(EndianedIOClass)                                                                                                                       \
+    template <typename T, char endian>                                                                                                                                                    \
+    constexpr auto EndianedIOClass##_read_t_at = EndianedIOBase_read_at<EndianedIOClass, EndianedIOClass##_get_pos, EndianedIOClass##_set_pos, EndianedIOClass##_read_t<T, endian>>;             \
+    template <typename T, char endian>                                                                                                                                                    \
+    constexpr auto EndianedIOClass##_read_array_t_at = EndianedIOBase_read_args_at<EndianedIOClass, EndianedIOClass##_get_pos, EndianedIOClass##_set_pos, EndianedIOClass##_read_array_t<T, endian>>; \
+    constexpr auto EndianedIOClass##_read_cstring_at = EndianedIOBase_read_args_at<EndianedIOClass, EndianedIOClass##_get_pos, EndianedIOClass##_set_pos, EndianedIOClass##_read_cstring>;        \
+    constexpr auto EndianedIOClass##_read_string_at = EndianedIOBase_read_args_at<EndianedIOClass, EndianedIOClass##_get_pos, EndianedIOClass##_set_pos, EndianedIOClass##_read_string>;          \
+    constexpr auto EndianedIOClass##_read_bytes_at = EndianedIOBase_read_args_at<EndianedIOClass, EndianedIOClass##_get_pos, EndianedIOClass##_set_pos, EndianedIOClass##_read_bytes>
+
+// positional reads need EndianedIOClass##_read_t_at, _read_array_t_at, _read_cstring_at, _read_string_at and _read_bytes_at
+#define _ENDIANEDIOBASE_AT(...) \
+    reinterpret_cast<PyCFunction>(LOCKED(__VA_ARGS__))
+
+#define _GENERATE_ENDIANEDIOBASE_READ_AT_FUNCTIONS_TYPE(EndianedIOClass, T)                                                                                                                                       \
+    {"read_" #T "_at", _ENDIANEDIOBASE_AT(EndianedIOClass##_read_t_at<T, '|'>), METH_O, "Read a " #T " value at an offset."},                                               \
+        {"read_" #T "_le_at", _ENDIANEDIOBASE_AT(EndianedIOClass##_read_t_at<T, '<'>), METH_O, "Read a " #T " value at an offset."},                                        \
+        {"read_" #T "_be_at", _ENDIANEDIOBASE_AT(EndianedIOClass##_read_t_at<T, '>'>), METH_O, "Read a " #T " value at an offset."},                                        \
+        {"read_" #T "_array_at", _ENDIANEDIOBASE_AT(EndianedIOClass##_read_array_t_at<T, '|'>), METH_VARARGS | METH_KEYWORDS, "Read a " #T " array at an offset."},    \
+        {"read_" #T "_le_array_at", _ENDIANEDIOBASE_AT(EndianedIOClass##_read_array_t_at<T, '<'>), METH_VARARGS | METH_KEYWORDS, "Read a " #T " array at an offset."}, \
+        {"read_" #T "_be_array_at", _ENDIANEDIOBASE_AT(EndianedIOClass##_read_array_t_at<T, '>'>), METH_VARARGS | METH_KEYWORDS, "Read a " #T " array at an offset."}
+
+#define GENERATE_ENDIANEDIOBASE_READ_AT_FUNCTIONS(EndianedIOClass)                                                                                                                                            \
+    {"read_bool_at", _ENDIANEDIOBASE_AT(EndianedIOClass##_read_t_at<bool, '|'>), METH_O, "Read a bool value at an offset."},                                            \
+        {"read_bool_array_at", _ENDIANEDIOBASE_AT(EndianedIOClass##_read_array_t_at<bool, '|'>), METH_VARARGS | METH_KEYWORDS, "Read a bool array at an offset."}, \
+        {"read_u8_at", _ENDIANEDIOBASE_AT(EndianedIOClass##_read_t_at<u8, '|'>), METH_O, "Read a u8 value at an offset."},                                              \
+        {"read_u8_array_at", _ENDIANEDIOBASE_AT(EndianedIOClass##_read_array_t_at<u8, '|'>), METH_VARARGS | METH_KEYWORDS, "Read a u8 array at an offset."},       \
+        {"read_i8_at", _ENDIANEDIOBASE_AT(EndianedIOClass##_read_t_at<i8, '|'>), METH_O, "Read an i8 value at an offset."},                                             \
+        {"read_i8_array_at", _ENDIANEDIOBASE_AT(EndianedIOClass##_read_array_t_at<i8, '|'>), METH_VARARGS | METH_KEYWORDS, "Read a i8 array at an offset."},       \
+        _GENERATE_ENDIANEDIOBASE_READ_AT_FUNCTIONS_TYPE(EndianedIOClass, u16),                                                                                                                                \
+        _GENERATE_ENDIANEDIOBASE_READ_AT_FUNCTIONS_TYPE(EndianedIOClass, u32),                                                                                                                                \
+        _GENERATE_ENDIANEDIOBASE_READ_AT_FUNCTIONS_TYPE(EndianedIOClass, u64),                                                                                                                                \
+        _GENERATE_ENDIANEDIOBASE_READ_AT_FUNCTIONS_TYPE(EndianedIOClass, i16),                                                                                                                                \
+        _GENERATE_ENDIANEDIOBASE_READ_AT_FUNCTIONS_TYPE(EndianedIOClass, i32),                                                                                                                                \
+        _GENERATE_ENDIANEDIOBASE_READ_AT_FUNCTIONS_TYPE(EndianedIOClass, i64),                                                                                                                                \
+        _GENERATE_ENDIANEDIOBASE_READ_AT_FUNCTIONS_TYPE(EndianedIOClass, f16),                                                                                                                                \
+        _GENERATE_ENDIANEDIOBASE_READ_AT_FUNCTIONS_TYPE(EndianedIOClass, f32),                                                                                                                                \
+        _GENERATE_ENDIANEDIOBASE_READ_AT_FUNCTIONS_TYPE(EndianedIOClass, f64),                                                                                                                                \
+        {"read_cstring_at", _ENDIANEDIOBASE_AT(EndianedIOClass##_read_cstring_at), METH_VARARGS | METH_KEYWORDS, "Read until a null terminator at an offset."},    \
+        {"read_cstring_table", reinterpret_cast<PyCFunction>(LOCKED(EndianedIOClass##_read_cstring_table)), METH_VARARGS | METH_KEYWORDS, "Read the null-terminated strings at offsets."},                    \
+        {"read_string_at", _ENDIANEDIOBASE_AT(EndianedIOClass##_read_string_at), METH_VARARGS | METH_KEYWORDS, "Read a string at an offset."},                     \
+        {"read_bytes_at", _ENDIANEDIOBASE_AT(EndianedIOClass##_read_bytes_at), METH_VARARGS | METH_KEYWORDS, "Read a byte array at an offset."}
+
+#define GENERATE_ENDIANEDIOBASE_BASE_FUNCTIONS(EndianedIOClass)                                                                                  \
+    {"read", reinterpret_cast<PyCFunction>(LOCKED(EndianedIOClass##_read)), METH_O, "Read bytes from the buffer."},                              \
+        {"readinto", reinterpret_cast<PyCFunction>(LOCKED(EndianedIOClass##_readinto)), METH_O, "Read bytes into a buffer."},                    \
+        {"seek", reinterpret_cast<PyCFunction>(LOCKED(EndianedIOClass##_seek)), METH_VARARGS, "Seek to a position in the buffer."},              \
+        {"tell", reinterpret_cast<PyCFunction>(LOCKED(EndianedIOClass##_tell)), METH_NOARGS, "Get the current position in the buffer."},         \
+        {"flush", reinterpret_cast<PyCFunction>(LOCKED(EndianedIOClass##_flush)), METH_NOARGS, "Flush the buffer."},                             \
+        {"fileno", reinterpret_cast<PyCFunction>(LOCKED(EndianedIOClass##_fileno)), METH_NOARGS, "Get the file descriptor."},                    \
+        {"isatty", reinterpret_cast<PyCFunction>(LOCKED(EndianedIOClass##_isatty)), METH_NOARGS, "Check if the buffer is a TTY."},               \
+        {"close", reinterpret_cast<PyCFunction>(LOCKED(EndianedIOClass##_close)), METH_NOARGS, "Close the buffer."},                             \
+        {"readable", reinterpret_cast<PyCFunction>(LOCKED(EndianedIOClass##_readable)), METH_NOARGS, "Check if the buffer is readable."},        \
+        {"writable", reinterpret_cast<PyCFunction>(LOCKED(EndianedIOClass##_writable)), METH_NOARGS, "Check if the buffer is writable."},        \
+        {"seekable", reinterpret_cast<PyCFunction>(LOCKED(EndianedIOClass##_seekable)), METH_NOARGS, "Check if the buffer is seekable."},        \
+        {"readline", reinterpret_cast<PyCFunction>(LOCKED(EndianedIOClass##_readline)), METH_VARARGS, "Read a line from the buffer."},           \
+        {"readlines", reinterpret_cast<PyCFunction>(LOCKED(EndianedIOClass##_readlines)), METH_VARARGS, "Read multiple lines from the buffer."}, \
+        {"align", reinterpret_cast<PyCFunction>(LOCKED(EndianedIOClass##_align)), METH_O, "Align the position of the buffer."},                  \
+        {"write", reinterpret_cast<PyCFunction>(LOCKED(EndianedIOClass##_write)), METH_O, "Write bytes to the buffer."},                         \
+        {"writelines", reinterpret_cast<PyCFunction>(LOCKED(EndianedIOClass##_writelines)), METH_O, "Write multiple lines to the buffer."}
+
+#define _GENERATE_ENDIANEDIOBASE_WRITE_FUNCTIONS_TYPE(EndianedIOClass, T)                                                                                                 \
+    {"write_" #T, reinterpret_cast<PyCFunction>(LOCKED(EndianedIOClass##_write_t<T, '|'>)), METH_O, "Write a " #T " value."},                                             \
+        {"write_" #T "_le", reinterpret_cast<PyCFunction>(LOCKED(EndianedIOClass##_write_t<T, '<'>)), METH_O, "Write a " #T " value."},                                   \
+        {"write_" #T "_be", reinterpret_cast<PyCFunction>(LOCKED(EndianedIOClass##_write_t<T, '>'>)), METH_O, "Write a " #T " value."},                                   \
+        {"write_" #T "_array", reinterpret_cast<PyCFunction>(LOCKED(EndianedIOClass##_write_array_t<T, '|'>)), METH_VARARGS | METH_KEYWORDS, "Write a " #T " array."},    \
+        {"write_" #T "_le_array", reinterpret_cast<PyCFunction>(LOCKED(EndianedIOClass##_write_array_t<T, '<'>)), METH_VARARGS | METH_KEYWORDS, "Write a " #T " array."}, \
+        {"write_" #T "_be_array", reinterpret_cast<PyCFunction>(LOCKED(EndianedIOClass##_write_array_t<T, '>'>)), METH_VARARGS | METH_KEYWORDS, "Write a " #T " array."}
+
+#define GENERATE_ENDIANEDIOBASE_WRITE_FUNCTIONS(EndianedIOClass)                                                                                                                            \
+    {"write_bool", reinterpret_cast<PyCFunction>(LOCKED(EndianedIOClass##_write_t<bool, '|'>)), METH_O, "Write a bool value."},                                                             \
+        {"write_bool_array", reinterpret_cast<PyCFunction>(LOCKED(EndianedIOClass##_write_array_t<bool, '|'>)), METH_VARARGS | METH_KEYWORDS, "Write a bool array."},                       \
+        {"write_u8", reinterpret_cast<PyCFunction>(LOCKED(EndianedIOClass##_write_t<u8, '|'>)), METH_O, "Write a u8 value."},                                                               \
+        {"write_u8_array", reinterpret_cast<PyCFunction>(LOCKED(EndianedIOClass##_write_array_t<u8, '|'>)), METH_VARARGS | METH_KEYWORDS, "Write a u8 array."},                             \
+        {"write_i8", reinterpret_cast<PyCFunction>(LOCKED(EndianedIOClass##_write_t<i8, '|'>)), METH_O, "Write an i8 value."},                                                              \
+        {"write_i8_array", reinterpret_cast<PyCFunction>(LOCKED(EndianedIOClass##_write_array_t<i8, '|'>)), METH_VARARGS | METH_KEYWORDS, "Write a i8 array."},                             \
+        _GENERATE_ENDIANEDIOBASE_WRITE_FUNCTIONS_TYPE(EndianedIOClass, u16),                                                                                                                \
+        _GENERATE_ENDIANEDIOBASE_WRITE_FUNCTIONS_TYPE(EndianedIOClass, u32),                                                                                                                \
+        _GENERATE_ENDIANEDIOBASE_WRITE_FUNCTIONS_TYPE(EndianedIOClass, u64),                                                                                                                \
+        _GENERATE_ENDIANEDIOBASE_WRITE_FUNCTIONS_TYPE(EndianedIOClass, i16),                                                                                                                \
+        _GENERATE_ENDIANEDIOBASE_WRITE_FUNCTIONS_TYPE(EndianedIOClass, i32),                                                                                                                \
+        _GENERATE_ENDIANEDIOBASE_WRITE_FUNCTIONS_TYPE(EndianedIOClass, i64),                                                                                                                \
+        _GENERATE_ENDIANEDIOBASE_WRITE_FUNCTIONS_TYPE(EndianedIOClass, f16),                                                                                                                \
+        _GENERATE_ENDIANEDIOBASE_WRITE_FUNCTIONS_TYPE(EndianedIOClass, f32),                                                                                                                \
+        _GENERATE_ENDIANEDIOBASE_WRITE_FUNCTIONS_TYPE(EndianedIOClass, f64),                                                                                                                \
+        {"write_cstring", reinterpret_cast<PyCFunction>(LOCKED(EndianedIOClass##_write_cstring)), METH_VARARGS | METH_KEYWORDS, "Write a C-style string."},                                 \
+        {"write_string", reinterpret_cast<PyCFunction>(LOCKED(EndianedIOClass##_write_string)), METH_VARARGS | METH_KEYWORDS, "Write a string."},                                           \
+        {"write_bytes", reinterpret_cast<PyCFunction>(LOCKED(EndianedIOClass##_write_bytes)), METH_VARARGS | METH_KEYWORDS, "Write a byte array."},                                         \
+        {"write_varint", reinterpret_cast<PyCFunction>(LOCKED(EndianedIOClass##_write_varint<false>)), METH_O, "Write a variable-length integer."},                                         \
+        {"write_varint_array", reinterpret_cast<PyCFunction>(LOCKED(EndianedIOClass##_write_varint_array<false>)), METH_VARARGS | METH_KEYWORDS, "Write a variable-length integer array."}, \
+        {"write_svarint", reinterpret_cast<PyCFunction>(LOCKED(EndianedIOClass##_write_varint<true>)), METH_O, "Write a zigzag signed varint."},                                            \
+        {"write_svarint_array", reinterpret_cast<PyCFunction>(LOCKED(EndianedIOClass##_write_varint_array<true>)), METH_VARARGS | METH_KEYWORDS, "Write a zigzag signed varint array."}
 
 template <typename T>
 concept EndianedIOConfig = requires {
@@ -152,7 +489,625 @@ static PyType_Spec createPyTypeSpec(
     };
 }
 
-static inline bool EndianedIOBase_write_count(PyObject *self, Py_ssize_t size)
+/**
+ * @brief Frees an instance of one of the subclassable IO types at the end of its tp_dealloc.
+ *
+ * Instances of Python subclasses are allocated by the GC,
+ * so they have to be freed by the tp_free of their type instead of PyObject_Del.
+ */
+static inline void EndianedIOBase_free(PyObject *self)
+{
+    PyTypeObject *type = Py_TYPE(self);
+    reinterpret_cast<freefunc>(PyType_GetSlot(type, Py_tp_free))(self);
+    // heap type instances own a reference to their type
+    Py_DecRef(reinterpret_cast<PyObject *>(type));
+}
+
+/**
+ * @brief The number of bytes the LEB128 encoding of value takes up.
+ */
+static inline Py_ssize_t varint_size(uint64_t value)
+{
+    return (std::bit_width(value | 1) + 6) / 7;
+}
+
+/**
+ * @brief Encodes value as LEB128 varint into dst, which needs room for varint_size(value) bytes.
+ *
+ * @return the number of written bytes
+ */
+static inline Py_ssize_t varint_encode(uint64_t value, uint8_t *dst)
+{
+    Py_ssize_t size = 0;
+    while (value > 0x7F)
+    {
+        dst[size++] = static_cast<uint8_t>((value & 0x7F) | 0x80);
+        value >>= 7;
+    }
+    dst[size++] = static_cast<uint8_t>(value);
+    return size;
+}
+
+/**
+ * @brief The number of bytes varint_encode_array needs for the given values.
+ */
+static inline Py_ssize_t varint_size_array(const uint64_t *values, Py_ssize_t count)
+{
+    Py_ssize_t size = 0;
+    for (Py_ssize_t i = 0; i < count; ++i)
+    {
+        size += varint_size(values[i]);
+    }
+    return size;
+}
+
+/**
+ * @brief Encodes count values back to back into dst, which has to be varint_size_array bytes large.
+ */
+static inline void varint_encode_array(const uint64_t *values, Py_ssize_t count, uint8_t *dst)
+{
+    for (Py_ssize_t i = 0; i < count; ++i)
+    {
+        if (values[i] < 0x80)
+        {
+            *dst++ = static_cast<uint8_t>(values[i]);
+        }
+        else
+        {
+            dst += varint_encode(values[i], dst);
+        }
+    }
+}
+
+/**
+ * @brief Decodes up to count varints from src and stops early at the first one that isn't complete within size.
+ *
+ * Works on 8 byte words: a word without continuation bits yields 8 values at once,
+ * otherwise the first varint of the word is compacted from its 7 bit groups without a loop.
+ * Only varints longer than 8 bytes and the last bytes of src take the bytewise path.
+ *
+ * @param consumed receives the number of bytes of the decoded varints
+ * @return the number of decoded values, -1 if a varint doesn't fit into 64 bits
+ */
+static inline Py_ssize_t varint_decode_array(const uint8_t *src, Py_ssize_t size, uint64_t *dst, Py_ssize_t count, Py_ssize_t &consumed)
+{
+    constexpr uint64_t CONTINUATION_BITS = 0x8080808080808080ull;
+    Py_ssize_t pos = 0;
+    Py_ssize_t n = 0;
+    while (n < count)
+    {
+        if (size - pos >= 8)
+        {
+            uint64_t word;
+            memcpy(&word, src + pos, sizeof(word));
+            if constexpr (IS_BIG_ENDIAN_SYSTEM)
+            {
+                word = byteswap(word);
+            }
+            const uint64_t last_bytes = ~word & CONTINUATION_BITS;
+            if (last_bytes == CONTINUATION_BITS && count - n >= 8)
+            {
+                for (int i = 0; i < 8; ++i)
+                {
+                    dst[n++] = src[pos++];
+                }
+                continue;
+            }
+            if (last_bytes != 0)
+            {
+                const int length = (std::countr_zero(last_bytes) >> 3) + 1;
+                uint64_t value = word & 0x7F7F7F7F7F7F7F7Full;
+                if (length < 8)
+                {
+                    value &= (1ull << (length * 8)) - 1;
+                }
+                // merge the 7 bit groups: 2 x 7 -> 14, 2 x 14 -> 28, 2 x 28 -> 56 bits
+                value = (value & 0x007F007F007F007Full) | ((value & 0x7F007F007F007F00ull) >> 1);
+                value = (value & 0x00003FFF00003FFFull) | ((value & 0x3FFF00003FFF0000ull) >> 2);
+                value = (value & 0x000000000FFFFFFFull) | ((value & 0x0FFFFFFF00000000ull) >> 4);
+                dst[n++] = value;
+                pos += length;
+                continue;
+            }
+        }
+
+        uint64_t value = 0;
+        Py_ssize_t end = pos;
+        for (uint32_t shift = 0;; shift += 7)
+        {
+            if (end >= size)
+            {
+                consumed = pos;
+                return n;
+            }
+            const uint8_t byte = src[end++];
+            if (shift == 63 && byte > 1)
+            {
+                consumed = pos;
+                return -1;
+            }
+            value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+            if (!(byte & 0x80))
+            {
+                break;
+            }
+        }
+        dst[n++] = value;
+        pos = end;
+    }
+    consumed = pos;
+    return n;
+}
+
+/**
+ * @brief Reads a single varint bytewise through the backend's read_raw.
+ *
+ * @return true on failure, false on success
+ */
+template <typename EI, bool (*read_raw)(EI *, void *, Py_ssize_t)>
+static inline bool EndianedIOBase_read_varint_raw(EI *self, uint64_t &value)
+{
+    value = 0;
+    uint8_t byte = 0x80;
+    for (uint32_t shift = 0; byte & 0x80; shift += 7)
+    {
+        if (read_raw(self, &byte, 1))
+        {
+            return true;
+        }
+        if (shift == 63 && byte > 1)
+        {
+            PyErr_SetString(PyExc_OverflowError, "Varint too large.");
+            return true;
+        }
+        value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+    }
+    return false;
+}
+
+/**
+ * @brief Reads count varints from a backend with a read-ahead buffer.
+ *
+ * The varints that are complete in the buffer are decoded in bulk,
+ * only the one crossing the end of the buffer is read bytewise, which also refills the buffer.
+ *
+ * @return true on failure, false on success
+ */
+template <typename EI, bool (*read_raw)(EI *, void *, Py_ssize_t)>
+static inline bool EndianedIOBase_read_varints(EI *self, uint64_t *dst, Py_ssize_t count)
+{
+    Py_ssize_t n = 0;
+    while (n < count)
+    {
+        if (self->read_buffer != nullptr && self->read_buffer_pos < self->read_buffer_len)
+        {
+            Py_ssize_t consumed = 0;
+            Py_ssize_t decoded = varint_decode_array(
+                reinterpret_cast<const uint8_t *>(self->read_buffer->data()) + self->read_buffer_pos,
+                self->read_buffer_len - self->read_buffer_pos,
+                dst + n,
+                count - n,
+                consumed);
+            self->read_buffer_pos += consumed;
+            if (decoded < 0)
+            {
+                PyErr_SetString(PyExc_OverflowError, "Varint too large.");
+                return true;
+            }
+            n += decoded;
+            if (n == count)
+            {
+                break;
+            }
+        }
+        if (EndianedIOBase_read_varint_raw<EI, read_raw>(self, dst[n++]))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Maps signed values to unsigned ones with small magnitudes staying small, -1 -> 1, 1 -> 2.
+ */
+static inline uint64_t zigzag_encode(int64_t value)
+{
+    return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+}
+
+static inline int64_t zigzag_decode(uint64_t value)
+{
+    return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+}
+
+/**
+ * @brief Converts an int into a varint value, a non-negative one or any i64 if zigzag is set.
+ *
+ * @return true on failure, false on success
+ */
+template <bool zigzag = false>
+static inline bool PyLong_AsVarint(PyObject *obj, uint64_t &value)
+{
+    if constexpr (zigzag)
+    {
+        long long signed_value = PyLong_AsLongLong(obj);
+        if (signed_value == -1 && PyErr_Occurred())
+        {
+            return true;
+        }
+        value = zigzag_encode(signed_value);
+        return false;
+    }
+    value = PyLong_AsUnsignedLongLong(obj);
+    if (value != static_cast<uint64_t>(-1) || !PyErr_Occurred())
+    {
+        return false;
+    }
+    if (PyErr_ExceptionMatches(PyExc_OverflowError))
+    {
+        // negative values raise an OverflowError as well
+        int overflow = 0;
+        SavedException exc;
+        long long signed_value = PyLong_AsLongLongAndOverflow(obj, &overflow);
+        if (overflow < 0 || (overflow == 0 && signed_value < 0))
+        {
+            exc.discard();
+            PyErr_SetString(PyExc_ValueError, "Varint must be non-negative.");
+            return true;
+        }
+        exc.restore();
+    }
+    return true;
+}
+
+template <bool zigzag = false>
+static inline PyObject *PyLong_FromVarint(uint64_t value)
+{
+    if constexpr (zigzag)
+    {
+        return PyLong_FromLongLong(zigzag_decode(value));
+    }
+    return PyLong_FromUnsignedLongLong(value);
+}
+
+/**
+ * @brief Converts a sequence of ints into varint values, see PyLong_AsVarint.
+ *
+ * @return true on failure, false on success
+ */
+template <bool zigzag = false>
+static inline bool varints_FromObject(PyObject *obj, std::vector<uint64_t> &values)
+{
+    PyObject *seq = PySequence_Fast(obj, "Expected a sequence of integers.");
+    if (seq == nullptr)
+    {
+        return true;
+    }
+    const Py_ssize_t count = PySequence_Fast_GET_SIZE(seq);
+    values.resize(count);
+    for (Py_ssize_t i = 0; i < count; ++i)
+    {
+        if (PyLong_AsVarint<zigzag>(PySequence_Fast_GET_ITEM(seq, i), values[i]))
+        {
+            Py_DecRef(seq);
+            return true;
+        }
+    }
+    Py_DecRef(seq);
+    return false;
+}
+
+/**
+ * @brief Converts decoded varints into a tuple of ints or a memoryview of u64, i64 if zigzag is set.
+ */
+template <bool zigzag = false, typename EI>
+static inline PyObject *varints_AsObject(EI *self, std::vector<uint64_t> &values, bool as_array)
+{
+    const Py_ssize_t count = static_cast<Py_ssize_t>(values.size());
+    if (as_array && zigzag)
+    {
+        for (uint64_t &value : values)
+        {
+            value = static_cast<uint64_t>(zigzag_decode(value));
+        }
+        return PyMemoryView_FromAnyArray<EI, int64_t, NATIVE_ENDIAN>(
+            self, reinterpret_cast<const char *>(values.data()), count);
+    }
+    if (as_array)
+    {
+        return PyMemoryView_FromAnyArray<EI, uint64_t, NATIVE_ENDIAN>(
+            self, reinterpret_cast<const char *>(values.data()), count);
+    }
+    PyObject *ret = PyTuple_New(count);
+    if (ret == nullptr)
+    {
+        return nullptr;
+    }
+    for (Py_ssize_t i = 0; i < count; ++i)
+    {
+        PyObject *item = PyLong_FromVarint<zigzag>(values[i]);
+        if (item == nullptr)
+        {
+            Py_DecRef(ret);
+            return nullptr;
+        }
+        PyTuple_SET_ITEM(ret, i, item);
+    }
+    return ret;
+}
+
+/**
+ * @brief The encoding of the length prefix used by read_count and write_count.
+ *
+ * Python means that the read_count/write_count methods of the object are called,
+ * which allows subclasses to override them. All other types are handled natively.
+ */
+enum class CountType : char
+{
+    Python = 0,
+    U8,
+    U16,
+    U32,
+    U64,
+    I8,
+    I16,
+    I32,
+    I64,
+    Varint,
+};
+
+static const struct
+{
+    const char *name;
+    CountType type;
+} COUNT_TYPE_NAMES[] = {
+    {"u8", CountType::U8},
+    {"u16", CountType::U16},
+    {"u32", CountType::U32},
+    {"u64", CountType::U64},
+    {"i8", CountType::I8},
+    {"i16", CountType::I16},
+    {"i32", CountType::I32},
+    {"i64", CountType::I64},
+    {"varint", CountType::Varint},
+};
+
+/**
+ * @brief Parses a count_type argument, None selects CountType::Python.
+ *
+ * @return int 0 on success, -1 with an exception set on failure
+ */
+static inline int CountType_FromObject(PyObject *obj, CountType &out)
+{
+    if (obj == nullptr || obj == Py_None)
+    {
+        out = CountType::Python;
+        return 0;
+    }
+    if (PyUnicode_Check(obj))
+    {
+        for (const auto &entry : COUNT_TYPE_NAMES)
+        {
+            if (unicode_equals(obj, entry.name))
+            {
+                out = entry.type;
+                return 0;
+            }
+        }
+    }
+    PyErr_Format(PyExc_ValueError, "Invalid count_type: %R, expected None, varint or an integer type like u32.", obj);
+    return -1;
+}
+
+static inline PyObject *CountType_AsObject(CountType type)
+{
+    for (const auto &entry : COUNT_TYPE_NAMES)
+    {
+        if (entry.type == type)
+        {
+            return PyUnicode_FromString(entry.name);
+        }
+    }
+    Py_RETURN_NONE;
+}
+
+/**
+ * @brief The number of bytes a length prefix of the given type takes up.
+ */
+static inline Py_ssize_t CountType_EncodedSize(CountType type, Py_ssize_t count)
+{
+    switch (type)
+    {
+    case CountType::U8:
+    case CountType::I8:
+        return 1;
+    case CountType::U16:
+    case CountType::I16:
+        return 2;
+    case CountType::U64:
+    case CountType::I64:
+        return 8;
+    case CountType::Varint:
+        return varint_size(static_cast<uint64_t>(count));
+    default:
+        return 4;
+    }
+}
+
+/**
+ * @brief Reads a length prefix of the given type without going through Python.
+ *
+ * The backend provides read_raw(self, dst, size), which returns true on failure.
+ * CountType::Python is read as i32, the default of read_count.
+ *
+ * @return true on failure, like EndianedIOBase_write_native_count
+ */
+template <typename EI, bool (*read_raw)(EI *, void *, Py_ssize_t)>
+    requires EndianedIOHandler<EI>
+static inline bool EndianedIOBase_read_native_count(EI *self, CountType type, Py_ssize_t &count)
+{
+    auto read_int = [self]<typename T>(T &value) -> bool
+    {
+        if (read_raw(self, &value, sizeof(T)))
+        {
+            return true;
+        }
+        handle_swap<EI, T, '|'>(self, value);
+        return false;
+    };
+
+    int64_t value = 0;
+    bool failed = true;
+    switch (type)
+    {
+    case CountType::U8:
+    {
+        uint8_t v;
+        failed = read_int(v);
+        value = v;
+        break;
+    }
+    case CountType::U16:
+    {
+        uint16_t v;
+        failed = read_int(v);
+        value = v;
+        break;
+    }
+    case CountType::U32:
+    {
+        uint32_t v;
+        failed = read_int(v);
+        value = v;
+        break;
+    }
+    case CountType::U64:
+    {
+        uint64_t v;
+        failed = read_int(v);
+        if (!failed && v > static_cast<uint64_t>(PY_SSIZE_T_MAX))
+        {
+            PyErr_SetString(PyExc_OverflowError, "Count too large.");
+            return true;
+        }
+        value = static_cast<int64_t>(v);
+        break;
+    }
+    case CountType::I8:
+    {
+        int8_t v;
+        failed = read_int(v);
+        value = v;
+        break;
+    }
+    case CountType::I16:
+    {
+        int16_t v;
+        failed = read_int(v);
+        value = v;
+        break;
+    }
+    case CountType::Python:
+    case CountType::I32:
+    {
+        int32_t v;
+        failed = read_int(v);
+        value = v;
+        break;
+    }
+    case CountType::I64:
+    {
+        int64_t v;
+        failed = read_int(v);
+        value = v;
+        break;
+    }
+    case CountType::Varint:
+    {
+        uint64_t v = 0;
+        failed = EndianedIOBase_read_varint_raw<EI, read_raw>(self, v);
+        if (!failed && v > static_cast<uint64_t>(PY_SSIZE_T_MAX))
+        {
+            PyErr_SetString(PyExc_OverflowError, "Count too large.");
+            return true;
+        }
+        value = static_cast<int64_t>(v);
+        break;
+    }
+    }
+    if (failed)
+    {
+        return true;
+    }
+    if (value < 0 || value > PY_SSIZE_T_MAX)
+    {
+        PyErr_SetString(PyExc_ValueError, "Invalid size argument.");
+        return true;
+    }
+    count = static_cast<Py_ssize_t>(value);
+    return false;
+}
+
+/**
+ * @brief Writes a length prefix of the given type without going through Python.
+ *
+ * The backend provides write_raw(self, src, size), which returns true on failure.
+ * CountType::Python is written as i32, the default of write_count.
+ *
+ * @return true on failure, like EndianedIOBase_call_write_count
+ */
+template <typename EI, bool (*write_raw)(EI *, const void *, Py_ssize_t)>
+    requires EndianedIOHandler<EI>
+static inline bool EndianedIOBase_write_native_count(EI *self, CountType type, Py_ssize_t count)
+{
+    auto write_int = [self, count]<typename T>(T) -> bool
+    {
+        if (count < static_cast<int64_t>(std::numeric_limits<T>::min()) ||
+            static_cast<uint64_t>(count) > static_cast<uint64_t>(std::numeric_limits<T>::max()))
+        {
+            PyErr_SetString(PyExc_OverflowError, "Count doesn't fit into the count_type.");
+            return true;
+        }
+        T value = static_cast<T>(count);
+        handle_swap<EI, T, '|'>(self, value);
+        return write_raw(self, &value, sizeof(T));
+    };
+
+    switch (type)
+    {
+    case CountType::U8:
+        return write_int(uint8_t{});
+    case CountType::U16:
+        return write_int(uint16_t{});
+    case CountType::U32:
+        return write_int(uint32_t{});
+    case CountType::U64:
+        return write_int(uint64_t{});
+    case CountType::I8:
+        return write_int(int8_t{});
+    case CountType::I16:
+        return write_int(int16_t{});
+    case CountType::Python:
+    case CountType::I32:
+        return write_int(int32_t{});
+    case CountType::I64:
+        return write_int(int64_t{});
+    case CountType::Varint:
+    {
+        if (count < 0)
+        {
+            PyErr_SetString(PyExc_ValueError, "Varint must be non-negative.");
+            return true;
+        }
+        uint8_t buffer[10];
+        return write_raw(self, buffer, varint_encode(static_cast<uint64_t>(count), buffer));
+    }
+    }
+    return true;
+}
+
+static inline bool EndianedIOBase_call_write_count(PyObject *self, Py_ssize_t size)
 {
     PyObject *res = PyObject_CallMethod(
         self,
@@ -170,7 +1125,1639 @@ static inline bool EndianedIOBase_write_count(PyObject *self, Py_ssize_t size)
 }
 
 template <typename T>
-static inline bool EndianedIOBase_write_count(T *self, Py_ssize_t size)
+static inline bool EndianedIOBase_call_write_count(T *self, Py_ssize_t size)
+{
+    return EndianedIOBase_call_write_count(reinterpret_cast<PyObject *>(self), size);
+}
+
+/**
+ * @brief The encodings that are handled without going through the codec registry.
+ */
+enum class StringCodec
+{
+    UTF8,
+    ASCII,
+    Latin1,
+    Other
+};
+
+static inline StringCodec StringCodec_FromName(const char *encoding)
 {
-    return EndianedIOBase_write_count(reinterpret_cast<PyObject *>(self), size);
+    // the same normalization as the codec registry, case and separators don't matter
+    std::string name;
+    for (const char *c = encoding; *c != '\0'; ++c)
+    {
+        if (*c != '-' && *c != '_' && *c != ' ')
+        {
+            name.push_back(static_cast<char>(tolower(static_cast<unsigned char>(*c))));
+        }
+    }
+    if (name == "utf8")
+    {
+        return StringCodec::UTF8;
+    }
+    if (name == "ascii" || name == "usascii")
+    {
+        return StringCodec::ASCII;
+    }
+    if (name == "latin1" || name == "iso88591" || name == "l1")
+    {
+        return StringCodec::Latin1;
+    }
+    return StringCodec::Other;
 }
+
+/**
+ * @brief Opt-in cache of a reader that returns the same str for repeated string contents.
+ *
+ * Only pure ASCII strings up to max_length bytes are interned, their str is the same for utf-8, ascii and latin-1 and any error handler.
+ * The strings are kept in an open addressing hash set that grows with the number of different strings.
+ * Once it holds max_entries strings it starts over empty, so the memory stays bounded no matter how many different strings are read,
+ * while the usual few thousand names of a format always stay cached.
+ */
+class StringInternCache
+{
+public:
+    static constexpr Py_ssize_t max_length = 256;
+    static constexpr size_t max_entries = 16384;
+
+    StringInternCache() : slots(64) {}
+
+    ~StringInternCache()
+    {
+        clear();
+    }
+
+    /**
+     * @brief Returns the cached str for the ASCII data or creates and caches a new one.
+     *
+     * @return PyObject* A new reference or nullptr on error
+     */
+    PyObject *get(const char *data, Py_ssize_t size)
+    {
+        const size_t hash = std::hash<std::string_view>{}(std::string_view(data, size));
+        Slot *slot = find(hash, data, size);
+        if (slot->str != nullptr)
+        {
+            return Py_NewRef(slot->str);
+        }
+        PyObject *str = PyUnicode_New(size, 127);
+        if (str == nullptr)
+        {
+            return nullptr;
+        }
+        memcpy(PyUnicode_1BYTE_DATA(str), data, size);
+        if (count == max_entries)
+        {
+            clear();
+            slot = find(hash, data, size);
+        }
+        else if ((count + 1) * 2 > slots.size())
+        {
+            grow();
+            slot = find(hash, data, size);
+        }
+        slot->hash = hash;
+        slot->str = Py_NewRef(str);
+        ++count;
+        return str;
+    }
+
+private:
+    struct Slot
+    {
+        size_t hash = 0;
+        PyObject *str = nullptr;
+    };
+
+    /**
+     * @brief Linear probing, returns the slot of the string or the empty slot where it belongs.
+     */
+    Slot *find(size_t hash, const char *data, Py_ssize_t size)
+    {
+        const size_t mask = slots.size() - 1;
+        for (size_t i = hash & mask;; i = (i + 1) & mask)
+        {
+            Slot &slot = slots[i];
+            if (slot.str == nullptr ||
+                (slot.hash == hash && PyUnicode_GET_LENGTH(slot.str) == size && memcmp(PyUnicode_1BYTE_DATA(slot.str), data, size) == 0))
+            {
+                return &slot;
+            }
+        }
+    }
+
+    void grow()
+    {
+        std::vector<Slot> old(slots.size() * 2);
+        old.swap(slots);
+        const size_t mask = slots.size() - 1;
+        for (const Slot &slot : old)
+        {
+            if (slot.str == nullptr)
+            {
+                continue;
+            }
+            size_t i = slot.hash & mask;
+            while (slots[i].str != nullptr)
+            {
+                i = (i + 1) & mask;
+            }
+            slots[i] = slot;
+        }
+    }
+
+    void clear()
+    {
+        for (Slot &slot : slots)
+        {
+            Py_CLEAR(slot.str);
+        }
+        count = 0;
+    }
+
+    std::vector<Slot> slots;
+    size_t count = 0;
+};
+
+/**
+ * @brief Returns the string cache of the reader, creates it on first use.
+ *
+ * @return nullptr with a MemoryError set on failure
+ */
+template <typename EI>
+static inline StringInternCache *EndianedIOBase_string_cache(EI *self)
+{
+    if (self->string_cache == nullptr)
+    {
+        self->string_cache = new (std::nothrow) StringInternCache();
+        if (self->string_cache == nullptr)
+        {
+            PyErr_NoMemory();
+        }
+    }
+    return self->string_cache;
+}
+
+/**
+ * @brief Decodes many strings with the same encoding and error handler.
+ *
+ * PyUnicode_Decode normalizes the encoding name and, for anything but the builtin codecs, looks up the codec on every call.
+ * This resolves it once, utf-8, ascii and latin-1 are decoded directly, everything else by the codec's decode function.
+ * Pure ASCII data is copied straight into a new str for all three, which is the cheapest way to build one.
+ */
+class StringDecoder
+{
+public:
+    ~StringDecoder()
+    {
+        Py_XDECREF(decoder);
+    }
+
+    /**
+     * @param cache interns the decoded ASCII strings if set
+     * @return true on failure
+     */
+    bool init(const char *encoding, const char *errors, StringInternCache *cache = nullptr)
+    {
+        this->errors = errors;
+        this->cache = cache;
+        codec = StringCodec_FromName(encoding);
+        if (codec == StringCodec::Other)
+        {
+            decoder = PyCodec_Decoder(encoding);
+            return decoder == nullptr;
+        }
+        return false;
+    }
+
+    PyObject *decode(const char *data, Py_ssize_t size) const
+    {
+        if (codec != StringCodec::Other && bytes_are_ascii(data, size))
+        {
+            if (cache != nullptr && size <= StringInternCache::max_length)
+            {
+                return cache->get(data, size);
+            }
+            PyObject *str = PyUnicode_New(size, 127);
+            if (str != nullptr && size > 0)
+            {
+                memcpy(PyUnicode_1BYTE_DATA(str), data, size);
+            }
+            return str;
+        }
+        switch (codec)
+        {
+        case StringCodec::UTF8:
+            return PyUnicode_DecodeUTF8(data, size, errors);
+        case StringCodec::ASCII:
+            return PyUnicode_DecodeASCII(data, size, errors);
+        case StringCodec::Latin1:
+            return PyUnicode_DecodeLatin1(data, size, errors);
+        default:
+            break;
+        }
+        PyObject *view = PyMemoryView_FromMemory(const_cast<char *>(data), size, PyBUF_READ);
+        if (view == nullptr)
+        {
+            return nullptr;
+        }
+        PyObject *result = PyObject_CallFunction(decoder, "Os", view, errors);
+        Py_DecRef(view);
+        if (result == nullptr)
+        {
+            return nullptr;
+        }
+        if (!PyTuple_Check(result) || PyTuple_GET_SIZE(result) != 2 || !PyUnicode_Check(PyTuple_GET_ITEM(result, 0)))
+        {
+            PyErr_SetString(PyExc_TypeError, "Decoder must return a tuple (str, int).");
+            Py_DecRef(result);
+            return nullptr;
+        }
+        PyObject *str = Py_NewRef(PyTuple_GET_ITEM(result, 0));
+        Py_DecRef(result);
+        return str;
+    }
+
+private:
+    StringCodec codec = StringCodec::UTF8;
+    PyObject *decoder = nullptr;
+    const char *errors = nullptr;
+    StringInternCache *cache = nullptr;
+};
+
+/**
+ * @brief Initializes decoder for a read of self, with the reader's string cache if intern is set.
+ *
+ * @return true on failure
+ */
+template <typename EI>
+static inline bool EndianedIOBase_init_decoder(EI *self, StringDecoder &decoder, const char *encoding, const char *errors, bool intern)
+{
+    StringInternCache *cache = nullptr;
+    if (intern)
+    {
+        cache = EndianedIOBase_string_cache(self);
+        if (cache == nullptr)
+        {
+            return true;
+        }
+    }
+    return decoder.init(encoding, errors, cache);
+}
+
+/**
+ * @brief The encoded form of a str, without a temporary bytes object where possible.
+ *
+ * ASCII strings are their own utf-8, ascii and latin-1 encoding, other strings use the utf-8 representation the str caches,
+ * or the str's own data for latin-1 if every character fits into a byte.
+ * Only strings that need the error handler, e.g. surrogates, and other encodings go through PyUnicode_AsEncodedString.
+ * The data is always followed by a null terminator, so C strings can be written with size() + 1.
+ */
+class StringEncoder
+{
+public:
+    ~StringEncoder()
+    {
+        Py_XDECREF(bytes);
+    }
+
+    /**
+     * @return true on failure
+     */
+    bool encode(PyObject *str, const char *encoding, const char *errors)
+    {
+        if (!PyUnicode_Check(str))
+        {
+            PyErr_SetString(PyExc_TypeError, "Argument must be a string.");
+            return true;
+        }
+        const StringCodec codec = StringCodec_FromName(encoding);
+        if (codec != StringCodec::Other && PyUnicode_IS_ASCII(str))
+        {
+            data_ = reinterpret_cast<const char *>(PyUnicode_1BYTE_DATA(str));
+            size_ = PyUnicode_GET_LENGTH(str);
+            return false;
+        }
+        if (codec == StringCodec::Latin1 && PyUnicode_KIND(str) == PyUnicode_1BYTE_KIND)
+        {
+            data_ = reinterpret_cast<const char *>(PyUnicode_1BYTE_DATA(str));
+            size_ = PyUnicode_GET_LENGTH(str);
+            return false;
+        }
+        if (codec == StringCodec::UTF8)
+        {
+            data_ = PyUnicode_AsUTF8AndSize(str, &size_);
+            if (data_ != nullptr)
+            {
+                return false;
+            }
+            // lone surrogates, e.g. from surrogateescape, are up to the error handler
+            if (!PyErr_ExceptionMatches(PyExc_UnicodeEncodeError))
+            {
+                return true;
+            }
+            PyErr_Clear();
+        }
+        bytes = PyUnicode_AsEncodedString(str, encoding, errors);
+        if (bytes == nullptr)
+        {
+            return true;
+        }
+        data_ = PyBytes_AS_STRING(bytes);
+        size_ = PyBytes_GET_SIZE(bytes);
+        return false;
+    }
+
+    const char *data() const
+    {
+        return data_;
+    }
+
+    Py_ssize_t size() const
+    {
+        return size_;
+    }
+
+private:
+    PyObject *bytes = nullptr;
+    const char *data_ = nullptr;
+    Py_ssize_t size_ = 0;
+};
+
+/**
+ * @brief Appends the bytes up to the next null terminator or the end of the stream to string, the terminator is consumed.
+ *
+ * The read-ahead buffer is scanned with memchr, without a buffer the stream is read bytewise.
+ *
+ * @return true on failure, false on success
+ */
+template <typename EI, Py_ssize_t (*read_into)(EI *, char *, Py_ssize_t)>
+static inline bool EndianedIOBase_read_cstring_raw(EI *self, std::string &string)
+{
+    while (true)
+    {
+        if (self->read_buffer_pos < self->read_buffer_len)
+        {
+            // scan the buffered bytes for the null terminator
+            const char *start = self->read_buffer->data() + self->read_buffer_pos;
+            const Py_ssize_t available = self->read_buffer_len - self->read_buffer_pos;
+            const char *end = static_cast<const char *>(memchr(start, '\0', available));
+            if (end != nullptr)
+            {
+                string.append(start, end - start);
+                self->read_buffer_pos += end - start + 1;
+                return false;
+            }
+            string.append(start, available);
+            self->read_buffer_pos = self->read_buffer_len;
+            continue;
+        }
+        // refills the buffer if there is one, otherwise reads a single byte
+        char c = 0;
+        Py_ssize_t read_size = read_into(self, &c, 1);
+        if (read_size < 0)
+        {
+            return true;
+        }
+        if (read_size == 0 || c == '\0')
+        {
+            return false;
+        }
+        string.push_back(c);
+    }
+}
+
+/**
+ * @brief read_cstring_table(offsets, base=None, encoding="utf-8", errors="surrogateescape", intern=False)
+ *
+ * Reads the null-terminated string at base + offset for every offset, base defaults to the current position.
+ * The position is restored afterwards, even if a read fails.
+ * read_cstring, get_pos and set_pos return true on failure.
+ */
+template <typename EI, bool (*get_pos)(EI *, Py_ssize_t &), bool (*set_pos)(EI *, Py_ssize_t), bool (*read_cstring)(EI *, std::string &)>
+static PyObject *EndianedIOBase_read_cstring_table(EI *self, PyObject *args, PyObject *kwds)
+{
+    static const char *kwlist[] = {
+        "offsets",
+        "base",
+        "encoding",
+        "errors",
+        "intern",
+        nullptr};
+
+    PyObject *py_offsets = nullptr;
+    PyObject *py_base = Py_None;
+    const char *encoding = "utf-8";         // Default encoding
+    const char *errors = "surrogateescape"; // Default error handling
+    int intern = 0;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "O|Ossp",
+                                     const_cast<char **>(kwlist),
+                                     &py_offsets,
+                                     &py_base,
+                                     &encoding,
+                                     &errors,
+                                     &intern))
+    {
+        return nullptr;
+    }
+
+    Py_ssize_t pos = 0;
+    if (get_pos(self, pos))
+    {
+        return nullptr;
+    }
+    Py_ssize_t base = pos;
+    if (py_base != Py_None)
+    {
+        base = PyLong_AsSsize_t(py_base);
+        if (base == -1 && PyErr_Occurred())
+        {
+            return nullptr;
+        }
+    }
+    StringDecoder decoder;
+    if (EndianedIOBase_init_decoder(self, decoder, encoding, errors, intern))
+    {
+        return nullptr;
+    }
+    PyObject *offsets = PySequence_Fast(py_offsets, "offsets must be a sequence of integers.");
+    if (offsets == nullptr)
+    {
+        return nullptr;
+    }
+    const Py_ssize_t count = PySequence_Fast_GET_SIZE(offsets);
+    PyObject *ret = PyTuple_New(count);
+    std::string string;
+    for (Py_ssize_t i = 0; ret != nullptr && i < count; ++i)
+    {
+        Py_ssize_t offset = PyLong_AsSsize_t(PySequence_Fast_GET_ITEM(offsets, i));
+        if (offset == -1 && PyErr_Occurred())
+        {
+            Py_CLEAR(ret);
+            break;
+        }
+        if (base + offset < 0)
+        {
+            PyErr_SetString(PyExc_ValueError, "Offset must be non-negative.");
+            Py_CLEAR(ret);
+            break;
+        }
+        string.clear();
+        PyObject *item = nullptr;
+        if (!set_pos(self, base + offset) && !read_cstring(self, string))
+        {
+            item = decoder.decode(string.data(), static_cast<Py_ssize_t>(string.size()));
+        }
+        if (item == nullptr)
+        {
+            Py_CLEAR(ret);
+            break;
+        }
+        PyTuple_SET_ITEM(ret, i, item);
+    }
+    Py_DecRef(offsets);
+
+    SavedException exc;
+    if (set_pos(self, pos))
+    {
+        exc.discard();
+        Py_XDECREF(ret);
+        return nullptr;
+    }
+    exc.restore();
+    return ret;
+}
+
+/**
+ * @brief Writes the pending bytes of the write buffer with the unbuffered write of the backend.
+ *
+ * The functions below are shared by the buffered backends, EndianedStreamIO and EndianedFileIO,
+ * which keep a read-ahead and a write buffer in front of an unbuffered readinto and write.
+ *
+ * @return true on failure, false on success
+ */
+template <typename EI, bool (*write)(EI *, const char *, Py_ssize_t)>
+static inline bool EndianedIOBase_flush_write_buffer(EI *self)
+{
+    if (self->write_buffer == nullptr || self->write_buffer->empty())
+    {
+        return false;
+    }
+    bool failed = write(self, self->write_buffer->data(), self->write_buffer->size());
+    self->write_buffer->clear();
+    return failed;
+}
+
+/**
+ * @brief Reads up to size bytes into dst, served from the read-ahead buffer.
+ *
+ * Pending writes are flushed first, reads that are larger than the buffer go directly into dst.
+ *
+ * @return Py_ssize_t The number of bytes read, less than size only at the end, or -1 on error
+ */
+template <typename EI, Py_ssize_t (*readinto)(EI *, char *, Py_ssize_t), bool (*write)(EI *, const char *, Py_ssize_t)>
+static inline Py_ssize_t EndianedIOBase_read_into(EI *self, char *dst, Py_ssize_t size)
+{
+    if (EndianedIOBase_flush_write_buffer<EI, write>(self))
+    {
+        return -1;
+    }
+    if (self->read_buffer == nullptr)
+    {
+        return readinto(self, dst, size);
+    }
+
+    Py_ssize_t total = std::min(size, self->read_buffer_len - self->read_buffer_pos);
+    memcpy(dst, self->read_buffer->data() + self->read_buffer_pos, total);
+    self->read_buffer_pos += total;
+    if (total == size)
+    {
+        return total;
+    }
+
+    const Py_ssize_t buffer_size = static_cast<Py_ssize_t>(self->read_buffer->size());
+    if (size - total >= buffer_size)
+    {
+        Py_ssize_t read_size = readinto(self, dst + total, size - total);
+        return read_size < 0 ? -1 : total + read_size;
+    }
+
+    // refill the buffer
+    Py_ssize_t read_size = readinto(self, self->read_buffer->data(), buffer_size);
+    self->read_buffer_pos = 0;
+    self->read_buffer_len = std::max<Py_ssize_t>(read_size, 0);
+    if (read_size < 0)
+    {
+        return -1;
+    }
+    Py_ssize_t copy_size = std::min(size - total, self->read_buffer_len);
+    memcpy(dst + total, self->read_buffer->data(), copy_size);
+    self->read_buffer_pos = copy_size;
+    return total + copy_size;
+}
+
+/**
+ * @brief Writes size bytes, collected in the write buffer if enabled, buffer_size is its capacity.
+ *
+ * The read-ahead buffer has to be dropped before.
+ *
+ * @return true on failure, false on success
+ */
+template <typename EI, bool (*write)(EI *, const char *, Py_ssize_t)>
+static inline bool EndianedIOBase_write_buffered(EI *self, const void *src, Py_ssize_t size, Py_ssize_t buffer_size)
+{
+    if (self->write_buffer == nullptr)
+    {
+        return write(self, static_cast<const char *>(src), size);
+    }
+    if (static_cast<Py_ssize_t>(self->write_buffer->size()) + size > buffer_size && EndianedIOBase_flush_write_buffer<EI, write>(self))
+    {
+        return true;
+    }
+    if (size >= buffer_size)
+    {
+        return write(self, static_cast<const char *>(src), size);
+    }
+    const char *data = static_cast<const char *>(src);
+    self->write_buffer->insert(self->write_buffer->end(), data, data + size);
+    return false;
+}
+
+/**
+ * @brief Reads exactly size bytes into dst.
+ *
+ * @return true on failure, false on success
+ */
+template <typename EI, Py_ssize_t (*read_into)(EI *, char *, Py_ssize_t)>
+static inline bool EndianedIOBase_read_raw(EI *self, void *dst, Py_ssize_t size)
+{
+    Py_ssize_t read_size = read_into(self, static_cast<char *>(dst), size);
+    if (read_size < 0)
+    {
+        return true;
+    }
+    if (read_size != size)
+    {
+        PyErr_Format(PyExc_ValueError, "Buffer size mismatch: expected %zd, got %zd", size, read_size);
+        return true;
+    }
+    return false;
+}
+
+/**
+ * @brief Reads exactly size bytes into a new bytes object.
+ */
+template <typename EI, bool (*read_raw)(EI *, void *, Py_ssize_t)>
+static inline PyObject *EndianedIOBase_read_buffer(EI *self, const Py_ssize_t size)
+{
+    PyObject *buffer = PyBytes_FromStringAndSize(nullptr, size);
+    if (buffer == nullptr)
+    {
+        return nullptr;
+    }
+    if (read_raw(self, PyBytes_AsString(buffer), size))
+    {
+        Py_DecRef(buffer);
+        return nullptr;
+    }
+    return buffer;
+}
+
+/**
+ * @brief Gets the count argument of an array read, the length prefix is read if it's None.
+ *
+ * @return true on failure, false on success
+ */
+template <typename EI, bool (*read_raw)(EI *, void *, Py_ssize_t)>
+    requires EndianedIOHandler<EI>
+static inline bool EndianedIOBase_read_count_arg(EI *self, PyObject *py_count, Py_ssize_t &count)
+{
+    if (((py_count == nullptr) || (py_count == Py_None)) && (self->count_type != CountType::Python))
+    {
+        return EndianedIOBase_read_native_count<EI, read_raw>(self, self->count_type, count);
+    }
+    else if ((py_count == nullptr) || (py_count == Py_None))
+    {
+        PyObject *py_count = PyObject_CallMethod(
+            reinterpret_cast<PyObject *>(self),
+            "read_count",
+            "",
+            nullptr);
+        if (py_count == nullptr)
+        {
+            return true;
+        }
+        if (!PyLong_Check(py_count))
+        {
+            PyErr_SetString(PyExc_TypeError, "read_count didn't return an integer.");
+            Py_DecRef(py_count);
+            return true;
+        }
+        count = PyLong_AsSsize_t(py_count);
+        Py_DecRef(py_count);
+        return false;
+    }
+    else if (PyLong_Check(py_count))
+    {
+        count = PyLong_AsSsize_t(py_count);
+        if (count < 0)
+        {
+            PyErr_SetString(PyExc_ValueError, "Invalid size argument.");
+            return true;
+        }
+        return PyErr_Occurred() != nullptr;
+    }
+
+    PyErr_SetString(PyExc_TypeError, "Argument must be an integer or None.");
+    return true;
+}
+
+/**
+ * @brief Writes the length prefix of an array write as configured by count_type.
+ *
+ * @return true on failure, false on success
+ */
+template <typename EI, bool (*write_raw)(EI *, const void *, Py_ssize_t)>
+    requires EndianedIOHandler<EI>
+static inline bool EndianedIOBase_write_count_prefix(EI *self, Py_ssize_t count)
+{
+    if (self->count_type != CountType::Python)
+    {
+        return EndianedIOBase_write_native_count<EI, write_raw>(self, self->count_type, count);
+    }
+    return EndianedIOBase_call_write_count(self, count);
+}
+
+/**
+ * @brief Writes size bytes and returns the number of bytes written.
+ */
+template <typename EI, bool (*write_raw)(EI *, const void *, Py_ssize_t)>
+static inline PyObject *EndianedIOBase_write_sized(EI *self, const void *data, const Py_ssize_t size)
+{
+    if (write_raw(self, data, size))
+    {
+        return nullptr;
+    }
+    return PyLong_FromSsize_t(size);
+}
+
+template <typename EI, bool (*read_raw)(EI *, void *, Py_ssize_t), typename T, char endian>
+    requires EndianedOperation<T, endian>
+static PyObject *EndianedIOBase_read_t(EI *self, PyObject *args)
+{
+    T value{};
+    if (read_raw(self, &value, sizeof(T)))
+    {
+        return nullptr;
+    }
+
+    handle_swap<EI, T, endian>(self, value);
+
+    return PyObject_FromAny(value);
+}
+
+template <typename EI, bool (*read_raw)(EI *, void *, Py_ssize_t)>
+static PyObject *EndianedIOBase_read_count(EI *self, PyObject *unused)
+{
+    Py_ssize_t count = 0;
+    if (EndianedIOBase_read_native_count<EI, read_raw>(self, self->count_type, count))
+    {
+        return nullptr;
+    }
+    return PyLong_FromSsize_t(count);
+}
+
+template <typename EI, bool (*read_raw)(EI *, void *, Py_ssize_t), typename T, char endian>
+    requires EndianedOperation<T, endian>
+static PyObject *EndianedIOBase_read_array_t(EI *self, PyObject *args, PyObject *kwds)
+{
+    static const char *kwlist[] = {
+        "count",
+        "as_array",
+        nullptr};
+
+    PyObject *py_count = nullptr;
+    int as_array = 0;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "|Op",
+                                     const_cast<char **>(kwlist),
+                                     &py_count,
+                                     &as_array))
+    {
+        return nullptr;
+    }
+
+    Py_ssize_t size = 0;
+    if (EndianedIOBase_read_count_arg<EI, read_raw>(self, py_count, size))
+    {
+        return nullptr;
+    }
+    // divide instead of multiplying, so that huge counts can't overflow
+    if (size > PY_SSIZE_T_MAX / static_cast<Py_ssize_t>(sizeof(T)))
+    {
+        PyErr_SetString(PyExc_OverflowError, "Count too large.");
+        return nullptr;
+    }
+
+    PyObject *buffer = EndianedIOBase_read_buffer<EI, read_raw>(self, sizeof(T) * size);
+    if (buffer == nullptr)
+    {
+        return nullptr;
+    }
+
+    if (as_array)
+    {
+        PyObject *ret = PyMemoryView_FromAnyArray<EI, T, endian>(
+            self, PyBytes_AsString(buffer), size);
+        Py_DecRef(buffer);
+        return ret;
+    }
+
+    // Read the data from the buffer
+    T *data = reinterpret_cast<T *>(PyBytes_AsString(buffer));
+    if (data == nullptr)
+    {
+        Py_DecRef(buffer);
+        return nullptr;
+    }
+    PyObject *ret = PyTuple_New(size);
+
+    for (Py_ssize_t i = 0; i < size; ++i)
+    {
+
+        T value = data[i];
+
+        handle_swap<EI, T, endian>(self, value);
+
+        PyObject *item = PyObject_FromAny(value);
+        if (item == nullptr)
+        {
+            Py_DecRef(ret);
+            Py_DecRef(buffer);
+            return nullptr;
+        }
+        PyTuple_SetItem(ret, i, item); // Steal reference, no need to DECREF
+    }
+
+    Py_DecRef(buffer);
+    return ret;
+}
+
+template <typename EI, bool (*read_raw)(EI *, void *, Py_ssize_t), typename T, char endian>
+    requires EndianedOperation<T, endian>
+static PyObject *EndianedIOBase_read_array_into_t(EI *self, PyObject *args, PyObject *kwds)
+{
+    static const char *kwlist[] = {
+        "dest",
+        "count",
+        nullptr};
+
+    PyObject *dest = nullptr;
+    PyObject *py_count = nullptr;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "O|O",
+                                     const_cast<char **>(kwlist),
+                                     &dest,
+                                     &py_count))
+    {
+        return nullptr;
+    }
+
+    Py_buffer dst{};
+    if (PyObject_GetBuffer(dest, &dst, PyBUF_WRITABLE | PyBUF_C_CONTIGUOUS) != 0)
+    {
+        return nullptr;
+    }
+
+    Py_ssize_t size = 0;
+    if (EndianedIOBase_read_count_arg<EI, read_raw>(self, py_count, size))
+    {
+        PyBuffer_Release(&dst);
+        return nullptr;
+    }
+    // divide instead of multiplying, so that huge counts can't overflow
+    if (size > dst.len / static_cast<Py_ssize_t>(sizeof(T)))
+    {
+        PyBuffer_Release(&dst);
+        PyErr_SetString(PyExc_ValueError, "Destination buffer is too small.");
+        return nullptr;
+    }
+    const Py_ssize_t nbytes = size * sizeof(T);
+
+    // large reads bypass the read-ahead buffer and go directly into the destination
+    if (read_raw(self, dst.buf, nbytes))
+    {
+        PyBuffer_Release(&dst);
+        return nullptr;
+    }
+
+    if (needs_swap<EI, T, endian>(self))
+    {
+        nogil(size * sizeof(T), [&]
+              { byteswap_array<T>(dst.buf, size); });
+    }
+    PyBuffer_Release(&dst);
+    return PyLong_FromSsize_t(size);
+}
+
+/**
+ * @brief align(size), moves the position to the next multiple of size.
+ */
+template <typename EI, bool (*tell)(EI *, Py_ssize_t &), PyObject *(*seek)(EI *, Py_ssize_t, int)>
+static PyObject *EndianedIOBase_align(EI *self, PyObject *arg)
+{
+    Py_ssize_t size;
+    CHECK_SIZE_ARG(arg, size, 4)
+    if (size <= 0)
+    {
+        PyErr_SetString(PyExc_ValueError, "Invalid size argument.");
+        return nullptr;
+    }
+    Py_ssize_t current_pos = 0;
+    if (tell(self, current_pos))
+    {
+        return nullptr;
+    }
+    Py_ssize_t pad = size - (current_pos % size);
+    if (pad != size)
+    {
+        return seek(self, current_pos + pad, SEEK_SET);
+    }
+    return PyLong_FromSsize_t(current_pos);
+}
+
+template <typename EI, Py_ssize_t (*read_into)(EI *, char *, Py_ssize_t)>
+static PyObject *EndianedIOBase_read_cstring(EI *self, PyObject *args, PyObject *kwds)
+{
+    static const char *kwlist[] = {
+        "encoding",
+        "errors",
+        "intern",
+        nullptr};
+
+    const char *encoding = "utf-8";         // Default encoding
+    const char *errors = "surrogateescape"; // Default error handling
+    int intern = 0;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "|ssp",
+                                     const_cast<char **>(kwlist),
+                                     &encoding,
+                                     &errors,
+                                     &intern))
+    {
+        return nullptr;
+    }
+
+    StringDecoder decoder;
+    if (EndianedIOBase_init_decoder(self, decoder, encoding, errors, intern))
+    {
+        return nullptr;
+    }
+    std::string string_buffer;
+    if (EndianedIOBase_read_cstring_raw<EI, read_into>(self, string_buffer))
+    {
+        return nullptr;
+    }
+    return decoder.decode(string_buffer.data(), static_cast<Py_ssize_t>(string_buffer.size()));
+}
+
+template <typename EI, bool (*read_raw)(EI *, void *, Py_ssize_t), Py_ssize_t (*read_into)(EI *, char *, Py_ssize_t)>
+static PyObject *EndianedIOBase_read_cstring_array(EI *self, PyObject *args, PyObject *kwds)
+{
+    static const char *kwlist[] = {
+        "count",
+        "encoding",
+        "errors",
+        "intern",
+        nullptr};
+
+    PyObject *py_count = nullptr;
+    const char *encoding = "utf-8";         // Default encoding
+    const char *errors = "surrogateescape"; // Default error handling
+    int intern = 0;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "|Ossp",
+                                     const_cast<char **>(kwlist),
+                                     &py_count,
+                                     &encoding,
+                                     &errors,
+                                     &intern))
+    {
+        return nullptr;
+    }
+
+    Py_ssize_t count = 0;
+    if (EndianedIOBase_read_count_arg<EI, read_raw>(self, py_count, count))
+    {
+        return nullptr;
+    }
+    StringDecoder decoder;
+    if (EndianedIOBase_init_decoder(self, decoder, encoding, errors, intern))
+    {
+        return nullptr;
+    }
+    PyObject *ret = PyTuple_New(count);
+    if (ret == nullptr)
+    {
+        return nullptr;
+    }
+    std::string string_buffer;
+    for (Py_ssize_t i = 0; i < count; ++i)
+    {
+        string_buffer.clear();
+        PyObject *item = nullptr;
+        if (!EndianedIOBase_read_cstring_raw<EI, read_into>(self, string_buffer))
+        {
+            item = decoder.decode(string_buffer.data(), static_cast<Py_ssize_t>(string_buffer.size()));
+        }
+        if (item == nullptr)
+        {
+            Py_DecRef(ret);
+            return nullptr;
+        }
+        PyTuple_SET_ITEM(ret, i, item);
+    }
+    return ret;
+}
+
+template <typename EI, bool (*read_raw)(EI *, void *, Py_ssize_t)>
+static PyObject *EndianedIOBase_read_bytes(EI *self, PyObject *args, PyObject *kwds)
+{
+    static const char *kwlist[] = {
+        "length",
+        "copy",
+        nullptr};
+
+    PyObject *py_count = nullptr;
+    int copy = 1;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "|Op",
+                                     const_cast<char **>(kwlist),
+                                     &py_count,
+                                     &copy))
+    {
+        return nullptr;
+    }
+
+    Py_ssize_t size = 0;
+    if (EndianedIOBase_read_count_arg<EI, read_raw>(self, py_count, size))
+    {
+        return nullptr;
+    }
+
+    PyObject *bytes = EndianedIOBase_read_buffer<EI, read_raw>(self, size);
+    if (bytes == nullptr || copy)
+    {
+        return bytes;
+    }
+    // there is no buffer to share, so only the return type differs
+    PyObject *view = PyMemoryView_FromObject(bytes);
+    Py_DecRef(bytes);
+    return view;
+}
+
+/**
+ * @brief read_view(size), read_bytes is the read of the backend, which reads everything that is left for a negative size.
+ */
+template <typename EI, PyObject *(*read_bytes)(EI *, Py_ssize_t)>
+static PyObject *EndianedIOBase_read_view(EI *self, PyObject *arg)
+{
+    Py_ssize_t size = -1;
+    if (arg != Py_None)
+    {
+        size = PyLong_AsSsize_t(arg);
+        if (size == -1 && PyErr_Occurred())
+        {
+            return nullptr;
+        }
+    }
+    PyObject *bytes = read_bytes(self, size);
+    if (bytes == nullptr)
+    {
+        return nullptr;
+    }
+    PyObject *view = PyMemoryView_FromObject(bytes);
+    Py_DecRef(bytes);
+    return view;
+}
+
+template <typename EI, bool (*read_raw)(EI *, void *, Py_ssize_t)>
+static PyObject *EndianedIOBase_read_string(EI *self, PyObject *args, PyObject *kwds)
+{
+    static const char *kwlist[] = {
+        "length",
+        "encoding",
+        "errors",
+        "intern",
+        nullptr};
+
+    PyObject *py_count = nullptr;
+    const char *encoding = "utf-8";         // Default encoding
+    const char *errors = "surrogateescape"; // Default error handling
+    int intern = 0;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "|Ossp",
+                                     const_cast<char **>(kwlist),
+                                     &py_count, &encoding,
+                                     &errors,
+                                     &intern))
+    {
+        return nullptr;
+    }
+
+    Py_ssize_t count = 0;
+    if (EndianedIOBase_read_count_arg<EI, read_raw>(self, py_count, count))
+    {
+        return nullptr;
+    }
+
+    PyObject *bytes = EndianedIOBase_read_buffer<EI, read_raw>(self, count);
+    if (bytes == nullptr)
+    {
+        return nullptr;
+    }
+    StringDecoder decoder;
+    PyObject *result = EndianedIOBase_init_decoder(self, decoder, encoding, errors, intern) ? nullptr : decoder.decode(PyBytes_AS_STRING(bytes), PyBytes_GET_SIZE(bytes));
+    Py_DecRef(bytes);
+    return result;
+}
+
+template <typename EI, bool (*read_raw)(EI *, void *, Py_ssize_t), bool zigzag>
+static PyObject *EndianedIOBase_read_varint(EI *self, PyObject *args)
+{
+    uint64_t value = 0;
+    if (EndianedIOBase_read_varints<EI, read_raw>(self, &value, 1))
+    {
+        return nullptr;
+    }
+    return PyLong_FromVarint<zigzag>(value);
+}
+
+template <typename EI, bool (*read_raw)(EI *, void *, Py_ssize_t), bool zigzag>
+static PyObject *EndianedIOBase_read_varint_array(EI *self, PyObject *args, PyObject *kwds)
+{
+    static const char *kwlist[] = {
+        "count",
+        "as_array",
+        nullptr};
+
+    PyObject *py_count = nullptr;
+    int as_array = 0;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "|Op",
+                                     const_cast<char **>(kwlist),
+                                     &py_count,
+                                     &as_array))
+    {
+        return nullptr;
+    }
+
+    Py_ssize_t size = 0;
+    if (EndianedIOBase_read_count_arg<EI, read_raw>(self, py_count, size))
+    {
+        return nullptr;
+    }
+
+    // the count comes from the data and the length of the stream is unknown,
+    // so the values grow in chunks instead of being allocated upfront
+    constexpr Py_ssize_t chunk_size = 4096;
+    std::vector<uint64_t> values;
+    for (Py_ssize_t done = 0; done < size;)
+    {
+        const Py_ssize_t chunk = std::min(size - done, chunk_size);
+        values.resize(done + chunk);
+        if (EndianedIOBase_read_varints<EI, read_raw>(self, values.data() + done, chunk))
+        {
+            return nullptr;
+        }
+        done += chunk;
+    }
+    return varints_AsObject<zigzag>(self, values, as_array);
+}
+
+template <typename EI, bool (*write_raw)(EI *, const void *, Py_ssize_t)>
+static PyObject *EndianedIOBase_write_count(EI *self, PyObject *arg)
+{
+    Py_ssize_t count = PyLong_AsSsize_t(arg);
+    if (count == -1 && PyErr_Occurred())
+    {
+        return nullptr;
+    }
+    if (EndianedIOBase_write_native_count<EI, write_raw>(self, self->count_type, count))
+    {
+        return nullptr;
+    }
+    return PyLong_FromSsize_t(CountType_EncodedSize(self->count_type, count));
+}
+
+template <typename EI, bool (*write_raw)(EI *, const void *, Py_ssize_t), typename T, char endian>
+    requires EndianedOperation<T, endian>
+static PyObject *EndianedIOBase_write_t(EI *self, PyObject *arg)
+{
+    T value{};
+    if (!PyObject_ToAny(arg, value))
+    {
+        return nullptr; // Conversion failed
+    }
+
+    handle_swap<EI, T, endian>(self, value);
+    return EndianedIOBase_write_sized<EI, write_raw>(self, &value, sizeof(T));
+}
+
+template <typename EI, bool (*write_raw)(EI *, const void *, Py_ssize_t), typename T, char endian>
+    requires EndianedOperation<T, endian>
+static PyObject *EndianedIOBase_write_array_t(EI *self, PyObject *args, PyObject *kwds)
+{
+    static const char *kwlist[] = {
+        "v",
+        "write_count",
+        nullptr};
+
+    PyObject *v = nullptr;
+    PyObject *write_count_obj = Py_True; // Default to True
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "O|O!",
+                                     const_cast<char **>(kwlist),
+                                     &v,
+                                     &PyBool_Type,
+                                     &write_count_obj))
+    {
+        return nullptr;
+    }
+
+    // fast path for array.array, memoryview, numpy, ... holding values of T
+    Py_buffer src{};
+    char src_endian = PyObject_GetAnyArrayBuffer<T>(v, &src);
+    if (src_endian)
+    {
+        Py_ssize_t count = src.len / sizeof(T);
+        if ((write_count_obj == Py_True) && EndianedIOBase_write_count_prefix<EI, write_raw>(self, count))
+        {
+            PyBuffer_Release(&src);
+            return nullptr;
+        }
+        PyObject *result = nullptr;
+        if (needs_swap<EI, T, endian>(self) != (src_endian != NATIVE_ENDIAN))
+        {
+            std::vector<uint8_t> buffer(static_cast<uint8_t *>(src.buf), static_cast<uint8_t *>(src.buf) + src.len);
+            nogil(buffer.size(), [&]
+                  { byteswap_array<T>(buffer.data(), count); });
+            result = EndianedIOBase_write_sized<EI, write_raw>(self, buffer.data(), buffer.size());
+        }
+        else
+        {
+            result = EndianedIOBase_write_sized<EI, write_raw>(self, src.buf, src.len);
+        }
+        PyBuffer_Release(&src);
+        return result;
+    }
+
+    Py_ssize_t count = PyObject_Size(v);
+    if ((write_count_obj == Py_True) && EndianedIOBase_write_count_prefix<EI, write_raw>(self, count))
+    {
+        return nullptr; // Resize failed
+    }
+
+    PyObject *iter = PyObject_GetIter(v);
+    PyObject *item = PyIter_Next(iter);
+
+    // Use uint8_t for bool to avoid std::vector<bool> specialization issues
+    using BufferType = std::conditional_t<std::is_same_v<T, bool>, uint8_t, T>;
+    std::vector<BufferType> buffer;
+    buffer.reserve(count);
+
+    while (item)
+    {
+        T value{};
+        if (!PyObject_ToAny(item, value))
+        {
+            Py_DecRef(item);
+            Py_DecRef(iter);
+            return nullptr; // Conversion failed
+        }
+        buffer.push_back(static_cast<BufferType>(value));
+        Py_DecRef(item);
+        item = PyIter_Next(iter);
+    }
+    Py_DecRef(iter);
+    if (PyErr_Occurred())
+    {
+        return nullptr; // Error occurred during iteration
+    }
+    // swap all values at once instead of one by one
+    if (needs_swap<EI, T, endian>(self))
+    {
+        nogil(buffer.size() * sizeof(T), [&]
+              { byteswap_array<T>(buffer.data(), buffer.size()); });
+    }
+
+    return EndianedIOBase_write_sized<EI, write_raw>(self, buffer.data(), buffer.size() * sizeof(BufferType));
+}
+
+template <typename EI, bool (*write_raw)(EI *, const void *, Py_ssize_t)>
+static PyObject *EndianedIOBase_write_cstring(EI *self, PyObject *args, PyObject *kwds)
+{
+    static const char *kwlist[] = {
+        "string",
+        "encoding",
+        "errors",
+        nullptr};
+
+    const char *encoding = "utf-8";         // Default encoding
+    const char *errors = "surrogateescape"; // Default error handling
+    PyObject *s = nullptr;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "O|ss",
+                                     const_cast<char **>(kwlist),
+                                     &s,
+                                     &encoding,
+                                     &errors))
+    {
+        return nullptr;
+    }
+
+    StringEncoder encoded;
+    if (encoded.encode(s, encoding, errors))
+    {
+        return nullptr;
+    }
+    // the encoded data is followed by a null terminator
+    return EndianedIOBase_write_sized<EI, write_raw>(self, encoded.data(), encoded.size() + 1);
+}
+
+template <typename EI, bool (*write_raw)(EI *, const void *, Py_ssize_t)>
+static PyObject *EndianedIOBase_write_string(EI *self, PyObject *args, PyObject *kwds)
+{
+    static const char *kwlist[] = {
+        "string",
+        "write_count",
+        "encoding",
+        "errors",
+        nullptr};
+
+    const char *encoding = "utf-8";         // Default encoding
+    const char *errors = "surrogateescape"; // Default error handling
+    PyObject *s = nullptr;
+    PyObject *write_count_obj = Py_True;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "O|O!ss",
+                                     const_cast<char **>(kwlist),
+                                     &s,
+                                     &PyBool_Type,
+                                     &write_count_obj,
+                                     &encoding,
+                                     &errors))
+    {
+        return nullptr;
+    }
+
+    StringEncoder encoded;
+    if (encoded.encode(s, encoding, errors))
+    {
+        return nullptr;
+    }
+    // the length prefix counts the encoded bytes
+    if ((write_count_obj == Py_True) && EndianedIOBase_write_count_prefix<EI, write_raw>(self, encoded.size()))
+    {
+        return nullptr;
+    }
+    return EndianedIOBase_write_sized<EI, write_raw>(self, encoded.data(), encoded.size());
+}
+
+template <typename EI, bool (*write_raw)(EI *, const void *, Py_ssize_t)>
+static PyObject *EndianedIOBase_write_bytes(EI *self, PyObject *args, PyObject *kwds)
+{
+    static const char *kwlist[] = {
+        "data",
+        "write_count",
+        nullptr};
+    Py_buffer v{};
+    PyObject *write_count_obj = Py_True;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "s*|O!",
+                                     const_cast<char **>(kwlist),
+                                     &v,
+                                     &PyBool_Type,
+                                     &write_count_obj))
+    {
+        return nullptr;
+    }
+
+    if ((write_count_obj == Py_True) && EndianedIOBase_write_count_prefix<EI, write_raw>(self, v.len))
+    {
+        PyBuffer_Release(&v);
+        return nullptr; // Resize failed
+    }
+
+    PyObject *result = EndianedIOBase_write_sized<EI, write_raw>(self, v.buf, v.len);
+    PyBuffer_Release(&v);
+    return result;
+}
+
+template <typename EI, bool (*write_raw)(EI *, const void *, Py_ssize_t), bool zigzag>
+static PyObject *EndianedIOBase_write_varint(EI *self, PyObject *arg)
+{
+    uint64_t value = 0;
+    if (PyLong_AsVarint<zigzag>(arg, value))
+    {
+        return nullptr;
+    }
+    uint8_t buffer[10];
+    return EndianedIOBase_write_sized<EI, write_raw>(self, buffer, varint_encode(value, buffer));
+}
+
+template <typename EI, bool (*write_raw)(EI *, const void *, Py_ssize_t), bool zigzag>
+static PyObject *EndianedIOBase_write_varint_array(EI *self, PyObject *args, PyObject *kwds)
+{
+    static const char *kwlist[] = {
+        "v",
+        "write_count",
+        nullptr};
+
+    PyObject *v = nullptr;
+    PyObject *write_count_obj = Py_True; // Default to True
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "O|O!",
+                                     const_cast<char **>(kwlist),
+                                     &v,
+                                     &PyBool_Type,
+                                     &write_count_obj))
+    {
+        return nullptr;
+    }
+
+    std::vector<uint64_t> values;
+    if (varints_FromObject<zigzag>(v, values))
+    {
+        return nullptr;
+    }
+
+    const Py_ssize_t count = static_cast<Py_ssize_t>(values.size());
+    if ((write_count_obj == Py_True) && EndianedIOBase_write_count_prefix<EI, write_raw>(self, count))
+    {
+        return nullptr; // Resize failed
+    }
+
+    // encode everything upfront, so that the backend gets a single write
+    std::vector<uint8_t> buffer(varint_size_array(values.data(), count));
+    nogil(
+        buffer.size(),
+        [&]
+        {
+            varint_encode_array(values.data(), count, buffer.data());
+        });
+    return EndianedIOBase_write_sized<EI, write_raw>(self, buffer.data(), buffer.size());
+}
+
+template <typename EI, bool (*read_raw)(EI *, void *, Py_ssize_t)>
+static PyObject *EndianedIOBase_read_struct(EI *self, PyObject *arg)
+{
+    StructFormatObject *format = StructFormat_FromObject(arg);
+    if (format == nullptr)
+    {
+        return nullptr;
+    }
+    PyObject *buffer = EndianedIOBase_read_buffer<EI, read_raw>(self, format->size);
+    if (buffer == nullptr)
+    {
+        Py_DECREF(format);
+        return nullptr;
+    }
+    PyObject *ret = StructFormat_unpack(format, PyBytes_AsString(buffer), StructFormat_endian(format, self->endian));
+    Py_DecRef(buffer);
+    Py_DECREF(format);
+    return ret;
+}
+
+template <typename EI, bool (*read_raw)(EI *, void *, Py_ssize_t)>
+static PyObject *EndianedIOBase_read_struct_array(EI *self, PyObject *args, PyObject *kwds)
+{
+    static const char *kwlist[] = {
+        "format",
+        "count",
+        nullptr};
+
+    PyObject *py_format = nullptr;
+    PyObject *py_count = nullptr;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "O|O",
+                                     const_cast<char **>(kwlist),
+                                     &py_format,
+                                     &py_count))
+    {
+        return nullptr;
+    }
+
+    StructFormatObject *format = StructFormat_FromObject(py_format);
+    if (format == nullptr)
+    {
+        return nullptr;
+    }
+    Py_ssize_t size = 0;
+    if (EndianedIOBase_read_count_arg<EI, read_raw>(self, py_count, size))
+    {
+        Py_DECREF(format);
+        return nullptr;
+    }
+    // divide instead of multiplying, so that huge counts can't overflow
+    if (format->size > 0 && size > PY_SSIZE_T_MAX / format->size)
+    {
+        Py_DECREF(format);
+        PyErr_SetString(PyExc_OverflowError, "Count too large.");
+        return nullptr;
+    }
+    // read all records at once
+    PyObject *buffer = EndianedIOBase_read_buffer<EI, read_raw>(self, size * format->size);
+    if (buffer == nullptr)
+    {
+        Py_DECREF(format);
+        return nullptr;
+    }
+
+    const char endian = StructFormat_endian(format, self->endian);
+    const char *data = PyBytes_AsString(buffer);
+    PyObject *ret = PyList_New(size);
+    for (Py_ssize_t i = 0; ret != nullptr && i < size; ++i, data += format->size)
+    {
+        PyObject *item = StructFormat_unpack(format, data, endian);
+        if (item == nullptr)
+        {
+            Py_DecRef(ret);
+            ret = nullptr;
+            break;
+        }
+        PyList_SetItem(ret, i, item); // Steal reference, no need to DECREF
+    }
+    Py_DecRef(buffer);
+    Py_DECREF(format);
+    return ret;
+}
+
+template <typename EI, bool (*write_raw)(EI *, const void *, Py_ssize_t)>
+static PyObject *EndianedIOBase_write_struct(EI *self, PyObject *args)
+{
+    PyObject *py_format = nullptr;
+    PyObject *values = nullptr;
+    if (!PyArg_ParseTuple(args, "OO", &py_format, &values))
+    {
+        return nullptr;
+    }
+    StructFormatObject *format = StructFormat_FromObject(py_format);
+    if (format == nullptr)
+    {
+        return nullptr;
+    }
+    std::vector<char> buffer(format->size);
+    PyObject *ret = nullptr;
+    if (StructFormat_pack(format, values, buffer.data(), StructFormat_endian(format, self->endian)) == 0)
+    {
+        ret = EndianedIOBase_write_sized<EI, write_raw>(self, buffer.data(), buffer.size());
+    }
+    Py_DECREF(format);
+    return ret;
+}
+
+template <typename EI, bool (*write_raw)(EI *, const void *, Py_ssize_t)>
+static PyObject *EndianedIOBase_write_struct_array(EI *self, PyObject *args, PyObject *kwds)
+{
+    static const char *kwlist[] = {
+        "format",
+        "v",
+        "write_count",
+        nullptr};
+
+    PyObject *py_format = nullptr;
+    PyObject *v = nullptr;
+    PyObject *write_count_obj = Py_True; // Default to True
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "OO|O!",
+                                     const_cast<char **>(kwlist),
+                                     &py_format,
+                                     &v,
+                                     &PyBool_Type,
+                                     &write_count_obj))
+    {
+        return nullptr;
+    }
+
+    StructFormatObject *format = StructFormat_FromObject(py_format);
+    if (format == nullptr)
+    {
+        return nullptr;
+    }
+    PyObject *seq = PySequence_Fast(v, "Argument must be a sequence.");
+    if (seq == nullptr)
+    {
+        Py_DECREF(format);
+        return nullptr;
+    }
+    Py_ssize_t count = PySequence_Fast_GET_SIZE(seq);
+    if (format->size > 0 && count > PY_SSIZE_T_MAX / format->size)
+    {
+        Py_DecRef(seq);
+        Py_DECREF(format);
+        PyErr_SetString(PyExc_OverflowError, "Count too large.");
+        return nullptr;
+    }
+
+    // pack all records first, so that a bad record doesn't leave a partial write behind
+    const char endian = StructFormat_endian(format, self->endian);
+    PyObject **items = PySequence_Fast_ITEMS(seq);
+    std::vector<char> buffer(count * format->size);
+    for (Py_ssize_t i = 0; i < count; ++i)
+    {
+        if (StructFormat_pack(format, items[i], buffer.data() + i * format->size, endian) < 0)
+        {
+            Py_DecRef(seq);
+            Py_DECREF(format);
+            return nullptr;
+        }
+    }
+    Py_DecRef(seq);
+    Py_DECREF(format);
+
+    if ((write_count_obj == Py_True) && EndianedIOBase_write_count_prefix<EI, write_raw>(self, count))
+    {
+        return nullptr;
+    }
+    return EndianedIOBase_write_sized<EI, write_raw>(self, buffer.data(), buffer.size());
+}
+
+// binds the shared methods to EndianedIOClass##_*, the backend provides
+// _read_raw, _read_into, _read_bytes, _write_raw, _tell and _seek
+#define GENERATE_ENDIANEDIOBASE_BUFFERED_METHODS(EndianedIOClass)                                                                                                 \
+    template <typename T, char endian>                                                                                                                            \
+    constexpr auto EndianedIOClass##_read_t = EndianedIOBase_read_t<EndianedIOClass, _read_raw, T, endian>;                                                       \
+    template <typename T, char endian>                                                                                                                            \
+    constexpr auto EndianedIOClass##_read_array_t = EndianedIOBase_read_array_t<EndianedIOClass, _read_raw, T, endian>;                                           \
+    template <typename T, char endian>                                                                                                                            \
+    constexpr auto EndianedIOClass##_read_array_into_t = EndianedIOBase_read_array_into_t<EndianedIOClass, _read_raw, T, endian>;                                 \
+    template <bool zigzag>                                                                                                                                        \
+    constexpr auto EndianedIOClass##_read_varint = EndianedIOBase_read_varint<EndianedIOClass, _read_raw, zigzag>;                                                \
+    template <bool zigzag>                                                                                                                                        \
+    constexpr auto EndianedIOClass##_read_varint_array = EndianedIOBase_read_varint_array<EndianedIOClass, _read_raw, zigzag>;                                    \
+    template <typename T, char endian>                                                                                                                            \
+    constexpr auto EndianedIOClass##_write_t = EndianedIOBase_write_t<EndianedIOClass, _write_raw, T, endian>;                                                    \
+    template <typename T, char endian>                                                                                                                            \
+    constexpr auto EndianedIOClass##_write_array_t = EndianedIOBase_write_array_t<EndianedIOClass, _write_raw, T, endian>;                                        \
+    template <bool zigzag>                                                                                                                                        \
+    constexpr auto EndianedIOClass##_write_varint = EndianedIOBase_write_varint<EndianedIOClass, _write_raw, zigzag>;                                             \
+    template <bool zigzag>                                                                                                                                        \
+    constexpr auto EndianedIOClass##_write_varint_array = EndianedIOBase_write_varint_array<EndianedIOClass, _write_raw, zigzag>;                                 \
+    constexpr auto EndianedIOClass##_read_count = EndianedIOBase_read_count<EndianedIOClass, _read_raw>;                                                          \
+    constexpr auto EndianedIOClass##_align = EndianedIOBase_align<EndianedIOClass, _tell, _seek>;                                                                 \
+    constexpr auto EndianedIOClass##_read_cstring = EndianedIOBase_read_cstring<EndianedIOClass, _read_into>;                                                     \
+    constexpr auto EndianedIOClass##_read_cstring_array = EndianedIOBase_read_cstring_array<EndianedIOClass, _read_raw, _read_into>;                              \
+    constexpr auto EndianedIOClass##_read_bytes = EndianedIOBase_read_bytes<EndianedIOClass, _read_raw>;                                                          \
+    constexpr auto EndianedIOClass##_read_view = EndianedIOBase_read_view<EndianedIOClass, _read_bytes>;                                                          \
+    constexpr auto EndianedIOClass##_read_string = EndianedIOBase_read_string<EndianedIOClass, _read_raw>;                                                        \
+    constexpr auto EndianedIOClass##_write_count = EndianedIOBase_write_count<EndianedIOClass, _write_raw>;                                                       \
+    constexpr auto EndianedIOClass##_write_cstring = EndianedIOBase_write_cstring<EndianedIOClass, _write_raw>;                                                   \
+    constexpr auto EndianedIOClass##_write_string = EndianedIOBase_write_string<EndianedIOClass, _write_raw>;                                                     \
+    constexpr auto EndianedIOClass##_write_bytes = EndianedIOBase_write_bytes<EndianedIOClass, _write_raw>;                                                       \
+    constexpr auto EndianedIOClass##_read_struct = EndianedIOBase_read_struct<EndianedIOClass, _read_raw>;                                                        \
+    constexpr auto EndianedIOClass##_read_struct_array = EndianedIOBase_read_struct_array<EndianedIOClass, _read_raw>;                                            \
+    constexpr auto EndianedIOClass##_write_struct = EndianedIOBase_write_struct<EndianedIOClass, _write_raw>;                                                     \
+    constexpr auto EndianedIOClass##_write_struct_array = EndianedIOBase_write_struct_array<EndianedIOClass, _write_raw>
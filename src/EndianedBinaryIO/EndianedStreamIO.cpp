@@ -10,6 +10,8 @@
 
 #include "PyConverter.hpp"
 #include "EndianedIOBase.hpp"
+#include "StructFormat.hpp"
+#include "Schema.hpp"
 #include <algorithm>
 
 // 'align'
@@ -36,8 +38,22 @@ typedef struct
     PyObject *readline;
     PyObject *readlines;
     PyObject *fileno;
+    CountType count_type; // encoding of length prefixes
+    Py_ssize_t buffer_size;       // size of the read-ahead buffer, 0 if disabled
+    Py_ssize_t write_buffer_size; // size of the write buffer, 0 if disabled
+    // read-ahead buffer, only used for seekable streams
+    // the stream position is ahead of the logical position by the unread bytes
+    std::vector<char> *read_buffer; // nullptr if disabled
+    Py_ssize_t read_buffer_pos;     // position of the next unread byte
+    Py_ssize_t read_buffer_len;     // number of valid bytes
+    // write buffer, the stream position is behind the logical position by its size
+    std::vector<char> *write_buffer; // nullptr if disabled
+    StringInternCache *string_cache; // interned strings of the reads with intern=True, nullptr until the first one
+    IOLock io_lock;                  // serializes the calls, the stream can switch threads
 } EndianedStreamIO;
 
+#define DEFAULT_READ_BUFFER_SIZE 65536
+
 #define IF_NOT_NULL_UNREF(obj) \
     if (obj != nullptr)        \
     {                          \
@@ -45,8 +61,38 @@ typedef struct
         obj = nullptr;         \
     }
 
+static bool _flush_write_buffer(EndianedStreamIO *self);
+
+/**
+ * @brief Flushes the pending writes before the object is destroyed.
+ *
+ * Runs as tp_finalize like in io.FileIO, so that the object is still alive
+ * when a failed flush is reported as unraisable.
+ */
+void EndianedStreamIO_finalize(EndianedStreamIO *self)
+{
+    if (self->write_buffer == nullptr || self->write_buffer->empty())
+    {
+        return;
+    }
+    // errors can't be raised anymore
+    SavedException exc;
+    if (_flush_write_buffer(self))
+    {
+        PyErr_WriteUnraisable(reinterpret_cast<PyObject *>(self));
+    }
+    exc.restore();
+}
+
 void EndianedStreamIO_dealloc(EndianedStreamIO *self)
 {
+    if (PyObject_CallFinalizerFromDealloc(reinterpret_cast<PyObject *>(self)) < 0)
+    {
+        // resurrected by the finalizer
+        return;
+    }
+    delete self->write_buffer;
+    self->write_buffer = nullptr;
     IF_NOT_NULL_UNREF(self->stream);
     IF_NOT_NULL_UNREF(self->read);
     IF_NOT_NULL_UNREF(self->write);
@@ -63,12 +109,21 @@ void EndianedStreamIO_dealloc(EndianedStreamIO *self)
     IF_NOT_NULL_UNREF(self->readline);
     IF_NOT_NULL_UNREF(self->readlines);
     IF_NOT_NULL_UNREF(self->fileno);
+    delete self->read_buffer;
+    self->read_buffer = nullptr;
+    delete self->string_cache;
+    self->string_cache = nullptr;
+    IOLock_free(self->io_lock);
 
-    PyObject_Del((PyObject *)self);
+    EndianedIOBase_free(reinterpret_cast<PyObject *>(self));
 }
 
 int EndianedStreamIO_init(EndianedStreamIO *self, PyObject *args, PyObject *kwds)
 {
+    if (IOLock_init(self->io_lock))
+    {
+        return -1;
+    }
     self->stream = nullptr;
     self->endian = '<'; // default to little-endian
 
@@ -77,16 +132,40 @@ int EndianedStreamIO_init(EndianedStreamIO *self, PyObject *args, PyObject *kwds
     static const char *kwlist[] = {
         "stream",
         "endian",
+        "count_type",
+        "buffer_size",
+        "write_buffer_size",
         nullptr};
 
     // Parse arguments
-    if (!PyArg_ParseTupleAndKeywords(args, kwds, "O|s*",
+    PyObject *count_type = Py_None;
+    Py_ssize_t buffer_size = DEFAULT_READ_BUFFER_SIZE;
+    // off by default, so that writes reach the stream right away like before
+    Py_ssize_t write_buffer_size = 0;
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "O|s*Onn",
                                      const_cast<char **>(kwlist),
                                      &self->stream,
-                                     &endian_view))
+                                     &endian_view,
+                                     &count_type,
+                                     &buffer_size,
+                                     &write_buffer_size))
     {
         return -1;
     }
+    if (buffer_size < 0 || write_buffer_size < 0)
+    {
+        PyBuffer_Release(&endian_view);
+        PyErr_SetString(PyExc_ValueError, "buffer_size and write_buffer_size must be non-negative.");
+        return -1;
+    }
+    // the stream is released in dealloc
+    Py_IncRef(self->stream);
+
+    if (CountType_FromObject(count_type, self->count_type) < 0)
+    {
+        PyBuffer_Release(&endian_view);
+        return -1;
+    }
 
     // parse endian argument
     if (endian_view.buf != nullptr)
@@ -118,27 +197,55 @@ int EndianedStreamIO_init(EndianedStreamIO *self, PyObject *args, PyObject *kwds
     self->readline = PyObject_GetAttrString(self->stream, "readline");
     self->readlines = PyObject_GetAttrString(self->stream, "readlines");
     self->fileno = PyObject_GetAttrString(self->stream, "fileno");
+    // not every stream implements the full io interface
+    PyErr_Clear();
+
+    self->buffer_size = buffer_size;
+    self->write_buffer_size = write_buffer_size;
+    delete self->write_buffer;
+    self->write_buffer = nullptr;
+    if (write_buffer_size > 0)
+    {
+        self->write_buffer = new std::vector<char>();
+        self->write_buffer->reserve(write_buffer_size);
+    }
+
+    // reading ahead needs to seek back to hand the stream over in the right position
+    delete self->read_buffer;
+    self->read_buffer = nullptr;
+    self->read_buffer_pos = 0;
+    self->read_buffer_len = 0;
+    if (buffer_size > 0 && self->seekable != nullptr && self->seek != nullptr && self->tell != nullptr)
+    {
+        PyObject *seekable = PyObject_CallNoArgs(self->seekable);
+        if (seekable == nullptr)
+        {
+            return -1;
+        }
+        int is_seekable = PyObject_IsTrue(seekable);
+        Py_DecRef(seekable);
+        if (is_seekable < 0)
+        {
+            return -1;
+        }
+        if (is_seekable)
+        {
+            self->read_buffer = new std::vector<char>(buffer_size);
+        }
+    }
     return 0;
 };
 
 PyMemberDef EndianedStreamIO_members[] = {
     {"endian", T_CHAR, offsetof(EndianedStreamIO, endian), 0, "endian"},
     {"stream", T_OBJECT_EX, offsetof(EndianedStreamIO, stream), READONLY, "stream"},
-    {"read", T_OBJECT_EX, offsetof(EndianedStreamIO, read), READONLY, "read"},
-    {"write", T_OBJECT_EX, offsetof(EndianedStreamIO, write), READONLY, "write"},
-    {"seek", T_OBJECT_EX, offsetof(EndianedStreamIO, seek), READONLY, "seek"},
-    {"tell", T_OBJECT_EX, offsetof(EndianedStreamIO, tell), READONLY, "tell"},
-    {"flush", T_OBJECT_EX, offsetof(EndianedStreamIO, flush), READONLY, "flush"},
-    {"close", T_OBJECT_EX, offsetof(EndianedStreamIO, close), READONLY, "close"},
     {"readable", T_OBJECT_EX, offsetof(EndianedStreamIO, readable), READONLY, "readable"},
     {"writable", T_OBJECT_EX, offsetof(EndianedStreamIO, writable), READONLY, "writable"},
     {"seekable", T_OBJECT_EX, offsetof(EndianedStreamIO, seekable), READONLY, "seekable"},
     {"isatty", T_OBJECT_EX, offsetof(EndianedStreamIO, isatty), READONLY, "isatty"},
-    {"truncate", T_OBJECT_EX, offsetof(EndianedStreamIO, truncate), READONLY, "truncate"},
-    {"readinto", T_OBJECT_EX, offsetof(EndianedStreamIO, readinto), READONLY, "readinto"},
-    {"readline", T_OBJECT_EX, offsetof(EndianedStreamIO, readline), READONLY, "readline"},
-    {"readlines", T_OBJECT_EX, offsetof(EndianedStreamIO, readlines), READONLY, "readlines"},
     {"fileno", T_OBJECT_EX, offsetof(EndianedStreamIO, fileno), READONLY, "fileno"},
+    {"buffer_size", T_PYSSIZET, offsetof(EndianedStreamIO, buffer_size), READONLY, "The size of the read-ahead buffer, 0 if disabled."},
+    {"write_buffer_size", T_PYSSIZET, offsetof(EndianedStreamIO, write_buffer_size), READONLY, "The size of the write buffer, 0 if disabled."},
     {NULL} /* Sentinel */
 };
 
@@ -148,725 +255,599 @@ PyObject *EndianedIOBase_get_closed(EndianedStreamIO *self, void *closure)
     {
         Py_RETURN_TRUE;
     }
-    return PyObject_CallMethod(self->stream, "closed", nullptr);
+    return PyObject_GetAttrString(self->stream, "closed");
 }
 
-PyGetSetDef EndianedStreamIO_getseters[] = {
-    {"closed", (getter)EndianedIOBase_get_closed, nullptr, "closed", nullptr},
-    {nullptr} /* Sentinel */
-};
-
-inline PyObject *_read_buffer(EndianedStreamIO *self, const Py_ssize_t size)
+PyObject *EndianedStreamIO_get_count_type(EndianedStreamIO *self, void *closure)
 {
-    PyObject *py_size = PyLong_FromSsize_t(size);
-    PyObject *buffer = PyObject_CallFunctionObjArgs(
-        self->read,
-        py_size,
-        nullptr);
-    Py_DecRef(py_size);
-
-    if (buffer == nullptr)
-    {
-        return nullptr;
-    }
-    Py_ssize_t check_res = PyBytes_Size(buffer);
-    if (check_res < 0)
-    {
-        return nullptr;
-    }
-    else if (check_res != size)
-    {
-        PyErr_Format(PyExc_ValueError, "Buffer size mismatch: expected %zu, got %d", size, check_res);
-        Py_DecRef(buffer);
-        return nullptr;
-    }
+    return CountType_AsObject(self->count_type);
+}
 
-    return buffer;
+int EndianedStreamIO_set_count_type(EndianedStreamIO *self, PyObject *value, void *closure)
+{
+    return CountType_FromObject(value, self->count_type);
 }
 
-template <typename T, char endian>
-    requires EndianedOperation<T, endian>
-static PyObject *EndianedStreamIO_read_t(EndianedStreamIO *self, PyObject *args)
+PyGetSetDef EndianedStreamIO_getseters[] = {
+    {"closed", (getter)LOCKED(EndianedIOBase_get_closed), nullptr, "closed", nullptr},
+    {"count_type", (getter)LOCKED(EndianedStreamIO_get_count_type), (setter)LOCKED(EndianedStreamIO_set_count_type), "The encoding of length prefixes, None uses read_count/write_count.", nullptr},
+    {nullptr} /* Sentinel */
+};
+
+/**
+ * @brief Reads up to size bytes from the stream into dst, bypassing the read-ahead buffer.
+ *
+ * @return Py_ssize_t The number of bytes read, less than size only at the end of the stream, or -1 on error
+ */
+static Py_ssize_t _stream_readinto(EndianedStreamIO *self, char *dst, Py_ssize_t size)
 {
-    PyObject *buffer = _read_buffer(self, sizeof(T));
-    if (buffer == nullptr)
+    Py_ssize_t total = 0;
+    while (total < size)
     {
-        return nullptr;
+        Py_ssize_t read_size = 0;
+        if (self->readinto != nullptr)
+        {
+            PyObject *target = PyMemoryView_FromMemory(dst + total, size - total, PyBUF_WRITE);
+            if (target == nullptr)
+            {
+                return -1;
+            }
+            PyObject *py_read = PyObject_CallOneArg(self->readinto, target);
+            Py_DecRef(target);
+            if (py_read == nullptr)
+            {
+                return -1;
+            }
+            // non-blocking streams return None if no data is available
+            read_size = (py_read == Py_None) ? 0 : PyLong_AsSsize_t(py_read);
+            Py_DecRef(py_read);
+            if (read_size < 0)
+            {
+                return -1;
+            }
+        }
+        else
+        {
+            PyObject *py_size = PyLong_FromSsize_t(size - total);
+            PyObject *bytes = PyObject_CallOneArg(self->read, py_size);
+            Py_DecRef(py_size);
+            if (bytes == nullptr)
+            {
+                return -1;
+            }
+            Py_buffer view{};
+            if (PyObject_GetBuffer(bytes, &view, PyBUF_SIMPLE) != 0)
+            {
+                Py_DecRef(bytes);
+                return -1;
+            }
+            read_size = std::min(view.len, size - total);
+            memcpy(dst + total, view.buf, read_size);
+            PyBuffer_Release(&view);
+            Py_DecRef(bytes);
+        }
+        if (read_size == 0)
+        {
+            break;
+        }
+        total += read_size;
     }
-
-    T value{};
-
-    // Read the data from the buffer
-    memcpy(&value, PyBytes_AsString(buffer), sizeof(T));
-    Py_DecRef(buffer);
-
-    handle_swap<EndianedStreamIO, T, endian>(self, value);
-
-    return PyObject_FromAny(value);
+    return total;
 }
 
-static inline bool _read_count(
-    EndianedStreamIO *self,
-    PyObject *py_count,
-    Py_ssize_t &count)
+/**
+ * @brief Writes size bytes to the stream, bypassing the write buffer.
+ *
+ * @return true on failure, false on success
+ */
+static bool _stream_write(EndianedStreamIO *self, const char *src, Py_ssize_t size)
 {
-    if ((py_count == nullptr) || (py_count == Py_None))
+    while (size > 0)
     {
-        PyObject *py_count = PyObject_CallMethod(
-            reinterpret_cast<PyObject *>(self),
-            "read_count",
-            "",
-            nullptr);
-        if (py_count == nullptr)
+        PyObject *view = PyMemoryView_FromMemory(const_cast<char *>(src), size, PyBUF_READ);
+        if (view == nullptr)
         {
-            return false;
+            return true;
         }
-        if (!PyLong_Check(py_count))
+        PyObject *result = PyObject_CallOneArg(self->write, view);
+        Py_DecRef(view);
+        if (result == nullptr)
         {
-            PyErr_SetString(PyExc_TypeError, "read_count didn't return an integer.");
-            Py_DecRef(py_count);
-            return false;
+            return true;
         }
-        count = PyLong_AsSsize_t(py_count);
-        Py_DecRef(py_count);
-        return true;
-    }
-    else if (PyLong_Check(py_count))
-    {
-        count = PyLong_AsSsize_t(py_count);
-        if (count < 0)
+        // raw streams might write less than requested, streams without a result are assumed to write everything
+        Py_ssize_t written = PyLong_Check(result) ? PyLong_AsSsize_t(result) : size;
+        Py_DecRef(result);
+        if (written < 0)
         {
-            PyErr_SetString(PyExc_ValueError, "Invalid size argument.");
-            return false;
+            return true;
         }
-        else if (PyErr_Occurred())
+        if (written == 0)
         {
-            return false;
+            PyErr_SetString(PyExc_OSError, "The stream didn't accept any data.");
+            return true;
         }
-        return true;
+        src += written;
+        size -= written;
     }
-
-    PyErr_SetString(PyExc_TypeError, "Argument must be an integer or None.");
     return false;
 }
 
-template <typename T, char endian>
-    requires EndianedOperation<T, endian>
-static PyObject *EndianedStreamIO_read_array_t(EndianedStreamIO *self, PyObject *arg)
+/**
+ * @brief Writes the pending bytes of the write buffer to the stream.
+ *
+ * @return true on failure, false on success
+ */
+static bool _flush_write_buffer(EndianedStreamIO *self)
 {
-    Py_ssize_t size = 0;
-    if (!_read_count(self, arg, size))
-    {
-        return nullptr;
-    }
+    return EndianedIOBase_flush_write_buffer<EndianedStreamIO, _stream_write>(self);
+}
 
-    PyObject *buffer = _read_buffer(self, sizeof(T) * size);
-    if (buffer == nullptr)
-    {
-        return nullptr;
-    }
+/**
+ * @brief Reads up to size bytes into dst, served from the read-ahead buffer.
+ *
+ * Reads that are larger than the buffer go directly into dst.
+ *
+ * @return Py_ssize_t The number of bytes read, less than size only at the end of the stream, or -1 on error
+ */
+static Py_ssize_t _read_into(EndianedStreamIO *self, char *dst, Py_ssize_t size)
+{
+    return EndianedIOBase_read_into<EndianedStreamIO, _stream_readinto, _stream_write>(self, dst, size);
+}
 
-    // Read the data from the buffer
-    T *data = reinterpret_cast<T *>(PyBytes_AsString(buffer));
-    if (data == nullptr)
+/**
+ * @brief Hands the stream over in its logical position by seeking back over the unread buffered bytes.
+ *
+ * Has to be called before any operation that uses the stream directly.
+ *
+ * @return true on failure, false on success
+ */
+static bool _drop_read_buffer(EndianedStreamIO *self)
+{
+    Py_ssize_t unread = self->read_buffer_len - self->read_buffer_pos;
+    self->read_buffer_pos = 0;
+    self->read_buffer_len = 0;
+    if (unread == 0)
     {
-        Py_DecRef(buffer);
-        return nullptr;
+        return false;
     }
-    PyObject *ret = PyTuple_New(size);
-
-    for (Py_ssize_t i = 0; i < size; ++i)
+    PyObject *result = PyObject_CallFunction(self->seek, "ni", -unread, SEEK_CUR);
+    if (result == nullptr)
     {
-
-        T value = data[i];
-
-        handle_swap<EndianedStreamIO, T, endian>(self, value);
-
-        PyObject *item = PyObject_FromAny(value);
-        if (item == nullptr)
-        {
-            Py_DecRef(ret);
-            Py_DecRef(buffer);
-            return nullptr;
-        }
-        PyTuple_SetItem(ret, i, item); // Steal reference, no need to DECREF
+        return true;
     }
+    Py_DecRef(result);
+    return false;
+}
 
-    Py_DecRef(buffer);
-    return ret;
+/**
+ * @brief Flushes the write buffer and drops the read-ahead buffer,
+ * so that the stream is in the logical position.
+ *
+ * @return true on failure, false on success
+ */
+static bool _sync_stream(EndianedStreamIO *self)
+{
+    return _flush_write_buffer(self) || _drop_read_buffer(self);
 }
 
-PyObject *EndianedStreamIO_align(EndianedStreamIO *self, PyObject *arg)
+/**
+ * @brief Writes size bytes, collected in the write buffer if enabled.
+ *
+ * @return true on failure, false on success
+ */
+static bool _write_raw(EndianedStreamIO *self, const void *src, Py_ssize_t size)
 {
-    Py_ssize_t size;
-    CHECK_SIZE_ARG(arg, size, 4)
-    if (size <= 0)
-    {
-        PyErr_SetString(PyExc_ValueError, "Invalid size argument.");
-        return nullptr;
-    }
-    PyObject *pos = PyObject_CallFunctionObjArgs(
-        self->tell,
-        nullptr);
-    if (pos == nullptr)
-    {
-        return nullptr;
-    }
-    Py_ssize_t current_pos = PyLong_AsSsize_t(pos);
-    Py_DecRef(pos);
-    Py_ssize_t pad = size - (current_pos % size);
-    if (pad != size)
+    if (_drop_read_buffer(self))
     {
-        current_pos += pad;
-        PyObject *new_pos = PyLong_FromSsize_t(current_pos);
-        if (new_pos == nullptr)
-        {
-            return nullptr;
-        }
-        PyObject *seek_result = PyObject_CallFunctionObjArgs(
-            self->seek,
-            new_pos,
-            nullptr);
-        Py_DecRef(new_pos);
-        if (seek_result == nullptr)
-        {
-            return nullptr;
-        }
-        return seek_result;
+        return true;
     }
-    return PyLong_FromSsize_t(current_pos);
+    return EndianedIOBase_write_buffered<EndianedStreamIO, _stream_write>(self, src, size, self->write_buffer_size);
 }
 
-static PyObject *EndianedStreamIO_read_cstring(EndianedStreamIO *self, PyObject *args, PyObject *kwds)
+static inline bool _read_raw(EndianedStreamIO *self, void *dst, Py_ssize_t size)
 {
-    static const char *kwlist[] = {
-        "encoding",
-        "errors",
-        nullptr};
-
-    const char *encoding = "utf-8";         // Default encoding
-    const char *errors = "surrogateescape"; // Default error handling
+    return EndianedIOBase_read_raw<EndianedStreamIO, _read_into>(self, dst, size);
+}
 
-    if (!PyArg_ParseTupleAndKeywords(args, kwds, "|ss",
-                                     const_cast<char **>(kwlist),
-                                     &encoding,
-                                     &errors))
+/**
+ * @brief Gets the logical position, the position of the stream minus the unread buffered bytes.
+ *
+ * @return true on failure, false on success
+ */
+static bool _tell(EndianedStreamIO *self, Py_ssize_t &pos)
+{
+    PyObject *py_pos = PyObject_CallNoArgs(self->tell);
+    if (py_pos == nullptr)
     {
-        return nullptr;
+        return true;
     }
-
-    PyObject *seekable_py = PyObject_CallMethod(
-        reinterpret_cast<PyObject *>(self),
-        "seekable",
-        nullptr);
-    if (seekable_py == nullptr)
+    pos = PyLong_AsSsize_t(py_pos);
+    Py_DecRef(py_pos);
+    if (pos == -1 && PyErr_Occurred())
     {
-        return nullptr;
+        return true;
     }
+    pos -= self->read_buffer_len - self->read_buffer_pos;
+    if (self->write_buffer != nullptr)
+    {
+        pos += self->write_buffer->size();
+    }
+    return false;
+}
 
-    std::string string_buffer;
-    string_buffer.reserve(256); // Reserve some space to avoid frequent reallocations
-    bool seekable = PyObject_IsTrue(seekable_py);
-    Py_DecRef(seekable_py);
-
-    // read in chunks if seekable, otherwise read one byte at a time
-    const Py_ssize_t py_buffer_size = (seekable) ? 256 : 1;
-    PyObject *py_buffer = PyBytes_FromStringAndSize(nullptr, py_buffer_size);
-    char *py_buffer_data = PyBytes_AsString(py_buffer);
-    while (true)
+/**
+ * @brief Seeks to a logical position, within the read-ahead buffer if possible.
+ *
+ * @return PyObject* The new position or nullptr on error
+ */
+static PyObject *_seek(EndianedStreamIO *self, Py_ssize_t offset, int whence)
+{
+    if (self->read_buffer_len > 0 && (whence == SEEK_SET || whence == SEEK_CUR))
     {
-        PyObject *read_bytes_count = PyObject_CallFunctionObjArgs(
-            self->readinto,
-            py_buffer,
-            nullptr);
-        if (read_bytes_count == nullptr)
+        Py_ssize_t pos = 0;
+        if (_tell(self, pos))
         {
-            Py_DecRef(read_bytes_count);
-            Py_DecRef(py_buffer);
             return nullptr;
         }
-        Py_ssize_t read_size = PyBytes_Size(read_bytes_count);
-        if (read_size)
+        const Py_ssize_t target = (whence == SEEK_SET) ? offset : pos + offset;
+        const Py_ssize_t buffer_start = pos - self->read_buffer_pos;
+        if (target >= buffer_start && target <= buffer_start + self->read_buffer_len)
         {
-            // Check for null terminator
-            for (Py_ssize_t i = 0; i < read_size; ++i)
-            {
-                if (py_buffer_data[i] == '\0')
-                {
-                    // Found null terminator, resize string buffer
-                    string_buffer.append(py_buffer_data, i);
-                    // seek back to the position after the null terminator
-                    if (seekable)
-                    {
-                        PyObject *seek_by_py = PyLong_FromSsize_t(-read_size + i);
-                        PyObject *seek_where_py = PyLong_FromSsize_t(1);
-                        PyObject_CallFunctionObjArgs(
-                            self->seek,
-                            seek_by_py,
-                            seek_where_py,
-                            nullptr);
-                        Py_DecRef(seek_by_py);
-                        Py_DecRef(seek_where_py);
-                    }
-                    Py_DecRef(read_bytes_count);
-                    Py_DecRef(py_buffer);
-                    return PyUnicode_Decode(
-                        string_buffer.data(),
-                        string_buffer.size(),
-                        encoding,
-                        errors);
-                }
-            }
-            // Append the read bytes to the string buffer
-            string_buffer.append(py_buffer_data, read_size);
+            self->read_buffer_pos = target - buffer_start;
+            return PyLong_FromSsize_t(target);
         }
-        if (read_size < py_buffer_size)
+        // the stream is still at the end of the buffer, so seek absolute,
+        // the buffer stays valid if the seek fails
+        PyObject *ret = PyObject_CallFunction(self->seek, "ni", target, SEEK_SET);
+        if (ret != nullptr)
         {
-            // If we read less than the buffer size, we reached the end of the stream
-            Py_DecRef(read_bytes_count);
-            Py_DecRef(py_buffer);
-            return PyUnicode_Decode(
-                string_buffer.data(),
-                string_buffer.size(),
-                encoding,
-                errors);
+            self->read_buffer_pos = 0;
+            self->read_buffer_len = 0;
         }
-        Py_DecRef(read_bytes_count);
+        return ret;
     }
-}
-
-static PyObject *EndianedStreamIO_read_bytes(EndianedStreamIO *self, PyObject *arg)
-{
-    Py_ssize_t size = 0;
-    if (!_read_count(self, arg, size))
+    if (_sync_stream(self))
     {
         return nullptr;
     }
-
-    return _read_buffer(self, size);
+    return PyObject_CallFunction(self->seek, "ni", offset, whence);
 }
 
-static PyObject *EndianedStreamIO_read_string(EndianedStreamIO *self, PyObject *args, PyObject *kwds)
-{
-    static const char *kwlist[] = {
-        "length",
-        "encoding",
-        "errors",
-        nullptr};
-
-    PyObject *py_count = nullptr;
-    const char *encoding = "utf-8";         // Default encoding
-    const char *errors = "surrogateescape"; // Default error handling
-
-    if (!PyArg_ParseTupleAndKeywords(args, kwds, "|Oss",
-                                     const_cast<char **>(kwlist),
-                                     &py_count, &encoding,
-                                     &errors))
-    {
-        return nullptr;
-    }
-
-    PyObject *bytes = EndianedStreamIO_read_bytes(self, py_count);
-    if (bytes == nullptr)
-    {
-        return nullptr;
+#define CHECK_STREAM_FUNCTION(function)                                                  \
+    if (self->function == nullptr)                                                     \
+    {                                                                                  \
+        PyErr_SetString(PyExc_AttributeError, "The stream has no " #function "."); \
+        return nullptr;                                                                \
     }
-    PyObject *result = PyUnicode_Decode(
-        PyBytes_AsString(bytes),
-        PyBytes_Size(bytes),
-        encoding,
-        errors);
-    Py_DecRef(bytes);
-    return result;
-}
 
-static PyObject *EndianedStreamIO_read_varint(EndianedStreamIO *self, PyObject *args)
+/**
+ * @brief Reads up to size bytes, everything that is left if size is negative.
+ */
+static PyObject *_read_bytes(EndianedStreamIO *self, Py_ssize_t size)
 {
-    Py_ssize_t value = 0;
-    uint32_t shift = 0;
-
-    PyObject *py_buffer = PyBytes_FromStringAndSize(nullptr, 1);
-    if (py_buffer == nullptr)
-    {
-        return nullptr;
-    }
-    char *byte_buffer = PyBytes_AsString(py_buffer);
-
-    while (true)
+    if (size < 0)
     {
-        PyObject *read_bytes_count = PyObject_CallFunctionObjArgs(
-            self->readinto,
-            py_buffer,
-            nullptr);
-        if (read_bytes_count == nullptr)
+        // the pending writes have to reach the stream before it's read at its position
+        if (_flush_write_buffer(self))
         {
-            Py_DecRef(read_bytes_count);
-            Py_DecRef(py_buffer);
             return nullptr;
         }
-        Py_ssize_t read_size = PyBytes_Size(read_bytes_count);
-        if (read_size < 1)
+        const Py_ssize_t unread = self->read_buffer_len - self->read_buffer_pos;
+        PyObject *ret = PyBytes_FromStringAndSize(unread ? self->read_buffer->data() + self->read_buffer_pos : nullptr, unread);
+        self->read_buffer_pos = 0;
+        self->read_buffer_len = 0;
+        if (ret == nullptr)
         {
-            PyErr_SetString(PyExc_ValueError, "Read exceeds buffer length.");
-            Py_DecRef(read_bytes_count);
-            Py_DecRef(py_buffer);
             return nullptr;
         }
-        Py_DecRef(read_bytes_count);
-
-        value |= (static_cast<Py_ssize_t>(*byte_buffer & 0x7F) << shift);
-        if (!(*byte_buffer & 0x80))
+        PyObject *rest = PyObject_CallNoArgs(self->read);
+        if (rest == nullptr)
         {
-            break;
-        }
-        shift += 7;
-        if (shift >= sizeof(Py_ssize_t) * 8)
-        {
-            PyErr_SetString(PyExc_OverflowError, "Varint too large.");
+            Py_DecRef(ret);
             return nullptr;
         }
+        PyBytes_ConcatAndDel(&ret, rest);
+        return ret;
     }
-    return PyLong_FromSsize_t(value);
-}
-
-static PyObject *EndianedStreamIO_read_varint_array(EndianedStreamIO *self, PyObject *args)
-{
-    Py_ssize_t size = 0;
 
-    if (!_read_count(self, args, size))
+    PyObject *ret = PyBytes_FromStringAndSize(nullptr, size);
+    if (ret == nullptr)
     {
         return nullptr;
     }
-
-    PyObject *ret = PyTuple_New(size);
-
-    for (Py_ssize_t i = 0; i < size; ++i)
+    Py_ssize_t read_size = _read_into(self, PyBytes_AsString(ret), size);
+    if (read_size < 0)
     {
-        PyObject *item = EndianedStreamIO_read_varint(self, nullptr);
-        if (item == nullptr)
-        {
-            Py_DecRef(ret);
-            return nullptr;
-        }
-        PyTuple_SetItem(ret, i, item); // Steal reference, no need to DECREF
+        Py_DecRef(ret);
+        return nullptr;
     }
-    return ret;
-}
-
-inline PyObject *_EndianedStreamIO_write_buffer(EndianedStreamIO *self, PyObject *buffer)
-{
-    PyObject *result = PyObject_CallFunctionObjArgs(
-        self->write,
-        buffer,
-        nullptr);
-    return result;
-}
-
-template <typename T>
-inline PyObject *_EndianedStreamIO_write_raw(EndianedStreamIO *self, T *data, const Py_ssize_t size)
-{
-    PyObject *buffer = PyMemoryView_FromMemory(reinterpret_cast<char *>(data), size, PyBUF_READ);
-    PyObject *result = _EndianedStreamIO_write_buffer(self, buffer);
-    Py_DecRef(buffer);
-    return result;
-}
-
-template <typename T, char endian>
-    requires EndianedOperation<T, endian>
-static PyObject *EndianedStreamIO_write_t(EndianedStreamIO *self, PyObject *arg)
-{
-    T value{};
-    if (!PyObject_ToAny(arg, value))
+    if (read_size != size && _PyBytes_Resize(&ret, read_size) < 0)
     {
-        return nullptr; // Conversion failed
+        return nullptr;
     }
-
-    handle_swap<EndianedStreamIO, T, endian>(self, value);
-    return _EndianedStreamIO_write_raw(self, &value, sizeof(T));
+    return ret;
 }
 
-template <typename T, char endian>
-    requires EndianedOperation<T, endian>
-static PyObject *EndianedStreamIO_write_array_t(EndianedStreamIO *self, PyObject *args, PyObject *kwds)
+static PyObject *EndianedStreamIO_read(EndianedStreamIO *self, PyObject *args)
 {
-    static const char *kwlist[] = {
-        "v",
-        "write_count",
-        nullptr};
-
-    PyObject *v = nullptr;
-    PyObject *write_count_obj = Py_True; // Default to True
-
-    if (!PyArg_ParseTupleAndKeywords(args, kwds, "O|O!",
-                                     const_cast<char **>(kwlist),
-                                     &v,
-                                     &PyBool_Type,
-                                     &write_count_obj))
+    CHECK_STREAM_FUNCTION(read)
+    Py_ssize_t size = -1;
+    PyObject *py_size = Py_None;
+    if (!PyArg_ParseTuple(args, "|O", &py_size))
     {
         return nullptr;
     }
-
-    Py_ssize_t count = PyObject_Size(v);
-    if ((write_count_obj == Py_True) && EndianedIOBase_write_count(self, count))
-    {
-        return nullptr; // Resize failed
-    }
-
-    PyObject *iter = PyObject_GetIter(v);
-    PyObject *item = PyIter_Next(iter);
-
-    // Use uint8_t for bool to avoid std::vector<bool> specialization issues
-    using BufferType = std::conditional_t<std::is_same_v<T, bool>, uint8_t, T>;
-    std::vector<BufferType> buffer;
-    buffer.reserve(count);
-
-    while (item)
+    if (py_size != Py_None)
     {
-        T value{};
-        if (!PyObject_ToAny(item, value))
+        size = PyLong_AsSsize_t(py_size);
+        if (size == -1 && PyErr_Occurred())
         {
-            Py_DecRef(iter);
-            return nullptr; // Conversion failed
+            return nullptr;
         }
-        handle_swap<EndianedStreamIO, T, endian>(self, value);
-        buffer.push_back(static_cast<BufferType>(value));
-        Py_DecRef(item);
-        item = PyIter_Next(iter);
     }
-    Py_DecRef(iter);
-
-    return _EndianedStreamIO_write_raw(self, buffer.data(), buffer.size() * sizeof(BufferType));
+    return _read_bytes(self, size);
 }
 
-static PyObject *EndianedStreamIO_write_cstring(EndianedStreamIO *self, PyObject *args, PyObject *kwds)
+static PyObject *EndianedStreamIO_readinto(EndianedStreamIO *self, PyObject *arg)
 {
-    static const char *kwlist[] = {
-        "string",
-        "encoding",
-        "errors",
-        nullptr};
-
-    const char *encoding = "utf-8";         // Default encoding
-    const char *errors = "surrogateescape"; // Default error handling
-    PyObject *s = nullptr;
-
-    if (!PyArg_ParseTupleAndKeywords(args, kwds, "O|ss",
-                                     const_cast<char **>(kwlist),
-                                     &s,
-                                     &encoding,
-                                     &errors))
+    CHECK_STREAM_FUNCTION(read)
+    Py_buffer view{};
+    if (PyObject_GetBuffer(arg, &view, PyBUF_WRITABLE) != 0)
     {
         return nullptr;
     }
-
-    if (!PyUnicode_Check(s))
-    {
-        PyErr_SetString(PyExc_TypeError, "Argument must be a string.");
-        return nullptr;
-    }
-
-    PyObject *bytes = PyUnicode_AsEncodedString(s, encoding, errors);
-    if (bytes == nullptr)
+    Py_ssize_t read_size = _read_into(self, static_cast<char *>(view.buf), view.len);
+    PyBuffer_Release(&view);
+    if (read_size < 0)
     {
         return nullptr;
     }
+    return PyLong_FromSsize_t(read_size);
+}
 
-    // Create a new bytes object with an extra null terminator
-    Py_ssize_t size = PyBytes_Size(bytes);
-    PyObject *bytes_with_null = PyBytes_FromStringAndSize(nullptr, size + 1);
-    if (bytes_with_null == nullptr)
+static PyObject *EndianedStreamIO_tell(EndianedStreamIO *self, PyObject *unused)
+{
+    CHECK_STREAM_FUNCTION(tell)
+    Py_ssize_t pos = 0;
+    if (_tell(self, pos))
     {
-        Py_DecRef(bytes);
         return nullptr;
     }
-    char *bytes_with_null_data = PyBytes_AsString(bytes_with_null);
-
-    // Copy the original bytes and add the null terminator
-    memcpy(bytes_with_null_data, PyBytes_AsString(bytes), size);
-    bytes_with_null_data[size] = '\0';
-
-    Py_DecRef(bytes);
-
-    // Write the bytes with null terminator to the stream
-    PyObject *result = _EndianedStreamIO_write_buffer(self, bytes_with_null);
-    Py_DecRef(bytes_with_null);
-    return result;
+    return PyLong_FromSsize_t(pos);
 }
 
-static PyObject *EndianedStreamIO_write_string(EndianedStreamIO *self, PyObject *args, PyObject *kwds)
+static PyObject *EndianedStreamIO_seek(EndianedStreamIO *self, PyObject *args)
 {
-    static const char *kwlist[] = {
-        "string",
-        "write_count",
-        "encoding",
-        "errors",
-        nullptr};
-
-    const char *encoding = "utf-8";         // Default encoding
-    const char *errors = "surrogateescape"; // Default error handling
-    PyObject *s = nullptr;
-    PyObject *write_count_obj = Py_False; // Default to False
-
-    if (!PyArg_ParseTupleAndKeywords(args, kwds, "O|O!ss",
-                                     const_cast<char **>(kwlist),
-                                     &s,
-                                     &write_count_obj,
-                                     &encoding,
-                                     &errors))
+    CHECK_STREAM_FUNCTION(seek)
+    Py_ssize_t offset = 0;
+    int whence = SEEK_SET;
+    if (!PyArg_ParseTuple(args, "n|i", &offset, &whence))
     {
         return nullptr;
     }
-    Py_ssize_t string_size = PyUnicode_GetLength(s);
-    if ((write_count_obj == Py_True) && EndianedIOBase_write_count(self, string_size))
-    {
-        return nullptr; // Resize failed
-    }
+    return _seek(self, offset, whence);
+}
 
-    PyObject *bytes = PyUnicode_AsEncodedString(s, encoding, errors);
-    if (bytes == nullptr)
+/**
+ * @brief Calls a function of the stream that depends on the stream position with the given arguments.
+ */
+static PyObject *_call_positioned(EndianedStreamIO *self, PyObject *function, PyObject *args)
+{
+    if (_sync_stream(self))
     {
         return nullptr;
     }
+    return PyObject_Call(function, args, nullptr);
+}
 
-    // Write the bytes to the stream
-    PyObject *result = _EndianedStreamIO_write_buffer(self, bytes);
-    Py_DecRef(bytes);
-    return result;
+static PyObject *EndianedStreamIO_readline(EndianedStreamIO *self, PyObject *args)
+{
+    CHECK_STREAM_FUNCTION(readline)
+    return _call_positioned(self, self->readline, args);
 }
 
-static PyObject *EndianedStreamIO_write_bytes(EndianedStreamIO *self, PyObject *args, PyObject *kwds)
+static PyObject *EndianedStreamIO_readlines(EndianedStreamIO *self, PyObject *args)
 {
-    static const char *kwlist[] = {
-        "data",
-        "write_count",
-        nullptr};
-    Py_buffer v{};
-    PyObject *write_count_obj = Py_True;
+    CHECK_STREAM_FUNCTION(readlines)
+    return _call_positioned(self, self->readlines, args);
+}
 
-    if (!PyArg_ParseTupleAndKeywords(args, kwds, "s*|O!",
-                                     const_cast<char **>(kwlist),
-                                     &v,
-                                     &PyBool_Type,
-                                     &write_count_obj))
+static PyObject *EndianedStreamIO_write(EndianedStreamIO *self, PyObject *arg)
+{
+    CHECK_STREAM_FUNCTION(write)
+    Py_buffer view{};
+    if (PyObject_GetBuffer(arg, &view, PyBUF_SIMPLE) != 0)
     {
         return nullptr;
     }
-
-    if ((write_count_obj == Py_True) && EndianedIOBase_write_count(self, v.len))
+    bool failed = _write_raw(self, view.buf, view.len);
+    PyBuffer_Release(&view);
+    if (failed)
     {
-        PyBuffer_Release(&v);
-        return nullptr; // Resize failed
+        return nullptr;
     }
-
-    return _EndianedStreamIO_write_buffer(self, v.obj);
+    return PyLong_FromSsize_t(view.len);
 }
 
-static PyObject *EndianedStreamIO_write_varint(EndianedStreamIO *self, PyObject *arg)
+static PyObject *EndianedStreamIO_flush(EndianedStreamIO *self, PyObject *unused)
 {
-    Py_ssize_t value = 0;
-    if (!PyArg_ParseTuple(arg, "n", &value))
+    if (_flush_write_buffer(self))
     {
         return nullptr;
     }
-    if (value < 0)
+    if (self->flush == nullptr)
     {
-        PyErr_SetString(PyExc_ValueError, "Varint must be non-negative.");
-        return nullptr;
+        Py_RETURN_NONE;
     }
+    return PyObject_CallNoArgs(self->flush);
+}
 
-    // Create a bytes object to hold the varint
-    char buffer[10]; // Varint can be at most 10 bytes for 64-bit integers
-    int index = 0;
-
-    // Encode the integer as a varint
-    do
-    {
-        uint8_t byte = value & 0x7F; // Get the lowest 7 bits
-        value >>= 7;                 // Shift right by 7 bits
-        if (value != 0)
+static PyObject *EndianedStreamIO_close(EndianedStreamIO *self, PyObject *unused)
+{
+    CHECK_STREAM_FUNCTION(close)
+    // like io.BufferedWriter, the stream is closed even if the flush fails
+    bool failed = _flush_write_buffer(self);
+    self->read_buffer_pos = 0;
+    self->read_buffer_len = 0;
+    SavedException exc;
+    PyObject *result = PyObject_CallNoArgs(self->close);
+    if (failed)
+    {
+        Py_XDECREF(result);
+        if (result != nullptr)
         {
-            byte |= 0x80; // Set the continuation bit if there are more bytes
+            exc.restore();
         }
-        buffer[index++] = static_cast<char>(byte);
-    } while (value != 0 && index < sizeof(buffer));
-
-    return _EndianedStreamIO_write_raw(self, buffer, index);
+        else
+        {
+            exc.discard();
+        }
+        return nullptr;
+    }
+    return result;
 }
 
-static PyObject *EndianedStreamIO_write_varint_array(EndianedStreamIO *self, PyObject *args, PyObject *kwds)
+static PyObject *EndianedStreamIO_truncate(EndianedStreamIO *self, PyObject *args)
 {
-    static const char *kwlist[] = {
-        "v",
-        "write_count",
-        nullptr};
+    CHECK_STREAM_FUNCTION(truncate)
+    return _call_positioned(self, self->truncate, args);
+}
 
-    PyObject *v = nullptr;
-    PyObject *write_count_obj = Py_True; // Default to True
+GENERATE_ENDIANEDIOBASE_BUFFERED_METHODS(EndianedStreamIO);
 
-    if (!PyArg_ParseTupleAndKeywords(args, kwds, "O|O!",
-                                     const_cast<char **>(kwlist),
-                                     &v,
-                                     &PyBool_Type,
-                                     &write_count_obj))
+static PyObject *EndianedStreamIO_read_schema(EndianedStreamIO *self, PyObject *arg)
+{
+    SchemaObject *schema = Schema_FromObject(arg);
+    if (schema == nullptr)
     {
         return nullptr;
     }
+    return Schema_read<EndianedStreamIO, _read_raw>(self, schema);
+}
 
-    Py_ssize_t count = PyObject_Size(v);
-    if ((write_count_obj == Py_True) && EndianedIOBase_write_count(self, count))
+static PyObject *EndianedStreamIO_write_schema(EndianedStreamIO *self, PyObject *args)
+{
+    PyObject *py_schema = nullptr;
+    PyObject *value = nullptr;
+    if (!PyArg_ParseTuple(args, "OO", &py_schema, &value))
+    {
+        return nullptr;
+    }
+    SchemaObject *schema = Schema_FromObject(py_schema);
+    if (schema == nullptr)
     {
-        return nullptr; // Resize failed
+        return nullptr;
     }
+    return Schema_write<EndianedStreamIO, _write_raw>(self, schema, value);
+}
 
-    PyObject *iter = PyObject_GetIter(v);
-    PyObject *item = PyIter_Next(iter);
+// the position hooks of the read_*_at functions
+static inline bool EndianedStreamIO_get_pos(EndianedStreamIO *self, Py_ssize_t &pos)
+{
+    return _tell(self, pos);
+}
 
-    std::vector<uint8_t> buffer(count * 3);
-    uint8_t *buf_ptr = buffer.data();
-    uint8_t *buf_end = buffer.data() + buffer.size();
-    while (item)
-    {
-        // Encode the integer as a varint
-        Py_ssize_t value = PyLong_AsSsize_t(item);
-        if (value < 0)
-        {
-            PyErr_SetString(PyExc_ValueError, "Varint must be non-negative.");
-            Py_DecRef(item);
-            Py_DecRef(iter);
-            return nullptr;
-        }
-        do
-        {
-            uint8_t byte = value & 0x7F; // Get the lowest 7 bits
-            value >>= 7;                 // Shift right by 7 bits
-            if (value != 0)
-            {
-                byte |= 0x80; // Set the continuation bit if there are more bytes
-            }
-            *buf_ptr++ = (byte);
-        } while (value != 0);
+static inline bool EndianedStreamIO_set_pos(EndianedStreamIO *self, Py_ssize_t pos)
+{
+    PyObject *ret = _seek(self, pos, SEEK_SET);
+    Py_XDECREF(ret);
+    return ret == nullptr;
+}
 
-        if ((buf_end - buf_ptr) < 64)
-        {
-            size_t current_pos = buf_ptr - buffer.data();
-            buffer.resize(buffer.size() * 2);
-            buf_ptr = buffer.data() + current_pos;
-            buf_end = buffer.data() + buffer.size();
-        }
-        Py_DecRef(item);
-    }
-    Py_DecRef(iter);
+// the IOLock keeps other calls out while these have the position at the offset
+GENERATE_ENDIANEDIOBASE_SEEKING_AT_METHODS(EndianedStreamIO);
 
-    return _EndianedStreamIO_write_raw(self, buffer.data(), buf_ptr - buffer.data());
+static PyObject *EndianedStreamIO_read_cstring_table(EndianedStreamIO *self, PyObject *args, PyObject *kwds)
+{
+    return EndianedIOBase_read_cstring_table<EndianedStreamIO, EndianedStreamIO_get_pos, EndianedStreamIO_set_pos, EndianedIOBase_read_cstring_raw<EndianedStreamIO, _read_into>>(self, args, kwds);
 }
 
 PyMethodDef EndianedStreamIO_methods[] = {
     GENERATE_ENDIANEDIOBASE_READ_FUNCTIONS(EndianedStreamIO),
+    GENERATE_ENDIANEDIOBASE_READ_AT_FUNCTIONS(EndianedStreamIO),
     GENERATE_ENDIANEDIOBASE_WRITE_FUNCTIONS(EndianedStreamIO),
+    // io functions that have to respect the read-ahead and write buffers
+    {"read",
+     (PyCFunction)LOCKED(EndianedStreamIO_read),
+     METH_VARARGS,
+     "Read up to size bytes, everything that is left if size is omitted or negative."},
+    {"readinto",
+     (PyCFunction)LOCKED(EndianedStreamIO_readinto),
+     METH_O,
+     "Read bytes into a writable buffer."},
+    {"readline",
+     (PyCFunction)LOCKED(EndianedStreamIO_readline),
+     METH_VARARGS,
+     "Read a line from the stream."},
+    {"readlines",
+     (PyCFunction)LOCKED(EndianedStreamIO_readlines),
+     METH_VARARGS,
+     "Read a list of lines from the stream."},
+    {"seek",
+     (PyCFunction)LOCKED(EndianedStreamIO_seek),
+     METH_VARARGS,
+     "Seek to a position in the stream."},
+    {"tell",
+     (PyCFunction)LOCKED(EndianedStreamIO_tell),
+     METH_NOARGS,
+     "Get the current position in the stream."},
+    {"write",
+     (PyCFunction)LOCKED(EndianedStreamIO_write),
+     METH_O,
+     "Write bytes to the stream."},
+    {"flush",
+     (PyCFunction)LOCKED(EndianedStreamIO_flush),
+     METH_NOARGS,
+     "Write the buffered data to the stream and flush it."},
+    {"close",
+     (PyCFunction)LOCKED(EndianedStreamIO_close),
+     METH_NOARGS,
+     "Flush the buffered data and close the stream."},
+    {"truncate",
+     (PyCFunction)LOCKED(EndianedStreamIO_truncate),
+     METH_VARARGS,
+     "Truncate the stream."},
     {"align",
-     (PyCFunction)EndianedStreamIO_align,
+     (PyCFunction)LOCKED(EndianedStreamIO_align),
      METH_O,
      "Align the stream to the specified size."},
+    {"read_view",
+     (PyCFunction)LOCKED(EndianedStreamIO_read_view),
+     METH_O,
+     "Read bytes as a memoryview."},
+    {"read_struct",
+     (PyCFunction)LOCKED(EndianedStreamIO_read_struct),
+     METH_O,
+     "Read a record of a compiled struct format."},
+    {"read_struct_array",
+     (PyCFunction)LOCKED(EndianedStreamIO_read_struct_array),
+     METH_VARARGS | METH_KEYWORDS,
+     "Read a list of records of a compiled struct format."},
+    {"write_struct",
+     (PyCFunction)LOCKED(EndianedStreamIO_write_struct),
+     METH_VARARGS,
+     "Write a record of a compiled struct format."},
+    {"write_struct_array",
+     (PyCFunction)LOCKED(EndianedStreamIO_write_struct_array),
+     METH_VARARGS | METH_KEYWORDS,
+     "Write a list of records of a compiled struct format."},
+    {"read_schema",
+     (PyCFunction)LOCKED(EndianedStreamIO_read_schema),
+     METH_O,
+     "Read an object with a lowered serialization schema."},
+    {"write_schema",
+     (PyCFunction)LOCKED(EndianedStreamIO_write_schema),
+     METH_VARARGS,
+     "Write an object with a lowered serialization schema."},
+    {"read_count",
+     (PyCFunction)LOCKED(EndianedStreamIO_read_count),
+     METH_NOARGS,
+     "Read a length prefix as configured by count_type."},
+    {"write_count",
+     (PyCFunction)LOCKED(EndianedStreamIO_write_count),
+     METH_O,
+     "Write a length prefix as configured by count_type."},
     {NULL} /* Sentinel */
 };
 
@@ -895,9 +876,11 @@ PyType_Slot EndianedStreamIO_slots[] = {
     {Py_tp_new, reinterpret_cast<void *>(PyType_GenericNew)},
     {Py_tp_init, reinterpret_cast<void *>(EndianedStreamIO_init)},
     {Py_tp_dealloc, reinterpret_cast<void *>(EndianedStreamIO_dealloc)},
+    {Py_tp_finalize, reinterpret_cast<void *>(EndianedStreamIO_finalize)},
     {Py_tp_members, EndianedStreamIO_members},
+    {Py_tp_getset, EndianedStreamIO_getseters},
     {Py_tp_methods, EndianedStreamIO_methods},
-    {Py_tp_repr, reinterpret_cast<void *>(EndianedStreamIO_repr)},
+    {Py_tp_repr, reinterpret_cast<void *>(LOCKED(EndianedStreamIO_repr))},
     {0, NULL},
 };
 
@@ -940,7 +923,13 @@ PyMODINIT_FUNC PyInit_EndianedStreamIO(void)
     {
         return NULL;
     }
+    module_set_gil_not_used(m);
     // init_format_num();
+    if (StructFormat_import() < 0 || Schema_import() < 0)
+    {
+        Py_DecRef(m);
+        return NULL;
+    }
     EndianedStreamIO_OT = PyType_FromSpec(&EndianedStreamIO_Spec);
     if (add_object(m, "EndianedStreamIO", EndianedStreamIO_OT) < 0)
     {
@@ -10,11 +10,170 @@
 #include <bit>
 #include <concepts>
 #include <cstdint>
+#include <cstring>
+#include <limits>
 #include <type_traits>
 #include <Python.h>
 #include "./PyFloat_Half.hpp"
+#include "./ByteSwap.hpp"
 
 constexpr bool IS_BIG_ENDIAN_SYSTEM = (std::endian::native == std::endian::big);
+constexpr char NATIVE_ENDIAN = IS_BIG_ENDIAN_SYSTEM ? '>' : '<';
+
+// Backports of C API functions that are newer than the oldest supported Python version
+
+#if PY_VERSION_HEX < 0x03090000
+static inline PyObject *PyObject_CallOneArg(PyObject *callable, PyObject *arg)
+{
+    return PyObject_CallFunctionObjArgs(callable, arg, nullptr);
+}
+#endif
+
+#if PY_VERSION_HEX < 0x03090000
+static inline PyObject *PyObject_CallNoArgs(PyObject *callable)
+{
+    return PyObject_CallFunctionObjArgs(callable, nullptr);
+}
+#endif
+
+#if PY_VERSION_HEX < 0x030A0000
+static inline PyObject *Py_NewRef(PyObject *obj)
+{
+    Py_INCREF(obj);
+    return obj;
+}
+#endif
+
+/**
+ * @brief Converts an int to a C int.
+ *
+ * PyLong_AsInt was only added in 3.13.
+ *
+ * @return int The value, or -1 with an exception set on failure
+ */
+static inline int long_as_int(PyObject *obj)
+{
+#if PY_VERSION_HEX >= 0x030D0000
+    return PyLong_AsInt(obj);
+#else
+    long value = PyLong_AsLong(obj);
+    if (value == -1 && PyErr_Occurred())
+    {
+        return -1;
+    }
+    if (value < std::numeric_limits<int>::min() || value > std::numeric_limits<int>::max())
+    {
+        PyErr_SetString(PyExc_OverflowError, "Python int too large to convert to C int");
+        return -1;
+    }
+    return static_cast<int>(value);
+#endif
+}
+
+/**
+ * @brief Takes the raised exception out of the error indicator while cleanup code runs.
+ *
+ * Either restore() or discard() has to be called exactly once.
+ * PyErr_GetRaisedException replaced PyErr_Fetch in 3.12.
+ */
+struct SavedException
+{
+#if PY_VERSION_HEX >= 0x030C0000
+    PyObject *exc = PyErr_GetRaisedException();
+
+    bool occurred() const { return exc != nullptr; }
+    // sets the exception again, a no-op if none was raised
+    void restore()
+    {
+        if (exc != nullptr)
+        {
+            PyErr_SetRaisedException(exc);
+            exc = nullptr;
+        }
+    }
+    void discard() { Py_CLEAR(exc); }
+#else
+    PyObject *type = nullptr;
+    PyObject *value = nullptr;
+    PyObject *traceback = nullptr;
+
+    SavedException() { PyErr_Fetch(&type, &value, &traceback); }
+    bool occurred() const { return type != nullptr; }
+    // sets the exception again, a no-op if none was raised
+    void restore()
+    {
+        if (type != nullptr)
+        {
+            PyErr_Restore(type, value, traceback);
+            type = value = traceback = nullptr;
+        }
+    }
+    void discard()
+    {
+        Py_CLEAR(type);
+        Py_CLEAR(value);
+        Py_CLEAR(traceback);
+    }
+#endif
+};
+
+/**
+ * @brief Checks if a str equals an ASCII string.
+ *
+ * PyUnicode_EqualToUTF8 was only added in 3.13.
+ */
+static inline bool unicode_equals(PyObject *str, const char *ascii)
+{
+#if PY_VERSION_HEX >= 0x030D0000
+    return PyUnicode_EqualToUTF8(str, ascii);
+#else
+    return PyUnicode_CompareWithASCIIString(str, ascii) == 0;
+#endif
+}
+
+/**
+ * @brief Looks up key in dict, result receives a strong reference or nullptr.
+ *
+ * PyDict_GetItemRef was only added in 3.13.
+ *
+ * @return int 1 if found, 0 if missing, -1 with an exception set on error
+ */
+static inline int dict_get_item_ref(PyObject *dict, PyObject *key, PyObject **result)
+{
+#if PY_VERSION_HEX >= 0x030D0000
+    return PyDict_GetItemRef(dict, key, result);
+#else
+    *result = PyDict_GetItemWithError(dict, key);
+    if (*result == nullptr)
+    {
+        return PyErr_Occurred() ? -1 : 0;
+    }
+    Py_INCREF(*result);
+    return 1;
+#endif
+}
+
+/**
+ * @brief Inserts value unless key is already present, result receives a strong reference to the stored value.
+ *
+ * PyDict_SetDefaultRef was only added in 3.13.
+ *
+ * @return int 1 if key was present, 0 if value was inserted, -1 with an exception set on error
+ */
+static inline int dict_setdefault_ref(PyObject *dict, PyObject *key, PyObject *value, PyObject **result)
+{
+#if PY_VERSION_HEX >= 0x030D0000
+    return PyDict_SetDefaultRef(dict, key, value, result);
+#else
+    *result = PyDict_SetDefault(dict, key, value);
+    if (*result == nullptr)
+    {
+        return -1;
+    }
+    Py_INCREF(*result);
+    return *result == value ? 0 : 1;
+#endif
+}
 
 // A single concept for the scalar types this module supports
 template <typename T>
@@ -203,35 +362,275 @@ concept EndianedIOHandler =
         { value.endian } -> std::same_as<char &>;
     };
 
+/**
+ * @brief Checks if values of T have to be byteswapped for the given endian.
+ *
+ * '<' and '>' are resolved at compile time, '|' uses the endian of the handler.
+ */
+template <typename EI, typename T, char endian>
+    requires(
+        EndianedIOHandler<EI> &&
+        EndianedOperation<T, endian>)
+static inline bool needs_swap(EI *self)
+{
+    if constexpr (sizeof(T) == 1)
+    {
+        return false;
+    }
+    else if constexpr (endian == '<')
+    {
+        return IS_BIG_ENDIAN_SYSTEM;
+    }
+    else if constexpr (endian == '>')
+    {
+        return !IS_BIG_ENDIAN_SYSTEM;
+    }
+    else if constexpr (IS_BIG_ENDIAN_SYSTEM)
+    {
+        return self->endian == '<';
+    }
+    else
+    {
+        return self->endian == '>';
+    }
+}
+
 template <typename EI, typename T, char endian>
     requires(
         EndianedIOHandler<EI> &&
         EndianedOperation<T, endian>)
 static inline void handle_swap(EI *self, T &value)
 {
-    if constexpr ((endian == '<') && IS_BIG_ENDIAN_SYSTEM)
+    if (needs_swap<EI, T, endian>(self))
     {
         value = byteswap(value);
     }
-    else if constexpr ((endian == '>') && !IS_BIG_ENDIAN_SYSTEM)
+}
+
+/**
+ * @brief Byteswaps count values of T in place.
+ *
+ * @param data Pointer to the values, doesn't have to be aligned
+ * @param count Number of values
+ */
+template <typename T>
+    requires EndianedSupportedType<T>
+static inline void byteswap_array(void *data, Py_ssize_t count)
+{
+    byteswap_inplace<sizeof(T)>(data, static_cast<size_t>(count));
+}
+
+/**
+ * @brief Bulk operations on at least this many bytes release the GIL,
+ * below it releasing and reacquiring costs more than the operation itself.
+ */
+constexpr Py_ssize_t NOGIL_THRESHOLD = 1 << 16;
+
+/**
+ * @brief Runs fn without the GIL if size reaches NOGIL_THRESHOLD.
+ *
+ * fn may only touch raw memory that no other thread can free or resize meanwhile,
+ * e.g. held Py_buffer views or memory owned by the caller.
+ * Free-threaded builds have no GIL to release, detaching would only suspend the object locks.
+ */
+template <typename F>
+static inline void nogil(Py_ssize_t size, F &&fn)
+{
+#ifdef Py_GIL_DISABLED
+    if (true)
+#else
+    if (size < NOGIL_THRESHOLD)
+#endif
+    {
+        fn();
+        return;
+    }
+    Py_BEGIN_ALLOW_THREADS
+    fn();
+    Py_END_ALLOW_THREADS
+}
+
+/**
+ * @brief Marks a single-phase init module as safe to run without the GIL.
+ */
+static inline void module_set_gil_not_used(PyObject *module)
+{
+#ifdef Py_GIL_DISABLED
+    PyUnstable_Module_SetGIL(module, Py_MOD_GIL_NOT_USED);
+#endif
+}
+
+/**
+ * @brief The struct module format character of T.
+ */
+template <typename T>
+    requires EndianedSupportedType<T>
+constexpr const char *struct_format()
+{
+    using std::is_same_v;
+    if constexpr (is_same_v<T, bool>)
+        return "?";
+    else if constexpr (is_same_v<T, uint8_t>)
+        return "B";
+    else if constexpr (is_same_v<T, uint16_t>)
+        return "H";
+    else if constexpr (is_same_v<T, uint32_t>)
+        return "I";
+    else if constexpr (is_same_v<T, uint64_t>)
+        return "Q";
+    else if constexpr (is_same_v<T, int8_t>)
+        return "b";
+    else if constexpr (is_same_v<T, int16_t>)
+        return "h";
+    else if constexpr (is_same_v<T, int32_t>)
+        return "i";
+    else if constexpr (is_same_v<T, int64_t>)
+        return "q";
+    else if constexpr (is_same_v<T, half>)
+        return "e";
+    else if constexpr (is_same_v<T, float>)
+        return "f";
+    else if constexpr (is_same_v<T, double>)
+        return "d";
+}
+
+/**
+ * @brief Checks if a buffer format describes values of T.
+ *
+ * Accepts single value struct formats with an optional byte order prefix,
+ * e.g. "I", "<I" or "=L" for uint32_t, as exported by array.array, memoryview or numpy.
+ * Integer codes are matched by signedness and itemsize, so "l" and "q" both match int64_t on LP64.
+ *
+ * @param format The format of the buffer, nullptr means "B"
+ * @param itemsize The itemsize of the buffer
+ * @return char The byte order of the values ('<' or '>') or 0 if the format doesn't match
+ */
+template <typename T>
+    requires EndianedSupportedType<T>
+static inline char buffer_format_endian(const char *format, Py_ssize_t itemsize)
+{
+    using std::is_same_v;
+    if (itemsize != sizeof(T))
     {
-        value = byteswap(value);
+        return 0;
     }
-    else if constexpr (sizeof(T) != 1)
+    if (format == nullptr)
     {
-        if constexpr (IS_BIG_ENDIAN_SYSTEM)
-        {
-            if (self->endian == '<')
-            {
-                value = byteswap(value);
-            }
-        }
-        else
+        format = "B";
+    }
+
+    char endian = NATIVE_ENDIAN;
+    switch (format[0])
+    {
+    case '@':
+    case '=':
+        ++format;
+        break;
+    case '<':
+        endian = '<';
+        ++format;
+        break;
+    case '>':
+    case '!':
+        endian = '>';
+        ++format;
+        break;
+    }
+    if (format[0] == '\0' || format[1] != '\0')
+    {
+        return 0;
+    }
+
+    const char code = format[0];
+    bool match = false;
+    if constexpr (is_same_v<T, bool>)
+        match = code == '?';
+    else if constexpr (is_same_v<T, half>)
+        match = code == 'e';
+    else if constexpr (is_same_v<T, float>)
+        match = code == 'f';
+    else if constexpr (is_same_v<T, double>)
+        match = code == 'd';
+    else if constexpr (std::is_signed_v<T>)
+        match = code == 'b' || code == 'h' || code == 'i' || code == 'l' || code == 'q' || code == 'n';
+    else
+        match = code == 'B' || code == 'H' || code == 'I' || code == 'L' || code == 'Q' || code == 'N';
+
+    return match ? endian : 0;
+}
+
+/**
+ * @brief Gets a contiguous buffer of v if it holds values of T.
+ *
+ * @param v The object to get the buffer from
+ * @param view The buffer to fill, has to be released by the caller if the function returns non-zero
+ * @return char The byte order of the values ('<' or '>') or 0 if v doesn't export a matching buffer
+ */
+template <typename T>
+    requires EndianedSupportedType<T>
+static inline char PyObject_GetAnyArrayBuffer(PyObject *v, Py_buffer *view)
+{
+    if (!PyObject_CheckBuffer(v))
+    {
+        return 0;
+    }
+    if (PyObject_GetBuffer(v, view, PyBUF_FORMAT | PyBUF_C_CONTIGUOUS) != 0)
+    {
+        // not an error for the caller, it falls back to iteration
+        PyErr_Clear();
+        return 0;
+    }
+    char endian = buffer_format_endian<T>(view->format, view->itemsize);
+    if (endian == 0)
+    {
+        PyBuffer_Release(view);
+    }
+    return endian;
+}
+
+/**
+ * @brief Converts count raw values of T to a typed memoryview in native byte order.
+ *
+ * The data is copied once into a new bytes object, swapped in place if required,
+ * and exposed as memoryview cast to the struct format of T.
+ * This avoids creating a Python object per element.
+ *
+ * @param self The endian handler, used to resolve '|'
+ * @param data Pointer to the raw values in the byte order given by endian
+ * @param count Number of values
+ * @return PyObject* A new reference to a memoryview or nullptr on error
+ * @note memoryview supports the 'e' format for half values only since Python 3.12
+ */
+template <typename EI, typename T, char endian>
+    requires(
+        EndianedIOHandler<EI> &&
+        EndianedOperation<T, endian>)
+static inline PyObject *PyMemoryView_FromAnyArray(EI *self, const char *data, Py_ssize_t count)
+{
+    PyObject *bytes = PyBytes_FromStringAndSize(nullptr, count * sizeof(T));
+    if (bytes == nullptr)
+    {
+        return nullptr;
+    }
+    char *dst = PyBytes_AsString(bytes);
+    const bool swap = needs_swap<EI, T, endian>(self);
+    nogil(
+        count * sizeof(T),
+        [&]
         {
-            if (self->endian == '>')
+            memcpy(dst, data, count * sizeof(T));
+            if (swap)
             {
-                value = byteswap(value);
+                byteswap_array<T>(dst, count);
             }
-        }
+        });
+    PyObject *raw = PyMemoryView_FromObject(bytes);
+    Py_DecRef(bytes);
+    if (raw == nullptr)
+    {
+        return nullptr;
     }
+    PyObject *typed = PyObject_CallMethod(raw, "cast", "s", struct_format<T>());
+    Py_DecRef(raw);
+    return typed;
 }
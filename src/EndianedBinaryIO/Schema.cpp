@@ -0,0 +1,117 @@
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "Python.h"
+#include "structmember.h"
+
+#include "PyConverter.hpp"
+#include "Schema.hpp"
+
+static void Schema_dealloc(SchemaObject *self)
+{
+    delete self->root;
+    Py_XDECREF(self->description);
+    PyObject_Del((PyObject *)self);
+}
+
+static int Schema_init(SchemaObject *self, PyObject *args, PyObject *kwds)
+{
+    static const char *kwlist[] = {
+        "description",
+        nullptr};
+
+    PyObject *description = nullptr;
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "O!",
+                                     const_cast<char **>(kwlist),
+                                     &PyTuple_Type, &description))
+    {
+        return -1;
+    }
+
+    SchemaNode *root = new SchemaNode();
+    if (Schema_parse(description, *root) < 0)
+    {
+        delete root;
+        return -1;
+    }
+
+    delete self->root;
+    self->root = root;
+    Py_IncRef(description);
+    Py_XDECREF(self->description);
+    self->description = description;
+    return 0;
+}
+
+static PyObject *Schema_repr(SchemaObject *self)
+{
+    return PyUnicode_FromFormat("<Schema %R>", self->description);
+}
+
+PyMemberDef Schema_members[] = {
+    {"description", T_OBJECT_EX, offsetof(SchemaObject, description), READONLY, "The description tuple."},
+    {NULL} /* Sentinel */
+};
+
+PyType_Slot Schema_slots[] = {
+    {Py_tp_new, reinterpret_cast<void *>(PyType_GenericNew)},
+    {Py_tp_init, reinterpret_cast<void *>(Schema_init)},
+    {Py_tp_dealloc, reinterpret_cast<void *>(Schema_dealloc)},
+    {Py_tp_members, Schema_members},
+    {Py_tp_repr, reinterpret_cast<void *>(Schema_repr)},
+    {0, NULL},
+};
+
+PyType_Spec Schema_Spec = {
+    "bier.EndianedBinaryIO.C.Schema.Schema", // const char* name;
+    sizeof(SchemaObject),                    // int basicsize;
+    0,                                       // int itemsize;
+    Py_TPFLAGS_DEFAULT,                      // unsigned int flags;
+    Schema_slots,                            // PyType_Slot *slots;
+};
+
+static PyModuleDef Schema_module = {
+    PyModuleDef_HEAD_INIT,
+    "bier.EndianedBinaryIO.C.Schema", // Module name
+    "Lowered serialization node trees for the Endianed IO classes.",
+    -1,   // Optional size of the module state memory
+    NULL, // Optional table of module-level functions
+    NULL, // Optional slot definitions
+    NULL, // Optional traversal function
+    NULL, // Optional clear function
+    NULL  // Optional module deallocation function
+};
+
+int add_object(PyObject *module, const char *name, PyObject *object)
+{
+    Py_IncRef(object);
+    if (PyModule_AddObject(module, name, object) < 0)
+    {
+        Py_DecRef(object);
+        Py_DecRef(module);
+        return -1;
+    }
+    return 0;
+}
+
+PyMODINIT_FUNC PyInit_Schema(void)
+{
+    PyObject *m = PyModule_Create(&Schema_module);
+    if (m == NULL)
+    {
+        return NULL;
+    }
+    module_set_gil_not_used(m);
+    PyObject *Schema_OT = PyType_FromSpec(&Schema_Spec);
+    if (Schema_OT == nullptr)
+    {
+        Py_DecRef(m);
+        return NULL;
+    }
+    if (add_object(m, "Schema", Schema_OT) < 0)
+    {
+        return NULL;
+    }
+    return m;
+}
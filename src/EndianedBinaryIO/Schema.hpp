@@ -0,0 +1,783 @@
+/**
+ * @file Schema.hpp
+ * @brief Native execution of lowered bier.serialization node trees.
+ *
+ * bier.serialization.schema lowers a ClassNode tree into nested description tuples,
+ * which the Schema type parses once into a tree of SchemaNodes.
+ * The IO classes then read or write a whole object with a single call of
+ * Schema_read / Schema_write, using their raw read/write functions for the primitives.
+ *
+ * Description tuples:
+ * - ("prim", code)                      primitive with a struct format code
+ * - ("static", length)                  StaticLengthNode
+ * - ("member", name)                    MemberLengthNode
+ * - ("cstring", intern)                 null-terminated StringNode
+ * - ("string", size, encoding, errors, intern) length-prefixed StringNode
+ * - ("bytes", size)                     BytesNode
+ * - ("list", size, elem)                ListNode
+ * - ("tuple", (nodes...))               TupleNode
+ * - ("class", (names...), (nodes...), call)
+ * - ("enum", clz, value)                EnumNode
+ * - ("convert", raw, from_raw, to_raw)  ConvertNode
+ * - ("node", node)                      any other node, executed via its read_from/write_to
+ *
+ * Class, enum and convert nodes call back into Python for the object construction.
+ */
+#pragma once
+#include <algorithm>
+#include <vector>
+#include "PyConverter.hpp"
+#include "EndianedIOBase.hpp"
+#include "StructFormat.hpp"
+
+enum class SchemaOp : char
+{
+    Primitive,
+    StaticLength,
+    MemberLength,
+    CString,
+    String,
+    Bytes,
+    List,
+    Tuple,
+    Class,
+    Enum,
+    Convert,
+    Python,
+};
+
+struct SchemaNode
+{
+    SchemaOp op;
+    char code = 0;                    // Primitive: the struct format code.
+    Py_ssize_t length = 0;            // StaticLength: the fixed length.
+    PyObject *name = nullptr;         // MemberLength: the member name.
+    const char *encoding = nullptr;   // String: the encoding.
+    const char *errors = nullptr;     // String: the error handler.
+    bool intern = false;              // CString, String: use the string cache of the reader.
+    PyObject *call = nullptr;         // Class: from_dict, Enum: the enum, Convert: from_raw, Python: the node.
+    PyObject *call_back = nullptr;    // Convert: to_raw.
+    std::vector<SchemaNode> children; // The size node first, then the element/value/raw node or the fields.
+    std::vector<PyObject *> names;    // Class: the field names.
+};
+
+typedef struct
+{
+    PyObject_HEAD
+        PyObject *description; // The description tuple, owns the objects used by the nodes.
+    SchemaNode *root;          // The parsed root node.
+} SchemaObject;
+
+/**
+ * @brief Parses a description tuple into node.
+ *
+ * The Python objects used by node are borrowed from the description,
+ * which is kept alive by the SchemaObject.
+ *
+ * @return int 0 on success, -1 with an exception set on failure
+ */
+static inline int Schema_parse(PyObject *desc, SchemaNode &node)
+{
+    if (!PyTuple_Check(desc) || PyTuple_GET_SIZE(desc) < 1 || !PyUnicode_Check(PyTuple_GET_ITEM(desc, 0)))
+    {
+        PyErr_SetString(PyExc_TypeError, "Schema description must be a tuple starting with a str tag.");
+        return -1;
+    }
+    PyObject *tag = PyTuple_GET_ITEM(desc, 0);
+    const Py_ssize_t size = PyTuple_GET_SIZE(desc);
+
+    auto expect = [&](Py_ssize_t expected) -> bool
+    {
+        if (size != expected)
+        {
+            PyErr_Format(PyExc_ValueError, "Schema node %R expects %zd items, got %zd.", tag, expected, size);
+            return false;
+        }
+        return true;
+    };
+    auto parse_children = [&](Py_ssize_t start, Py_ssize_t end) -> bool
+    {
+        for (Py_ssize_t i = start; i < end; ++i)
+        {
+            node.children.emplace_back();
+            if (Schema_parse(PyTuple_GET_ITEM(desc, i), node.children.back()) < 0)
+            {
+                return false;
+            }
+        }
+        return true;
+    };
+    auto parse_tuple = [&](PyObject *nodes) -> bool
+    {
+        if (!PyTuple_Check(nodes))
+        {
+            PyErr_Format(PyExc_TypeError, "Schema node %R expects a tuple of nodes.", tag);
+            return false;
+        }
+        for (Py_ssize_t i = 0; i < PyTuple_GET_SIZE(nodes); ++i)
+        {
+            node.children.emplace_back();
+            if (Schema_parse(PyTuple_GET_ITEM(nodes, i), node.children.back()) < 0)
+            {
+                return false;
+            }
+        }
+        return true;
+    };
+
+    if (unicode_equals(tag, "prim"))
+    {
+        if (!expect(2))
+            return -1;
+        PyObject *code = PyTuple_GET_ITEM(desc, 1);
+        if (!PyUnicode_Check(code) || PyUnicode_GetLength(code) != 1)
+        {
+            PyErr_SetString(PyExc_TypeError, "Primitive code must be a single character.");
+            return -1;
+        }
+        node.op = SchemaOp::Primitive;
+        node.code = static_cast<char>(PyUnicode_ReadChar(code, 0));
+        if (node.code == 'x' || node.code == 's' || StructFormat_itemsize(node.code) == 0)
+        {
+            PyErr_Format(PyExc_ValueError, "Bad primitive code: '%c'.", node.code);
+            return -1;
+        }
+        return 0;
+    }
+    if (unicode_equals(tag, "static"))
+    {
+        if (!expect(2))
+            return -1;
+        node.op = SchemaOp::StaticLength;
+        node.length = PyLong_AsSsize_t(PyTuple_GET_ITEM(desc, 1));
+        return (node.length == -1 && PyErr_Occurred()) ? -1 : 0;
+    }
+    if (unicode_equals(tag, "member"))
+    {
+        if (!expect(2))
+            return -1;
+        node.op = SchemaOp::MemberLength;
+        node.name = PyTuple_GET_ITEM(desc, 1);
+        if (!PyUnicode_Check(node.name))
+        {
+            PyErr_SetString(PyExc_TypeError, "Member name must be a str.");
+            return -1;
+        }
+        return 0;
+    }
+    if (unicode_equals(tag, "cstring"))
+    {
+        if (!expect(2))
+            return -1;
+        node.op = SchemaOp::CString;
+        int intern = PyObject_IsTrue(PyTuple_GET_ITEM(desc, 1));
+        node.intern = intern > 0;
+        return intern < 0 ? -1 : 0;
+    }
+    if (unicode_equals(tag, "string"))
+    {
+        if (!expect(5))
+            return -1;
+        node.op = SchemaOp::String;
+        node.encoding = PyUnicode_AsUTF8(PyTuple_GET_ITEM(desc, 2));
+        node.errors = PyUnicode_AsUTF8(PyTuple_GET_ITEM(desc, 3));
+        if (node.encoding == nullptr || node.errors == nullptr)
+        {
+            return -1;
+        }
+        int intern = PyObject_IsTrue(PyTuple_GET_ITEM(desc, 4));
+        if (intern < 0)
+        {
+            return -1;
+        }
+        node.intern = intern > 0;
+        return parse_children(1, 2) ? 0 : -1;
+    }
+    if (unicode_equals(tag, "bytes"))
+    {
+        if (!expect(2))
+            return -1;
+        node.op = SchemaOp::Bytes;
+        return parse_children(1, 2) ? 0 : -1;
+    }
+    if (unicode_equals(tag, "list"))
+    {
+        if (!expect(3))
+            return -1;
+        node.op = SchemaOp::List;
+        return parse_children(1, 3) ? 0 : -1;
+    }
+    if (unicode_equals(tag, "tuple"))
+    {
+        if (!expect(2))
+            return -1;
+        node.op = SchemaOp::Tuple;
+        return parse_tuple(PyTuple_GET_ITEM(desc, 1)) ? 0 : -1;
+    }
+    if (unicode_equals(tag, "class"))
+    {
+        if (!expect(4))
+            return -1;
+        node.op = SchemaOp::Class;
+        PyObject *names = PyTuple_GET_ITEM(desc, 1);
+        if (!PyTuple_Check(names))
+        {
+            PyErr_SetString(PyExc_TypeError, "Class names must be a tuple.");
+            return -1;
+        }
+        for (Py_ssize_t i = 0; i < PyTuple_GET_SIZE(names); ++i)
+        {
+            if (!PyUnicode_Check(PyTuple_GET_ITEM(names, i)))
+            {
+                PyErr_SetString(PyExc_TypeError, "Class names must be str.");
+                return -1;
+            }
+            node.names.push_back(PyTuple_GET_ITEM(names, i));
+        }
+        if (!parse_tuple(PyTuple_GET_ITEM(desc, 2)))
+        {
+            return -1;
+        }
+        if (node.children.size() != node.names.size())
+        {
+            PyErr_SetString(PyExc_ValueError, "Class names and nodes must have the same length.");
+            return -1;
+        }
+        node.call = PyTuple_GET_ITEM(desc, 3);
+        return 0;
+    }
+    if (unicode_equals(tag, "enum"))
+    {
+        if (!expect(3))
+            return -1;
+        node.op = SchemaOp::Enum;
+        node.call = PyTuple_GET_ITEM(desc, 1);
+        return parse_children(2, 3) ? 0 : -1;
+    }
+    if (unicode_equals(tag, "convert"))
+    {
+        if (!expect(4))
+            return -1;
+        node.op = SchemaOp::Convert;
+        node.call = PyTuple_GET_ITEM(desc, 2);
+        node.call_back = PyTuple_GET_ITEM(desc, 3);
+        return parse_children(1, 2) ? 0 : -1;
+    }
+    if (unicode_equals(tag, "node"))
+    {
+        if (!expect(2))
+            return -1;
+        node.op = SchemaOp::Python;
+        node.call = PyTuple_GET_ITEM(desc, 1);
+        return 0;
+    }
+    PyErr_Format(PyExc_ValueError, "Unknown schema node %R.", tag);
+    return -1;
+}
+
+template <typename EI, bool (*read_raw)(EI *, void *, Py_ssize_t)>
+    requires EndianedIOHandler<EI>
+static PyObject *Schema_read_node(EI *self, const SchemaNode &node, PyObject *context);
+
+/**
+ * @brief Reads a size node and converts the result to a non-negative length.
+ *
+ * @return true on failure, with an exception set
+ */
+template <typename EI, bool (*read_raw)(EI *, void *, Py_ssize_t)>
+    requires EndianedIOHandler<EI>
+static inline bool Schema_read_size(EI *self, const SchemaNode &node, PyObject *context, Py_ssize_t &size)
+{
+    PyObject *value = Schema_read_node<EI, read_raw>(self, node, context);
+    if (value == nullptr)
+    {
+        return true;
+    }
+    size = PyLong_AsSsize_t(value);
+    Py_DecRef(value);
+    if (size < 0)
+    {
+        if (!PyErr_Occurred())
+        {
+            PyErr_SetString(PyExc_ValueError, "Length must be non-negative.");
+        }
+        return true;
+    }
+    return false;
+}
+
+/**
+ * @brief Reads the value of a node.
+ *
+ * The backend provides read_raw(self, dst, size), which returns true on failure.
+ * context is the dict of the fields of the enclosing class read so far, or None.
+ *
+ * @return PyObject* A new reference or nullptr on error
+ */
+template <typename EI, bool (*read_raw)(EI *, void *, Py_ssize_t)>
+    requires EndianedIOHandler<EI>
+static PyObject *Schema_read_node(EI *self, const SchemaNode &node, PyObject *context)
+{
+    switch (node.op)
+    {
+    case SchemaOp::Primitive:
+    {
+        PyObject *ret = nullptr;
+        StructFormat_dispatch(
+            node.code,
+            [&]<typename T>() -> bool
+            {
+                T value{};
+                if (read_raw(self, &value, sizeof(T)))
+                {
+                    return false;
+                }
+                handle_swap<EI, T, '|'>(self, value);
+                ret = PyObject_FromAny(value);
+                return ret != nullptr;
+            });
+        return ret;
+    }
+    case SchemaOp::StaticLength:
+        return PyLong_FromSsize_t(node.length);
+    case SchemaOp::MemberLength:
+    {
+        PyObject *value = PyDict_Check(context) ? PyDict_GetItemWithError(context, node.name) : nullptr;
+        if (value == nullptr || !PyLong_Check(value))
+        {
+            if (!PyErr_Occurred())
+            {
+                PyErr_Format(PyExc_AssertionError, "Member %U was not read before or is not an int.", node.name);
+            }
+            return nullptr;
+        }
+        Py_IncRef(value);
+        return value;
+    }
+    case SchemaOp::CString:
+    {
+        // like read_cstring, always utf-8 with surrogateescape
+        std::vector<char> buffer;
+        char c = 0;
+        while (true)
+        {
+            if (read_raw(self, &c, 1))
+            {
+                return nullptr;
+            }
+            if (c == '\0')
+            {
+                break;
+            }
+            buffer.push_back(c);
+        }
+        StringDecoder decoder;
+        if (EndianedIOBase_init_decoder(self, decoder, "utf-8", "surrogateescape", node.intern))
+        {
+            return nullptr;
+        }
+        return decoder.decode(buffer.data(), static_cast<Py_ssize_t>(buffer.size()));
+    }
+    case SchemaOp::String:
+    {
+        Py_ssize_t size = 0;
+        if (Schema_read_size<EI, read_raw>(self, node.children[0], context, size))
+        {
+            return nullptr;
+        }
+        // sizes come from the data, so allocate through Python to get a MemoryError instead of std::bad_alloc
+        PyObject *raw = PyBytes_FromStringAndSize(nullptr, size);
+        if (raw == nullptr)
+        {
+            return nullptr;
+        }
+        StringDecoder decoder;
+        if (read_raw(self, PyBytes_AS_STRING(raw), size) ||
+            EndianedIOBase_init_decoder(self, decoder, node.encoding, node.errors, node.intern))
+        {
+            Py_DecRef(raw);
+            return nullptr;
+        }
+        PyObject *ret = decoder.decode(PyBytes_AS_STRING(raw), size);
+        Py_DecRef(raw);
+        return ret;
+    }
+    case SchemaOp::Bytes:
+    {
+        Py_ssize_t size = 0;
+        if (Schema_read_size<EI, read_raw>(self, node.children[0], context, size))
+        {
+            return nullptr;
+        }
+        PyObject *ret = PyBytes_FromStringAndSize(nullptr, size);
+        if (ret == nullptr)
+        {
+            return nullptr;
+        }
+        if (read_raw(self, PyBytes_AsString(ret), size))
+        {
+            Py_DecRef(ret);
+            return nullptr;
+        }
+        return ret;
+    }
+    case SchemaOp::List:
+    {
+        Py_ssize_t size = 0;
+        if (Schema_read_size<EI, read_raw>(self, node.children[0], context, size))
+        {
+            return nullptr;
+        }
+        PyObject *ret = PyList_New(size);
+        if (ret == nullptr)
+        {
+            return nullptr;
+        }
+        for (Py_ssize_t i = 0; i < size; ++i)
+        {
+            PyObject *item = Schema_read_node<EI, read_raw>(self, node.children[1], context);
+            if (item == nullptr)
+            {
+                Py_DecRef(ret);
+                return nullptr;
+            }
+            PyList_SET_ITEM(ret, i, item); // Steal reference, no need to DECREF
+        }
+        return ret;
+    }
+    case SchemaOp::Tuple:
+    {
+        PyObject *ret = PyTuple_New(node.children.size());
+        if (ret == nullptr)
+        {
+            return nullptr;
+        }
+        for (size_t i = 0; i < node.children.size(); ++i)
+        {
+            PyObject *item = Schema_read_node<EI, read_raw>(self, node.children[i], context);
+            if (item == nullptr)
+            {
+                Py_DecRef(ret);
+                return nullptr;
+            }
+            PyTuple_SET_ITEM(ret, i, item); // Steal reference, no need to DECREF
+        }
+        return ret;
+    }
+    case SchemaOp::Class:
+    {
+        // like ClassNode, the fields read so far are the context of the members
+        PyObject *fields = PyDict_New();
+        if (fields == nullptr)
+        {
+            return nullptr;
+        }
+        for (size_t i = 0; i < node.children.size(); ++i)
+        {
+            PyObject *item = Schema_read_node<EI, read_raw>(self, node.children[i], fields);
+            if (item == nullptr || PyDict_SetItem(fields, node.names[i], item) < 0)
+            {
+                Py_XDECREF(item);
+                Py_DecRef(fields);
+                return nullptr;
+            }
+            Py_DecRef(item);
+        }
+        PyObject *ret = PyObject_CallOneArg(node.call, fields);
+        Py_DecRef(fields);
+        return ret;
+    }
+    case SchemaOp::Enum:
+    case SchemaOp::Convert:
+    {
+        PyObject *raw = Schema_read_node<EI, read_raw>(self, node.children[0], context);
+        if (raw == nullptr)
+        {
+            return nullptr;
+        }
+        PyObject *ret = PyObject_CallOneArg(node.call, raw);
+        Py_DecRef(raw);
+        return ret;
+    }
+    case SchemaOp::Python:
+        return PyObject_CallMethod(node.call, "read_from", "OO", reinterpret_cast<PyObject *>(self), context);
+    }
+    PyErr_SetString(PyExc_SystemError, "Invalid schema node.");
+    return nullptr;
+}
+
+template <typename EI, bool (*write_raw)(EI *, const void *, Py_ssize_t)>
+    requires EndianedIOHandler<EI>
+static Py_ssize_t Schema_write_node(EI *self, const SchemaNode &node, PyObject *value, PyObject *context);
+
+/**
+ * @brief Writes a length through a size node.
+ *
+ * @return Py_ssize_t The number of bytes written or -1 with an exception set on failure
+ */
+template <typename EI, bool (*write_raw)(EI *, const void *, Py_ssize_t)>
+    requires EndianedIOHandler<EI>
+static inline Py_ssize_t Schema_write_size(EI *self, const SchemaNode &node, Py_ssize_t size, PyObject *context)
+{
+    PyObject *value = PyLong_FromSsize_t(size);
+    if (value == nullptr)
+    {
+        return -1;
+    }
+    Py_ssize_t written = Schema_write_node<EI, write_raw>(self, node, value, context);
+    Py_DecRef(value);
+    return written;
+}
+
+/**
+ * @brief Writes a value with a node.
+ *
+ * The backend provides write_raw(self, src, size), which returns true on failure.
+ * context is the object that owns the value, or None.
+ *
+ * @return Py_ssize_t The number of bytes written or -1 with an exception set on failure
+ */
+template <typename EI, bool (*write_raw)(EI *, const void *, Py_ssize_t)>
+    requires EndianedIOHandler<EI>
+static Py_ssize_t Schema_write_node(EI *self, const SchemaNode &node, PyObject *value, PyObject *context)
+{
+    switch (node.op)
+    {
+    case SchemaOp::Primitive:
+    {
+        Py_ssize_t written = -1;
+        StructFormat_dispatch(
+            node.code,
+            [&]<typename T>() -> bool
+            {
+                T raw{};
+                if (!PyObject_ToAny(value, raw))
+                {
+                    return false;
+                }
+                handle_swap<EI, T, '|'>(self, raw);
+                if (write_raw(self, &raw, sizeof(T)))
+                {
+                    return false;
+                }
+                written = sizeof(T);
+                return true;
+            });
+        return written;
+    }
+    case SchemaOp::StaticLength:
+    {
+        Py_ssize_t size = PyLong_AsSsize_t(value);
+        if (size == -1 && PyErr_Occurred())
+        {
+            return -1;
+        }
+        if (size != node.length)
+        {
+            PyErr_Format(PyExc_AssertionError, "Expected %zd values, got %zd values", node.length, size);
+            return -1;
+        }
+        return 0;
+    }
+    case SchemaOp::MemberLength:
+    {
+        PyObject *expected = PyObject_GetAttr(context, node.name);
+        if (expected == nullptr)
+        {
+            return -1;
+        }
+        int equal = PyObject_RichCompareBool(expected, value, Py_EQ);
+        if (equal == 0)
+        {
+            PyErr_Format(PyExc_AssertionError, "Expected %S values, got %S values", expected, value);
+        }
+        Py_DecRef(expected);
+        return equal == 1 ? 0 : -1;
+    }
+    case SchemaOp::CString:
+    {
+        PyObject *encoded = PyUnicode_AsEncodedString(value, "utf-8", "surrogateescape");
+        if (encoded == nullptr)
+        {
+            return -1;
+        }
+        // write the string with its null terminator
+        Py_ssize_t size = PyBytes_GET_SIZE(encoded) + 1;
+        bool failed = write_raw(self, PyBytes_AS_STRING(encoded), size);
+        Py_DecRef(encoded);
+        return failed ? -1 : size;
+    }
+    case SchemaOp::String:
+    case SchemaOp::Bytes:
+    {
+        PyObject *encoded = nullptr;
+        if (node.op == SchemaOp::String)
+        {
+            encoded = PyUnicode_AsEncodedString(value, node.encoding, node.errors);
+            if (encoded == nullptr)
+            {
+                return -1;
+            }
+            value = encoded;
+        }
+        Py_buffer view{};
+        if (PyObject_GetBuffer(value, &view, PyBUF_SIMPLE) != 0)
+        {
+            Py_XDECREF(encoded);
+            return -1;
+        }
+        Py_ssize_t written = Schema_write_size<EI, write_raw>(self, node.children[0], view.len, context);
+        if (written >= 0)
+        {
+            written = write_raw(self, view.buf, view.len) ? -1 : written + view.len;
+        }
+        PyBuffer_Release(&view);
+        Py_XDECREF(encoded);
+        return written;
+    }
+    case SchemaOp::List:
+    case SchemaOp::Tuple:
+    {
+        PyObject *seq = PySequence_Fast(value, "Value must be a sequence.");
+        if (seq == nullptr)
+        {
+            return -1;
+        }
+        Py_ssize_t size = PySequence_Fast_GET_SIZE(seq);
+        PyObject **items = PySequence_Fast_ITEMS(seq);
+        Py_ssize_t written = 0;
+        if (node.op == SchemaOp::List)
+        {
+            written = Schema_write_size<EI, write_raw>(self, node.children[0], size, context);
+            for (Py_ssize_t i = 0; i < size && written >= 0; ++i)
+            {
+                Py_ssize_t item_written = Schema_write_node<EI, write_raw>(self, node.children[1], items[i], context);
+                written = item_written < 0 ? -1 : written + item_written;
+            }
+        }
+        else
+        {
+            // like zip in TupleNode, extra values are ignored
+            size = std::min(size, static_cast<Py_ssize_t>(node.children.size()));
+            for (Py_ssize_t i = 0; i < size && written >= 0; ++i)
+            {
+                Py_ssize_t item_written = Schema_write_node<EI, write_raw>(self, node.children[i], items[i], context);
+                written = item_written < 0 ? -1 : written + item_written;
+            }
+        }
+        Py_DecRef(seq);
+        return written;
+    }
+    case SchemaOp::Class:
+    {
+        Py_ssize_t written = 0;
+        for (size_t i = 0; i < node.children.size(); ++i)
+        {
+            PyObject *item = PyObject_GetAttr(value, node.names[i]);
+            if (item == nullptr)
+            {
+                return -1;
+            }
+            Py_ssize_t item_written = Schema_write_node<EI, write_raw>(self, node.children[i], item, value);
+            Py_DecRef(item);
+            if (item_written < 0)
+            {
+                return -1;
+            }
+            written += item_written;
+        }
+        return written;
+    }
+    case SchemaOp::Enum:
+    case SchemaOp::Convert:
+    {
+        PyObject *raw = node.op == SchemaOp::Enum
+                            ? PyObject_GetAttrString(value, "value")
+                            : PyObject_CallOneArg(node.call_back, value);
+        if (raw == nullptr)
+        {
+            return -1;
+        }
+        Py_ssize_t written = Schema_write_node<EI, write_raw>(self, node.children[0], raw, context);
+        Py_DecRef(raw);
+        return written;
+    }
+    case SchemaOp::Python:
+    {
+        PyObject *ret = PyObject_CallMethod(node.call, "write_to", "OOO", value, reinterpret_cast<PyObject *>(self), context);
+        if (ret == nullptr)
+        {
+            return -1;
+        }
+        Py_ssize_t written = PyLong_AsSsize_t(ret);
+        Py_DecRef(ret);
+        return written;
+    }
+    }
+    PyErr_SetString(PyExc_SystemError, "Invalid schema node.");
+    return -1;
+}
+
+// set by Schema_import in the IO modules
+static PyObject *Schema_Type = nullptr;
+
+/**
+ * @brief Imports the Schema type.
+ *
+ * @return int 0 on success, -1 with an exception set on failure
+ */
+static inline int Schema_import()
+{
+    PyObject *module = PyImport_ImportModule("bier.EndianedBinaryIO.C.Schema");
+    if (module == nullptr)
+    {
+        return -1;
+    }
+    Schema_Type = PyObject_GetAttrString(module, "Schema");
+    Py_DecRef(module);
+    return Schema_Type == nullptr ? -1 : 0;
+}
+
+/**
+ * @brief Checks that obj is a Schema.
+ *
+ * @return SchemaObject* A borrowed reference or nullptr with a TypeError set
+ */
+static inline SchemaObject *Schema_FromObject(PyObject *obj)
+{
+    if (!PyObject_TypeCheck(obj, reinterpret_cast<PyTypeObject *>(Schema_Type)))
+    {
+        PyErr_SetString(PyExc_TypeError, "Expected a Schema.");
+        return nullptr;
+    }
+    return reinterpret_cast<SchemaObject *>(obj);
+}
+
+/**
+ * @brief Reads an object with a schema.
+ *
+ * @return PyObject* A new reference or nullptr on error
+ */
+template <typename EI, bool (*read_raw)(EI *, void *, Py_ssize_t)>
+    requires EndianedIOHandler<EI>
+static inline PyObject *Schema_read(EI *self, SchemaObject *schema)
+{
+    return Schema_read_node<EI, read_raw>(self, *schema->root, Py_None);
+}
+
+/**
+ * @brief Writes an object with a schema.
+ *
+ * @return PyObject* The number of bytes written or nullptr on error
+ */
+template <typename EI, bool (*write_raw)(EI *, const void *, Py_ssize_t)>
+    requires EndianedIOHandler<EI>
+static inline PyObject *Schema_write(EI *self, SchemaObject *schema, PyObject *value)
+{
+    Py_ssize_t written = Schema_write_node<EI, write_raw>(self, *schema->root, value, Py_None);
+    if (written < 0)
+    {
+        return nullptr;
+    }
+    return PyLong_FromSsize_t(written);
+}
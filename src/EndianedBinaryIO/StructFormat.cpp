@@ -0,0 +1,239 @@
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "Python.h"
+#include "structmember.h"
+
+#include "PyConverter.hpp"
+#include "StructFormat.hpp"
+
+// format string -> StructFormat, filled by compile
+static PyObject *StructFormat_cache = nullptr;
+// cleared once it's full, like the cache of the struct module, so runtime built formats can't grow it forever
+constexpr Py_ssize_t STRUCTFORMAT_MAXCACHE = 100;
+
+static void StructFormat_dealloc(StructFormatObject *self)
+{
+    Py_XDECREF(self->format);
+    delete self->ops;
+    PyTypeObject *type = Py_TYPE(self);
+    reinterpret_cast<freefunc>(PyType_GetSlot(type, Py_tp_free))(self);
+    // heap type instances own a reference to their type
+    Py_DecRef(reinterpret_cast<PyObject *>(type));
+}
+
+static int StructFormat_init(StructFormatObject *self, PyObject *args, PyObject *kwds)
+{
+    static const char *kwlist[] = {
+        "format",
+        nullptr};
+
+    PyObject *format = nullptr;
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "U",
+                                     const_cast<char **>(kwlist),
+                                     &format))
+    {
+        return -1;
+    }
+
+    const char *format_str = PyUnicode_AsUTF8(format);
+    if (format_str == nullptr)
+    {
+        return -1;
+    }
+    if (self->ops == nullptr)
+    {
+        self->ops = new std::vector<StructFormatOp>();
+    }
+    if (StructFormat_parse(self, format_str) < 0)
+    {
+        return -1;
+    }
+
+    Py_IncRef(format);
+    Py_XDECREF(self->format);
+    self->format = format;
+    return 0;
+}
+
+static PyObject *StructFormat_repr(StructFormatObject *self)
+{
+    return PyUnicode_FromFormat("<StructFormat format=%R size=%zd>", self->format, self->size);
+}
+
+PyMemberDef StructFormat_members[] = {
+    {"format", T_OBJECT_EX, offsetof(StructFormatObject, format), READONLY, "The format string."},
+    {"size", T_PYSSIZET, offsetof(StructFormatObject, size), READONLY, "The size of a record in bytes."},
+    {"length", T_PYSSIZET, offsetof(StructFormatObject, length), READONLY, "The number of values in a record."},
+    {NULL} /* Sentinel */
+};
+
+/**
+ * @brief Checks the optional endian argument of unpack and pack.
+ *
+ * @return true on failure, false on success
+ */
+static inline bool StructFormat_check_endian(int endian)
+{
+    if (endian != '<' && endian != '>')
+    {
+        PyErr_SetString(PyExc_ValueError, "Endian must be '<' or '>'.");
+        return true;
+    }
+    return false;
+}
+
+static PyObject *StructFormat_unpack_from(StructFormatObject *self, PyObject *args)
+{
+    Py_buffer view{};
+    // "C" stores an int
+    int endian = NATIVE_ENDIAN;
+    if (!PyArg_ParseTuple(args, "y*|C", &view, &endian))
+    {
+        return nullptr;
+    }
+    if (StructFormat_check_endian(endian))
+    {
+        PyBuffer_Release(&view);
+        return nullptr;
+    }
+    if (view.len < self->size)
+    {
+        PyBuffer_Release(&view);
+        PyErr_Format(PyExc_ValueError, "Buffer too small: expected %zd, got %zd", self->size, view.len);
+        return nullptr;
+    }
+    PyObject *ret = StructFormat_unpack(self, static_cast<const char *>(view.buf), StructFormat_endian(self, static_cast<char>(endian)));
+    PyBuffer_Release(&view);
+    return ret;
+}
+
+static PyObject *StructFormat_pack_values(StructFormatObject *self, PyObject *args)
+{
+    PyObject *values = nullptr;
+    // "C" stores an int
+    int endian = NATIVE_ENDIAN;
+    if (!PyArg_ParseTuple(args, "O|C", &values, &endian) || StructFormat_check_endian(endian))
+    {
+        return nullptr;
+    }
+    PyObject *ret = PyBytes_FromStringAndSize(nullptr, self->size);
+    if (ret == nullptr)
+    {
+        return nullptr;
+    }
+    if (StructFormat_pack(self, values, PyBytes_AsString(ret), StructFormat_endian(self, static_cast<char>(endian))) < 0)
+    {
+        Py_DecRef(ret);
+        return nullptr;
+    }
+    return ret;
+}
+
+PyMethodDef StructFormat_methods[] = {
+    {"unpack", reinterpret_cast<PyCFunction>(StructFormat_unpack_from), METH_VARARGS, "Unpack a record from a buffer, the optional endian is used for native order formats."},
+    {"pack", reinterpret_cast<PyCFunction>(StructFormat_pack_values), METH_VARARGS, "Pack a sequence of values, the optional endian is used for native order formats."},
+    {NULL} /* Sentinel */
+};
+
+PyType_Slot StructFormat_slots[] = {
+    {Py_tp_new, reinterpret_cast<void *>(PyType_GenericNew)},
+    {Py_tp_init, reinterpret_cast<void *>(StructFormat_init)},
+    {Py_tp_dealloc, reinterpret_cast<void *>(StructFormat_dealloc)},
+    {Py_tp_members, StructFormat_members},
+    {Py_tp_methods, StructFormat_methods},
+    {Py_tp_repr, reinterpret_cast<void *>(StructFormat_repr)},
+    {0, NULL},
+};
+
+PyType_Spec StructFormat_Spec = {
+    "bier.EndianedBinaryIO.C.StructFormat.StructFormat", // const char* name;
+    sizeof(StructFormatObject),                          // int basicsize;
+    0,                                                   // int itemsize;
+    Py_TPFLAGS_DEFAULT,                                  // unsigned int flags;
+    StructFormat_slots,                                  // PyType_Slot *slots;
+};
+
+static PyObject *StructFormat_OT = nullptr;
+
+static PyObject *StructFormat_compile_cached(PyObject *module, PyObject *format)
+{
+    if (!PyUnicode_Check(format))
+    {
+        PyErr_SetString(PyExc_TypeError, "Format must be a str.");
+        return nullptr;
+    }
+    // strong references, a borrowed one isn't safe without the GIL
+    PyObject *compiled = nullptr;
+    int found = dict_get_item_ref(StructFormat_cache, format, &compiled);
+    if (found != 0)
+    {
+        return compiled; // nullptr on error
+    }
+    compiled = PyObject_CallOneArg(StructFormat_OT, format);
+    if (compiled == nullptr)
+    {
+        return nullptr;
+    }
+    if (PyDict_Size(StructFormat_cache) >= STRUCTFORMAT_MAXCACHE)
+    {
+        PyDict_Clear(StructFormat_cache);
+    }
+    // another thread might have compiled the same format meanwhile, keep the first one
+    PyObject *cached = nullptr;
+    int result = dict_setdefault_ref(StructFormat_cache, format, compiled, &cached);
+    Py_DecRef(compiled);
+    return result < 0 ? nullptr : cached;
+}
+
+static PyMethodDef StructFormat_module_methods[] = {
+    {"compile", reinterpret_cast<PyCFunction>(StructFormat_compile_cached), METH_O, "Compile a struct format, results are cached by format string."},
+    {NULL} /* Sentinel */
+};
+
+static PyModuleDef StructFormat_module = {
+    PyModuleDef_HEAD_INIT,
+    "bier.EndianedBinaryIO.C.StructFormat", // Module name
+    "Compiled struct formats for the Endianed IO classes.",
+    -1,                          // Optional size of the module state memory
+    StructFormat_module_methods, // Optional table of module-level functions
+    NULL,                        // Optional slot definitions
+    NULL,                        // Optional traversal function
+    NULL,                        // Optional clear function
+    NULL                         // Optional module deallocation function
+};
+
+int add_object(PyObject *module, const char *name, PyObject *object)
+{
+    Py_IncRef(object);
+    if (PyModule_AddObject(module, name, object) < 0)
+    {
+        Py_DecRef(object);
+        Py_DecRef(module);
+        return -1;
+    }
+    return 0;
+}
+
+PyMODINIT_FUNC PyInit_StructFormat(void)
+{
+    PyObject *m = PyModule_Create(&StructFormat_module);
+    if (m == NULL)
+    {
+        return NULL;
+    }
+    module_set_gil_not_used(m);
+    StructFormat_cache = PyDict_New();
+    StructFormat_OT = PyType_FromSpec(&StructFormat_Spec);
+    if (StructFormat_cache == nullptr || StructFormat_OT == nullptr)
+    {
+        Py_DecRef(m);
+        return NULL;
+    }
+    if (add_object(m, "StructFormat", StructFormat_OT) < 0)
+    {
+        return NULL;
+    }
+    return m;
+}
@@ -0,0 +1,399 @@
+/**
+ * @file StructFormat.hpp
+ * @brief Compiled struct formats for reading and writing fixed records in one call.
+ *
+ * A format like "<IHf3e" is parsed once into a list of operations,
+ * which are then executed on a raw block of bytes by StructFormat_unpack and StructFormat_pack.
+ * The syntax follows the struct module with standard sizes and no alignment:
+ * - byte order: '<' little, '>' or '!' big, '@', '=' or none use the endian of the reader/writer
+ * - codes: x ? b B h H i I l L q Q e f d s, with an optional repeat count
+ *
+ * The StructFormat type lives in bier.EndianedBinaryIO.C.StructFormat,
+ * the IO modules import it via StructFormat_import to accept compiled formats.
+ */
+#pragma once
+#include <algorithm>
+#include <vector>
+#include "PyConverter.hpp"
+
+struct StructFormatOp
+{
+    char code;        // The format character.
+    Py_ssize_t count; // The repeat count, the length for 's'.
+};
+
+typedef struct
+{
+    PyObject_HEAD
+        PyObject *format;             // The format string.
+    std::vector<StructFormatOp> *ops; // The parsed operations.
+    Py_ssize_t size;                  // The size of a record in bytes.
+    Py_ssize_t length;                // The number of values in a record.
+    char endian;                      // '<', '>' or '|' for the endian of the reader/writer.
+} StructFormatObject;
+
+static inline Py_ssize_t StructFormat_itemsize(char code)
+{
+    switch (code)
+    {
+    case 'x':
+    case '?':
+    case 'b':
+    case 'B':
+    case 's':
+        return 1;
+    case 'h':
+    case 'H':
+    case 'e':
+        return 2;
+    case 'i':
+    case 'I':
+    case 'l':
+    case 'L':
+    case 'f':
+        return 4;
+    case 'q':
+    case 'Q':
+    case 'd':
+        return 8;
+    default:
+        return 0;
+    }
+}
+
+/**
+ * @brief Calls f.template operator()<T>() with the C++ type of a value format code.
+ */
+template <typename F>
+static inline bool StructFormat_dispatch(char code, F &&f)
+{
+    switch (code)
+    {
+    case '?':
+        return f.template operator()<bool>();
+    case 'b':
+        return f.template operator()<int8_t>();
+    case 'B':
+        return f.template operator()<uint8_t>();
+    case 'h':
+        return f.template operator()<int16_t>();
+    case 'H':
+        return f.template operator()<uint16_t>();
+    case 'i':
+    case 'l':
+        return f.template operator()<int32_t>();
+    case 'I':
+    case 'L':
+        return f.template operator()<uint32_t>();
+    case 'q':
+        return f.template operator()<int64_t>();
+    case 'Q':
+        return f.template operator()<uint64_t>();
+    case 'e':
+        return f.template operator()<half>();
+    case 'f':
+        return f.template operator()<float>();
+    case 'd':
+        return f.template operator()<double>();
+    default:
+        return false;
+    }
+}
+
+/**
+ * @brief Parses a format string into self.
+ *
+ * @return int 0 on success, -1 with a ValueError set on failure
+ */
+static inline int StructFormat_parse(StructFormatObject *self, const char *format)
+{
+    self->ops->clear();
+    self->size = 0;
+    self->length = 0;
+    self->endian = '|';
+
+    const char *ptr = format;
+    switch (*ptr)
+    {
+    case '<':
+        self->endian = '<';
+        ++ptr;
+        break;
+    case '>':
+    case '!':
+        self->endian = '>';
+        ++ptr;
+        break;
+    case '@':
+    case '=':
+        ++ptr;
+        break;
+    }
+
+    while (*ptr != '\0')
+    {
+        if (*ptr == ' ' || *ptr == '\t' || *ptr == '\n' || *ptr == '\r')
+        {
+            ++ptr;
+            continue;
+        }
+
+        Py_ssize_t count = 1;
+        if (*ptr >= '0' && *ptr <= '9')
+        {
+            count = 0;
+            while (*ptr >= '0' && *ptr <= '9')
+            {
+                count = count * 10 + (*ptr++ - '0');
+                if (count > (PY_SSIZE_T_MAX >> 4))
+                {
+                    PyErr_SetString(PyExc_ValueError, "Repeat count too large in struct format.");
+                    return -1;
+                }
+            }
+            if (*ptr == '\0')
+            {
+                PyErr_SetString(PyExc_ValueError, "Repeat count given without format specifier.");
+                return -1;
+            }
+        }
+
+        const char code = *ptr++;
+        const Py_ssize_t itemsize = StructFormat_itemsize(code);
+        if (itemsize == 0)
+        {
+            PyErr_Format(PyExc_ValueError, "Bad char in struct format: '%c'.", code);
+            return -1;
+        }
+        if (count == 0)
+        {
+            continue;
+        }
+        // the per-code cap doesn't keep the sum of many codes from overflowing
+        if (count > (PY_SSIZE_T_MAX - self->size) / itemsize)
+        {
+            PyErr_SetString(PyExc_ValueError, "Total struct size too long.");
+            return -1;
+        }
+
+        self->ops->push_back({code, count});
+        self->size += itemsize * count;
+        if (code == 's')
+        {
+            self->length += 1;
+        }
+        else if (code != 'x')
+        {
+            self->length += count;
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief Decodes one record from data.
+ *
+ * @param data Pointer to at least self->size bytes
+ * @param endian The resolved byte order of the data, '<' or '>'
+ * @return PyObject* A new reference to a tuple or nullptr on error
+ */
+static inline PyObject *StructFormat_unpack(StructFormatObject *self, const char *data, char endian)
+{
+    PyObject *ret = PyTuple_New(self->length);
+    if (ret == nullptr)
+    {
+        return nullptr;
+    }
+
+    const bool swap = endian != NATIVE_ENDIAN;
+    Py_ssize_t index = 0;
+    for (const StructFormatOp &op : *self->ops)
+    {
+        if (op.code == 'x')
+        {
+            data += op.count;
+            continue;
+        }
+        if (op.code == 's')
+        {
+            PyObject *item = PyBytes_FromStringAndSize(data, op.count);
+            if (item == nullptr)
+            {
+                Py_DecRef(ret);
+                return nullptr;
+            }
+            PyTuple_SetItem(ret, index++, item); // Steal reference, no need to DECREF
+            data += op.count;
+            continue;
+        }
+
+        bool ok = StructFormat_dispatch(
+            op.code,
+            [&]<typename T>() -> bool
+            {
+                T value{};
+                for (Py_ssize_t i = 0; i < op.count; ++i, data += sizeof(T))
+                {
+                    memcpy(&value, data, sizeof(T));
+                    if constexpr (sizeof(T) > 1)
+                    {
+                        if (swap)
+                        {
+                            value = byteswap(value);
+                        }
+                    }
+                    PyObject *item = PyObject_FromAny(value);
+                    if (item == nullptr)
+                    {
+                        return false;
+                    }
+                    PyTuple_SetItem(ret, index++, item); // Steal reference, no need to DECREF
+                }
+                return true;
+            });
+        if (!ok)
+        {
+            Py_DecRef(ret);
+            return nullptr;
+        }
+    }
+    return ret;
+}
+
+/**
+ * @brief Encodes one record of values into out.
+ *
+ * @param values A sequence with self->length items
+ * @param out Pointer to at least self->size writable bytes
+ * @param endian The byte order to write, '<' or '>'
+ * @return int 0 on success, -1 with an exception set on failure
+ */
+static inline int StructFormat_pack(StructFormatObject *self, PyObject *values, char *out, char endian)
+{
+    PyObject *seq = PySequence_Fast(values, "Struct values must be a sequence.");
+    if (seq == nullptr)
+    {
+        return -1;
+    }
+    if (PySequence_Fast_GET_SIZE(seq) != self->length)
+    {
+        PyErr_Format(PyExc_ValueError, "Struct format requires %zd values, got %zd.", self->length, PySequence_Fast_GET_SIZE(seq));
+        Py_DecRef(seq);
+        return -1;
+    }
+    PyObject **items = PySequence_Fast_ITEMS(seq);
+
+    const bool swap = endian != NATIVE_ENDIAN;
+    Py_ssize_t index = 0;
+    for (const StructFormatOp &op : *self->ops)
+    {
+        if (op.code == 'x')
+        {
+            memset(out, 0, op.count);
+            out += op.count;
+            continue;
+        }
+        if (op.code == 's')
+        {
+            Py_buffer view{};
+            if (PyObject_GetBuffer(items[index++], &view, PyBUF_SIMPLE) != 0)
+            {
+                Py_DecRef(seq);
+                return -1;
+            }
+            // like struct, truncate or pad with zeros to the given length
+            Py_ssize_t copy_size = std::min(view.len, op.count);
+            memcpy(out, view.buf, copy_size);
+            memset(out + copy_size, 0, op.count - copy_size);
+            PyBuffer_Release(&view);
+            out += op.count;
+            continue;
+        }
+
+        bool ok = StructFormat_dispatch(
+            op.code,
+            [&]<typename T>() -> bool
+            {
+                T value{};
+                for (Py_ssize_t i = 0; i < op.count; ++i, out += sizeof(T))
+                {
+                    if (!PyObject_ToAny(items[index++], value))
+                    {
+                        return false;
+                    }
+                    if constexpr (sizeof(T) > 1)
+                    {
+                        if (swap)
+                        {
+                            value = byteswap(value);
+                        }
+                    }
+                    memcpy(out, &value, sizeof(T));
+                }
+                return true;
+            });
+        if (!ok)
+        {
+            Py_DecRef(seq);
+            return -1;
+        }
+    }
+    Py_DecRef(seq);
+    return 0;
+}
+
+/**
+ * @brief Resolves the byte order of a format for a reader/writer with the given endian.
+ */
+static inline char StructFormat_endian(StructFormatObject *self, char io_endian)
+{
+    return self->endian == '|' ? io_endian : self->endian;
+}
+
+// set by StructFormat_import in the IO modules
+static PyObject *StructFormat_Type = nullptr;
+static PyObject *StructFormat_compile = nullptr;
+
+/**
+ * @brief Imports the StructFormat type and the cached compile function.
+ *
+ * @return int 0 on success, -1 with an exception set on failure
+ */
+static inline int StructFormat_import()
+{
+    PyObject *module = PyImport_ImportModule("bier.EndianedBinaryIO.C.StructFormat");
+    if (module == nullptr)
+    {
+        return -1;
+    }
+    StructFormat_Type = PyObject_GetAttrString(module, "StructFormat");
+    StructFormat_compile = PyObject_GetAttrString(module, "compile");
+    Py_DecRef(module);
+    if (StructFormat_Type == nullptr || StructFormat_compile == nullptr)
+    {
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Gets a compiled format from a StructFormat or a format string.
+ *
+ * Format strings are compiled through the cache of bier.EndianedBinaryIO.C.StructFormat.compile.
+ *
+ * @return StructFormatObject* A new reference or nullptr on error
+ */
+static inline StructFormatObject *StructFormat_FromObject(PyObject *obj)
+{
+    if (PyObject_TypeCheck(obj, reinterpret_cast<PyTypeObject *>(StructFormat_Type)))
+    {
+        Py_IncRef(obj);
+        return reinterpret_cast<StructFormatObject *>(obj);
+    }
+    if (PyUnicode_Check(obj))
+    {
+        return reinterpret_cast<StructFormatObject *>(PyObject_CallOneArg(StructFormat_compile, obj));
+    }
+    PyErr_SetString(PyExc_TypeError, "Format must be a str or StructFormat.");
+    return nullptr;
+}
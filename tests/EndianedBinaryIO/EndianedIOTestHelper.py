@@ -1,10 +1,28 @@
 import builtins
+import sys
 from random import randint, uniform
 from struct import pack, unpack
 from typing import Callable, List, Literal
 
 from bier.EndianedBinaryIO import EndianedReaderIOBase, EndianedWriterIOBase, Endianess
 
+STRUCT_FORMATS = {
+    "bool": "?",
+    "u8": "B",
+    "u16": "H",
+    "u32": "I",
+    "u64": "Q",
+    "i8": "b",
+    "i16": "h",
+    "i32": "i",
+    "i64": "q",
+    "f16": "e",
+    "f32": "f",
+    "f64": "d",
+}
+# memoryview supports the half float format only since 3.12
+MEMORYVIEW_HALF = sys.version_info >= (3, 12)
+
 
 class EndianedIOTestHelper:
     count: int
@@ -191,6 +209,24 @@ class EndianedIOTestHelper:
         values_read_arr = call_arr(self.count)
         check_read(values_read_arr, "array")
 
+        fmt = STRUCT_FORMATS[call_name.split("_")[1]]
+        if fmt != "e" or MEMORYVIEW_HALF:
+            reader.seek(start_pos)
+            values_read_typed = call_arr(self.count, as_array=True)
+            assert isinstance(values_read_typed, memoryview)
+            check_read(values_read_typed.tolist(), "typed array")
+
+        explicit_name = f"{call_name}_{'le' if reader.endian == '<' else 'be'}_array"
+        if hasattr(reader, explicit_name):
+            reader.seek(start_pos)
+            check_read(getattr(reader, explicit_name)(self.count), "explicit array")
+
+        dest = bytearray(len(values_raw) + 8)
+        reader.seek(start_pos)
+        count = getattr(reader, f"{call_name}_array_into")(dest, self.count)
+        assert count == self.count, f"Failed to read into: expected {self.count}, got {count}"
+        check_read(unpack(f"={self.count}{fmt}", dest[: len(values_raw)]), "into")
+
     def _test_write(
         self,
         writer: EndianedWriterIOBase,
@@ -223,6 +259,13 @@ class EndianedIOTestHelper:
         call_arr(values, False)
         check_write("array")
 
+        # buffer exporting writes, e.g. array.array, memoryview or numpy arrays
+        fmt = STRUCT_FORMATS[call_name.split("_")[1]]
+        if fmt != "e" or MEMORYVIEW_HALF:
+            writer.seek(start_pos)
+            call_arr(memoryview(pack(f"={self.count}{fmt}", *values)).cast(fmt), False)
+            check_write("buffer")
+
     def _generate_values(self):
         self.bool = [bool(v) for v in self._generate_random_ints(0, 1, self.count)]
         self.u8 = self._generate_random_ints(0, 0xFF, self.count)
@@ -1,13 +1,23 @@
 import os
+import struct
+import sys
 import tempfile
-from io import BytesIO
+import threading
+from io import BytesIO, UnsupportedOperation
 
 import pytest
 
+import bier
 from bier.EndianedBinaryIO import EndianedBytesIO, EndianedFileIO, EndianedStreamIO
 from bier.EndianedBinaryIO.C import (
     EndianedBytesIO as EndianedBytesIOC,
 )
+from bier.EndianedBinaryIO.C import (
+    EndianedFileIO as EndianedFileIOC,
+)
+from bier.EndianedBinaryIO.C import (
+    EndianedMmapIO as EndianedMmapIOC,
+)
 from bier.EndianedBinaryIO.C import (
     EndianedStreamIO as EndianedStreamIOC,
 )
@@ -40,6 +50,33 @@ class EndianedFileIOTemp(EndianedFileIO):
         super().__del__()
 
 
+class EndianedFileIOCTemp(EndianedFileIOC):
+    gen_reader = EndianedFileIOTemp.gen_reader
+    gen_writer = EndianedFileIOTemp.gen_writer
+
+    def close(self):
+        name = self.name
+        super().close()
+        if os.path.exists(name):
+            os.unlink(name)
+
+
+class EndianedMmapIOCTemp(EndianedMmapIOC):
+    @classmethod
+    def gen_reader(cls, data, endian):
+        temp_file = tempfile.NamedTemporaryFile(delete=False, mode="wb")
+        temp_file.write(data)
+        temp_file.close()
+        reader = cls(temp_file.name, endian=endian)
+        reader.name = temp_file.name
+        return reader
+
+    def close(self):
+        super().close()
+        if os.path.exists(self.name):
+            os.unlink(self.name)
+
+
 @pytest.mark.parametrize(
     "io_class, stream_factory",
     [
@@ -60,6 +97,14 @@ class EndianedFileIOTemp(EndianedFileIO):
             EndianedBytesIOC,
             lambda data, endian: EndianedBytesIOC(data, endian),
         ),
+        (
+            EndianedFileIOC,
+            lambda data, endian: EndianedFileIOCTemp.gen_reader(data, endian),
+        ),
+        (
+            EndianedMmapIOC,
+            lambda data, endian: EndianedMmapIOCTemp.gen_reader(data, endian),
+        ),
     ],
 )
 def test_reader(io_class, stream_factory):
@@ -84,8 +129,894 @@ def test_reader(io_class, stream_factory):
             EndianedBytesIOC,
             lambda endian: EndianedBytesIOC(bytearray(1024), endian),
         ),
+        (
+            EndianedBytesIOC,
+            lambda endian: EndianedBytesIOC(endian=endian),
+        ),
+        (
+            EndianedFileIOC,
+            lambda endian: EndianedFileIOCTemp.gen_writer(endian),
+        ),
     ],
 )
 def test_writer(io_class, stream_factory):
     helper = EndianedIOTestHelper(count=10)
     helper.test_writer(stream_factory)
+
+
+@pytest.mark.parametrize("io_class", [EndianedBytesIO, EndianedBytesIOC])
+def test_bytesio_growth(io_class):
+    writer = io_class(endian=">")
+    writer.reserve(16)
+    for i in range(1000):
+        writer.write_u32(i)
+    assert writer.getvalue() == b"".join(i.to_bytes(4, "big") for i in range(1000))
+
+    # seeking past the end and writing zero-fills the gap
+    writer.seek(4010)
+    writer.write_u8(1)
+    assert writer.getvalue()[4000:] == b"\x00" * 10 + b"\x01"
+
+
+
+def test_bytesio_borrowed():
+    # writes go to the caller's buffer, which can't grow
+    data = bytearray(4)
+    writer = EndianedBytesIOC(data, endian="<")
+    writer.write_u32(1)
+    with pytest.raises(ValueError):
+        writer.write_u32(2)
+    with pytest.raises(ValueError):
+        writer.reserve(8)
+    writer.seek(0)
+    writer.write_u32(9)
+    assert data == b"\x09\x00\x00\x00"
+
+
+@pytest.mark.parametrize("io_class", [EndianedBytesIO, EndianedBytesIOC])
+def test_read_past_end(io_class):
+    reader = io_class(bytes(8))
+    reader.seek(100)
+    with pytest.raises((ValueError, struct.error)):
+        reader.read_u32_array(2)
+    with pytest.raises((ValueError, struct.error)):
+        reader.read_u32_array(2, as_array=True)
+
+    # huge counts must not overflow the size check
+    reader.seek(0)
+    with pytest.raises((ValueError, struct.error)):
+        reader.read_u32_array(2**61, as_array=True)
+    assert reader.read_u32_array(2, as_array=True).tolist() == [0, 0]
+
+    dest = bytearray(8)
+    reader.seek(100)
+    with pytest.raises((ValueError, struct.error)):
+        reader.read_u32_array_into(dest, 2)
+    reader.seek(0)
+    with pytest.raises((ValueError, struct.error)):
+        reader.read_u64_array_into(dest, 2**61)
+
+    # plain reads behind the end return nothing
+    reader.seek(100)
+    assert reader.readinto(dest) == 0
+    assert reader.read(4) == b""
+    assert reader.tell() == 100
+
+
+@pytest.mark.parametrize("io_class", [EndianedStreamIOC, EndianedFileIOC])
+def test_read_huge_count(io_class):
+    # the length of a stream is unknown, so huge counts must fail without overflowing or allocating them
+    with tempfile.TemporaryDirectory() as tmp:
+        path = os.path.join(tmp, "data.bin")
+        with open(path, "wb") as f:
+            f.write(bytes(16))
+        if io_class is EndianedStreamIOC:
+            reader = io_class(open(path, "rb"), "<")
+        else:
+            reader = io_class(path, "rb")
+        with pytest.raises(OverflowError):
+            reader.read_u32_array(2**62)
+        with pytest.raises(OverflowError):
+            reader.read_struct_array("I", 2**62)
+        with pytest.raises(ValueError):
+            reader.read_varint_array(2**40)
+        reader.seek(0)
+        assert reader.read_u32_array(4) == (0, 0, 0, 0)
+        reader.close()
+
+
+@pytest.mark.parametrize(
+    "stream_factory",
+    [
+        lambda data: EndianedBytesIO(data),
+        lambda data: EndianedBytesIOC(data),
+        lambda data: EndianedStreamIOC(BytesIO(data), "<"),
+    ],
+)
+def test_read_view(stream_factory):
+    reader = stream_factory(b"abcdef")
+    view = reader.read_bytes(3, copy=False)
+    assert isinstance(view, memoryview)
+    assert view == b"abc"
+    assert reader.tell() == 3
+    assert reader.read_view(2) == b"de"
+    assert reader.read_view(None) == b"f"
+    assert reader.read_view(1) == b""
+    view.release()
+
+
+@pytest.mark.parametrize(
+    "stream_factory",
+    [
+        lambda: EndianedBytesIO(endian=">"),
+        lambda: EndianedBytesIOC(endian=">"),
+        lambda: EndianedStreamIOC(BytesIO(), ">"),
+    ],
+)
+@pytest.mark.parametrize(
+    "count_type, prefix",
+    [
+        (None, b"\x00\x00\x00\x03"),
+        ("u8", b"\x03"),
+        ("u16", b"\x00\x03"),
+        ("u32", b"\x00\x00\x00\x03"),
+        ("i64", b"\x00\x00\x00\x00\x00\x00\x00\x03"),
+        ("varint", b"\x03"),
+    ],
+)
+def test_count_type(stream_factory, count_type, prefix):
+    io = stream_factory()
+    io.count_type = count_type
+    assert io.count_type == count_type
+    io.write_u16_array([1, 2, 3])
+    io.write_count(200)
+    io.seek(0)
+    assert io.read(len(prefix)) == prefix
+    io.seek(0)
+    assert tuple(io.read_u16_array()) == (1, 2, 3)
+    assert io.read_count() == 200
+
+
+@pytest.mark.parametrize(
+    "stream_factory",
+    [
+        lambda: EndianedBytesIO(endian=">"),
+        lambda: EndianedBytesIOC(endian=">"),
+        lambda: EndianedStreamIOC(BytesIO(), ">"),
+    ],
+)
+def test_struct(stream_factory):
+    records = [(1, 2, 0.5, 1.0, 2.0, -3.0, b"ab"), (4, 5, -1.5, 0.0, 0.25, 8.0, b"cd")]
+    fmt = bier.compile("<IHf3e2s")
+    assert fmt is bier.compile("<IHf3e2s")
+    assert fmt.size == struct.calcsize("<IHf3e2s")
+    # the total size of many large repeat counts must not overflow
+    count = (2**63 >> 4) - 1
+    with pytest.raises((ValueError, struct.error)):
+        bier.compile(f"{count}Q{count}Q{count}Q")
+
+    io = stream_factory()
+    io.write_struct(fmt, records[0])
+    io.write_struct("IxH", (7, 8))
+    io.write_struct_array(fmt, records)
+    io.seek(0)
+    assert io.read(fmt.size) == struct.pack("<IHf3e2s", *records[0])
+    # no byte order prefix uses the endian of the stream
+    assert io.read(7) == struct.pack(">IxH", 7, 8)
+
+    io.seek(0)
+    assert io.read_struct(fmt) == records[0]
+    assert io.read_struct("=IxH") == (7, 8)
+    assert io.read_struct_array(fmt) == records
+
+
+def test_struct_format():
+    from bier.EndianedBinaryIO.C.StructFormat import compile
+
+    fmt = compile("IH")
+    assert fmt.pack([1, 2], "<") == struct.pack("<IH", 1, 2)
+    assert fmt.pack([1, 2], ">") == struct.pack(">IH", 1, 2)
+    assert fmt.unpack(struct.pack(">IH", 1, 2), ">") == (1, 2)
+    assert fmt.unpack(fmt.pack([3, 4])) == (3, 4)
+    # an explicit byte order in the format wins
+    assert compile("<I").pack([1], ">") == b"\x01\x00\x00\x00"
+    with pytest.raises(ValueError):
+        fmt.pack([1, 2], "x")
+    with pytest.raises(ValueError):
+        fmt.unpack(bytes(6), "=")
+
+    # formats built at runtime don't grow the cache forever, it's cleared once full
+    assert compile("IH") is fmt
+    for n in range(1000):
+        compile(f"{n}x")
+    assert compile("IH") is not fmt
+
+
+@pytest.mark.parametrize("buffer_size", [0, 5, 65536])
+def test_stream_read_ahead(buffer_size):
+    data = bytes(range(64))
+    stream = BytesIO(data)
+    io = EndianedStreamIOC(stream, "<", buffer_size=buffer_size)
+
+    assert io.read_u8() == 0
+    assert io.tell() == 1
+    assert io.read(3) == b"\x01\x02\x03"
+    assert io.read_u32_be() == 0x04050607
+    # seeking within and outside of the buffered data
+    assert io.seek(2) == 2
+    assert io.read_u8() == 2
+    assert io.seek(4, 1) == 7
+    assert io.read_u8() == 7
+    # a failed seek keeps the position
+    with pytest.raises(ValueError):
+        io.seek(-5)
+    assert io.tell() == 8
+    assert io.seek(40) == 40
+    assert io.read_cstring() == bytes(range(40, 64)).decode()
+    assert io.tell() == 64
+
+    # reads larger than the buffer, readinto and the remaining data
+    io.seek(1)
+    assert tuple(io.read_u8_array(20)) == tuple(range(1, 21))
+    dest = bytearray(4)
+    assert io.readinto(dest) == 4
+    assert dest == bytes(range(21, 25))
+    assert io.read() == data[25:]
+    assert io.read(1) == b""
+
+    # the stream is handed over in the logical position
+    io.seek(10)
+    io.read_u8()
+    io.write(b"\xff")
+    io.flush()
+    assert stream.getvalue()[11] == 0xFF
+    assert io.tell() == 12
+    assert io.read_u8() == 12
+
+
+@pytest.mark.parametrize("buffer_size", [0, 5, 65536])
+def test_stream_write_buffer(buffer_size):
+    # writes reach the stream right away unless a write buffer is requested
+    stream = BytesIO()
+    EndianedStreamIOC(stream, "<").write_u32(1)
+    assert stream.getvalue() == b"\x01\x00\x00\x00"
+
+    stream = BytesIO()
+    io = EndianedStreamIOC(stream, "<", write_buffer_size=buffer_size)
+    assert io.write_buffer_size == buffer_size
+    assert io.write_u32(0x04030201) == 4
+    assert io.write(b"\x05\x06") == 2
+    assert io.write_u8_array(list(range(7, 17)), write_count=False) == 10
+    assert io.write_cstring("abc") == 4
+    assert io.tell() == 20
+    if buffer_size > 20:
+        # nothing reached the stream yet
+        assert stream.getvalue() == b""
+    io.flush()
+    expected = bytes(range(1, 17)) + b"abc\x00"
+    assert stream.getvalue() == expected
+
+    # read after write sees the pending data
+    io.write_u16(0x1211)
+    io.seek(0)
+    assert io.read(22) == expected + b"\x11\x12"
+
+    # overwriting in the middle
+    io.seek(1)
+    io.write_u8(0xFF)
+    assert io.read_u8() == 3
+    io.write_u8(0xFE)
+    assert io.tell() == 4
+    # reading the rest sees the pending data at the right position
+    io.write_u16(0xFFFF)
+    assert io.read() == expected[6:] + b"\x11\x12"
+    assert io.tell() == 22
+    io.close()
+    assert stream.closed
+
+    stream = BytesIO()
+    io = EndianedStreamIOC(stream, "<", write_buffer_size=buffer_size)
+    io.write(b"pending")
+    del io
+    assert stream.getvalue() == b"pending"
+
+    if buffer_size == 0:
+        return
+
+    # a failing flush on dealloc is reported as unraisable
+    class FailingStream(BytesIO):
+        def write(self, data):
+            raise OSError("write failed")
+
+    unraisable = []
+    hook = sys.unraisablehook
+    sys.unraisablehook = lambda args: unraisable.append(args.exc_type)
+    try:
+        for _ in range(10):
+            io = EndianedStreamIOC(FailingStream(), "<", write_buffer_size=buffer_size)
+            io.write_u8(1)
+            del io
+    finally:
+        sys.unraisablehook = hook
+    assert unraisable == [OSError] * 10
+
+
+@pytest.mark.parametrize("buffer_size", [0, 5, 65536])
+def test_fileio(buffer_size):
+    with tempfile.TemporaryDirectory() as tmp:
+        path = os.path.join(tmp, "data.bin")
+        io = EndianedFileIOC(path, "w+b", endian=">", buffer_size=buffer_size)
+        assert io.writable() and io.readable() and io.seekable()
+        assert io.write_u32(0x01020304) == 4
+        assert io.write(bytes(range(5, 64))) == 59
+        assert io.tell() == 63
+        assert io.seek(-3, 2) == 60
+        assert io.read() == bytes([61, 62, 63])
+        assert io.seek(0) == 0
+        assert io.read_u32() == 0x01020304
+        io.flush()
+        with open(path, "rb") as f:
+            assert f.read() == b"\x01\x02\x03\x04" + bytes(range(5, 64))
+
+        # the position is independent of the offset of the descriptor
+        other = EndianedFileIOC(io.fileno(), "rb", closefd=False)
+        assert other.read(4) == b"\x01\x02\x03\x04"
+        assert io.read_u8() == 5
+        other.close()
+        assert not io.closed
+
+        # read after write inside the buffered range
+        io.seek(10)
+        io.write_u8(0xFF)
+        io.seek(9)
+        assert io.read(3) == bytes([10, 0xFF, 12])
+        assert io.truncate(20) == 20
+        assert io.seek(0, 2) == 20
+        io.close()
+        assert io.closed
+        with pytest.raises(ValueError):
+            io.read_u8()
+
+        io = EndianedFileIOC(path, "ab", buffer_size=buffer_size)
+        assert io.tell() == 20
+        io.write(b"end")
+        del io
+        with open(path, "rb") as f:
+            assert f.read()[-3:] == b"end"
+
+        # appended writes ignore the position, like with O_APPEND
+        with open(path, "wb") as f:
+            f.write(b"abcd")
+        io = EndianedFileIOC(path, "a+b", buffer_size=buffer_size)
+        io.seek(0)
+        assert io.read(2) == b"ab"
+        io.write(b"XY")
+        assert io.tell() == 6
+        io.seek(0)
+        io.write(b"Z")
+        assert io.tell() == 7
+        io.seek(0)
+        assert io.read() == b"abcdXYZ"
+        io.close()
+
+        # the mode is enforced like io.FileIO does
+        io = EndianedFileIOC(path, "rb", buffer_size=buffer_size)
+        with pytest.raises(UnsupportedOperation):
+            io.write_u8(1)
+        del io
+        io = EndianedFileIOC(path, "wb", buffer_size=buffer_size)
+        with pytest.raises(UnsupportedOperation):
+            io.read_u8()
+        io.close()
+
+
+def test_mmapio():
+    with tempfile.TemporaryDirectory() as tmp:
+        path = os.path.join(tmp, "data.bin")
+        with open(path, "wb") as f:
+            f.write(bytes(range(64)))
+
+        io = EndianedMmapIOC(path, endian=">", advice="sequential", populate=True)
+        assert len(io.getvalue()) == 64
+        assert io.read_u32() == 0x00010203
+        assert io.read_u16_array(2) == (0x0405, 0x0607)
+        view = io.read_view(4)
+        assert view == bytes(range(8, 12))
+        # views keep the mapping alive
+        with pytest.raises(BufferError):
+            io.close()
+        view.release()
+        io.madvise("random", 8, 16)
+        with pytest.raises(ValueError):
+            io.write_u8(1)
+        io.close()
+
+        # writes go to the file, but the mapping can't grow
+        with open(path, "r+b") as f:
+            io = EndianedMmapIOC(f.fileno(), "r+")
+        io.seek(4)
+        io.write_u32(0xFFFFFFFF)
+        io.flush()
+        io.seek(62)
+        with pytest.raises(ValueError):
+            io.write_u32(0)
+        io.close()
+        with open(path, "rb") as f:
+            assert f.read(8) == b"\x00\x01\x02\x03\xff\xff\xff\xff"
+
+        # copy on write keeps the changes private
+        io = EndianedMmapIOC(path, "c")
+        io.write_u8(0xAA)
+        assert io.getvalue()[0] == 0xAA
+        io.close()
+        with open(path, "rb") as f:
+            assert f.read(1) == b"\x00"
+
+        open(path, "wb").close()
+        io = EndianedMmapIOC(path)
+        assert io.read(None) == b""
+
+
+def test_large_bulk_operations():
+    # above the threshold the copies run without the GIL
+    data = bytes(range(256)) * 1024
+    values = struct.unpack(">65536I", data)
+
+    io = EndianedBytesIOC(data, endian=">")
+    assert io.read_u32_array(len(values)) == values
+    io.seek(0)
+    dst = bytearray(len(data))
+    assert io.readinto(dst) == len(data)
+    assert dst == data
+    io.seek(0)
+    assert io.read_bytes(len(data)) == data
+    io.seek(1)
+    assert len(io.readuntil(b"\x00", -1)) == 255
+    io.seek(0)
+    dst = memoryview(bytearray(len(data))).cast("I")
+    assert io.read_u32_array_into(dst, len(values)) == len(values)
+    assert tuple(dst) == values
+
+    io = EndianedBytesIOC(endian=">")
+    io.write_u32_array(values, write_count=False)
+    assert io.getvalue() == data
+
+
+def test_threads():
+    data = bytes(range(256)) * 1024
+    values = struct.unpack(">65536I", data)
+    results = []
+
+    # independent readers over the same immutable buffer
+    def read_all():
+        io = EndianedBytesIOC(data, endian=">")
+        results.append(io.read_u32_array(len(values)) == values)
+
+    # a shared reader hands out every value exactly once
+    shared = EndianedBytesIOC(data, endian=">")
+    seen = []
+
+    def read_shared():
+        local = [shared.read_u32() for _ in range(len(values) // 4)]
+        seen.extend(local)
+
+    threads = [threading.Thread(target=read_all) for _ in range(4)]
+    threads += [threading.Thread(target=read_shared) for _ in range(4)]
+    for thread in threads:
+        thread.start()
+    for thread in threads:
+        thread.join()
+
+    assert results == [True] * 4
+    assert sorted(seen) == sorted(values)
+    assert shared.tell() == len(data)
+
+
+@pytest.mark.parametrize("io_class", [EndianedStreamIOC, EndianedFileIOC])
+@pytest.mark.parametrize("buffer_size", [0, 64, 65536])
+def test_threads_buffered(io_class, buffer_size):
+    # the IO releases the GIL with the buffers in flux, so the calls on one object are serialized
+    data = bytes(range(256)) * 1024
+    values = struct.unpack(">65536I", data)
+    with tempfile.TemporaryDirectory() as tmp:
+        path = os.path.join(tmp, "data.bin")
+        with open(path, "wb") as f:
+            f.write(data)
+        if io_class is EndianedStreamIOC:
+            shared = io_class(open(path, "rb", buffering=0), ">", buffer_size=buffer_size)
+        else:
+            shared = io_class(path, "rb", endian=">", buffer_size=buffer_size)
+        seen = []
+
+        def read_shared():
+            local = [shared.read_u32() for _ in range(len(values) // 4)]
+            seen.extend(local)
+
+        threads = [threading.Thread(target=read_shared) for _ in range(4)]
+        for thread in threads:
+            thread.start()
+        for thread in threads:
+            thread.join()
+
+        assert sorted(seen) == sorted(values)
+        assert shared.tell() == len(data)
+        shared.close()
+
+
+def test_threads_read_at():
+    # large read_*_at run without the GIL, but never move the shared position
+    data = bytes(range(256)) * 1024
+    values = struct.unpack(">65536I", data)
+    shared = EndianedBytesIOC(data, endian=">")
+    results = []
+    seen = []
+
+    def read_at():
+        for _ in range(16):
+            results.append(shared.read_bytes_at(0, len(data)) == data)
+            results.append(shared.read_u32_array_at(0, len(values), as_array=True).tolist() == list(values))
+
+    def read_shared():
+        local = [shared.read_u32() for _ in range(len(values) // 4)]
+        seen.extend(local)
+
+    threads = [threading.Thread(target=read_at) for _ in range(2)]
+    threads += [threading.Thread(target=read_shared) for _ in range(4)]
+    for thread in threads:
+        thread.start()
+    for thread in threads:
+        thread.join()
+
+    assert results == [True] * 64
+    assert sorted(seen) == sorted(values)
+    assert shared.tell() == len(data)
+
+    # the length prefix is read at the offset as well
+    io = EndianedBytesIOC(b"\x00\x00\x00\x02ab", endian=">")
+    assert io.read_bytes_at(0) == b"ab"
+    assert io.tell() == 0
+
+
+@pytest.mark.parametrize("io_class", [EndianedBytesIO, EndianedBytesIOC])
+def test_cursor(io_class):
+    io = io_class(bytes(range(16)), endian=">")
+    io.seek(4)
+
+    cursor = io.cursor(length=4)
+    assert cursor.tell() == 0
+    assert cursor.read_u32() == 0x04050607
+    assert cursor.read(None) == b""
+    assert io.tell() == 4
+
+    cursor = io.cursor(8, 4, "<")
+    assert cursor.getvalue() == bytes(range(8, 12))
+    assert cursor.read_u32() == 0x0B0A0908
+
+    fork = io.fork()
+    assert fork.getvalue() == bytes(range(16))
+    assert fork.tell() == 4
+    assert fork.read_u16() == 0x0405
+    assert io.read_u16() == 0x0405
+
+    with pytest.raises(ValueError):
+        io.cursor(17)
+    with pytest.raises(ValueError):
+        io.cursor(8, 9)
+
+
+@pytest.mark.parametrize(
+    "stream_factory",
+    [
+        lambda data: EndianedStreamIO(BytesIO(data), ">"),
+        lambda data: EndianedBytesIO(data, ">"),
+        lambda data: EndianedStreamIOC(BytesIO(data), ">"),
+        lambda data: EndianedBytesIOC(data, ">"),
+        lambda data: EndianedFileIOCTemp.gen_reader(data, ">"),
+    ],
+)
+def test_read_at(stream_factory):
+    data = struct.pack(">IHf", 8, 0x1234, 1.5) + b"\x02abc\x00\x00"
+    io = stream_factory(data)
+    io.count_type = "u8"
+    io.seek(2)
+
+    assert io.read_u32_at(0) == 8
+    assert io.read_u16_le_at(4) == 0x3412
+    assert io.read_f32_at(6) == 1.5
+    assert io.read_u8_array_at(10, 3) == (2, 0x61, 0x62)
+    assert io.read_u16_be_array_at(4, 1) == (0x1234,)
+    assert io.read_cstring_at(11) == "abc"
+    assert io.read_string_at(10) == "ab"
+    assert io.read_bytes_at(11, 2) == b"ab"
+    with pytest.raises(ValueError):
+        io.read_u32_at(-1)
+    # failed reads leave the position untouched as well
+    with pytest.raises(Exception):
+        io.read_u64_at(len(data) - 4)
+    with pytest.raises((ValueError, struct.error)):
+        io.read_u32_array_at(100, 1)
+    with pytest.raises((ValueError, struct.error)):
+        io.read_u16_array_at(len(data) - 1, 1)
+    assert io.tell() == 2
+    io.close()
+
+
+@pytest.mark.parametrize("io_class", [EndianedBytesIO, EndianedBytesIOC])
+def test_gather(io_class):
+    import array
+
+    data = struct.pack(">8I", *range(8))
+    io = io_class(data, endian=">")
+
+    assert io.gather_u32([4, 0, 28]) == (1, 0, 7)
+    assert io.gather_u32(array.array("q", [8, 12]), as_array=True).tolist() == [2, 3]
+    assert io.gather_u16_le([6]) == (0x0100,)
+    assert io.gather_struct(">HH", [0, 4]) == [(0, 0), (0, 1)]
+    with pytest.raises(ValueError):
+        io.gather_u32([29])
+    with pytest.raises(ValueError):
+        io.gather_u32([-1])
+
+    # interleaved (u32 index, u32 value) pairs
+    assert io.read_strided("u32", 4, 8, 4) == (1, 3, 5, 7)
+    assert io.read_strided("u32", 28, -8, 2) == (7, 5)
+    assert io.read_strided("u32_le", 0, 0, 2) == (0, 0)
+    assert io.read_strided(">2H", 0, 16, 2) == [(0, 0), (0, 4)]
+    with pytest.raises(ValueError):
+        io.read_strided("u32", 0, 8, 5)
+    # huge counts fail before anything is allocated for them
+    with pytest.raises((OverflowError, MemoryError)):
+        io.read_strided("u32", 0, 0, 2**62)
+    with pytest.raises(ValueError):
+        io.read_strided("u32", 0, 1, 2**40)
+    assert io.tell() == 0
+
+
+@pytest.mark.parametrize(
+    "stream_factory",
+    [
+        lambda: EndianedStreamIO(BytesIO(), "<"),
+        lambda: EndianedBytesIO(endian="<"),
+        lambda: EndianedStreamIOC(BytesIO(), "<"),
+        lambda: EndianedStreamIOC(BytesIO(), "<", buffer_size=5, write_buffer_size=5),
+        lambda: EndianedBytesIOC(endian="<"),
+        lambda: EndianedFileIOCTemp.gen_writer("<"),
+    ],
+)
+def test_varint(stream_factory):
+    values = [0, 1, 127, 128, 300, 2**35, 2**56 - 1, 2**56, 2**63, 2**64 - 1]
+    # long runs of single byte values take the 8 at a time path
+    values += list(range(100)) + values
+    io = stream_factory()
+    assert io.write_varint(300) == 2
+    assert io.write_varint(2**64 - 1) == 10
+    assert io.write_varint_array(values, write_count=False) == sum(
+        (max(v.bit_length(), 1) + 6) // 7 for v in values
+    )
+    io.count_type = "u8"
+    io.write_varint_array([5, 500])
+    with pytest.raises(ValueError):
+        io.write_varint(-1)
+    with pytest.raises(ValueError):
+        io.write_varint_array([1, -1])
+    svalues = [0, -1, 1, -64, 64, -(2**63), 2**63 - 1]
+    assert io.write_svarint(-1) == 1
+    io.write_svarint_array(svalues, write_count=False)
+    with pytest.raises(OverflowError):
+        io.write_svarint(2**63)
+
+    io.seek(0)
+    assert io.read_varint() == 300
+    assert io.read_varint() == 2**64 - 1
+    assert io.read_varint_array(len(values)) == tuple(values)
+    assert io.read_varint_array(as_array=True).tolist() == [5, 500]
+    assert io.read_svarint() == -1
+    assert io.read_svarint_array(3) == (0, -1, 1)
+    assert io.read_svarint_array(4, as_array=True).tolist() == svalues[3:]
+    end = io.tell()
+    with pytest.raises(Exception):
+        io.read_varint()
+
+    # 11 bytes don't fit into 64 bits
+    io.seek(end)
+    io.write(b"\xff" * 10 + b"\x01")
+    io.seek(end)
+    with pytest.raises(OverflowError):
+        io.read_varint_array(1)
+    io.close()
+
+
+@pytest.mark.parametrize("io_class", [EndianedBytesIO, EndianedBytesIOC])
+def test_protobuf(io_class):
+    message = bytes.fromhex(
+        "089601"  # 1: varint 150
+        "120774657374696e67"  # 2: "testing"
+        "1d04030201"  # 3: i32
+        "210100000000000000"  # 4: i64
+        "2b080133342c"  # 5: group with a nested group 6, skipped
+        "0802"  # 1: varint 2
+    )
+    io = io_class(b"\xff" + message + b"\x00", ">")
+    io.seek(1)
+
+    fields = io.read_protobuf(len(message))
+    assert io.tell() == 1 + len(message)
+    assert fields.keys() == {1, 2, 3, 4}
+    assert fields[1] == [150, 2]
+    assert bytes(fields[2][0]) == b"testing"
+    assert fields[3] == [0x01020304]
+    assert fields[4] == [1]
+    del fields
+
+    io.seek(1)
+    assert io.read_protobuf(len(message), fields=[1, 5]) == {1: [150, 2]}
+    # truncated messages leave the position untouched
+    io.seek(1)
+    with pytest.raises(ValueError):
+        io.read_protobuf(5)
+    assert io.tell() == 1
+    with pytest.raises(ValueError):
+        io_class(b"\x2c").read_protobuf()
+
+
+@pytest.mark.parametrize(
+    "stream_factory",
+    [
+        lambda data: EndianedBytesIO(data),
+        lambda data: EndianedBytesIOC(data),
+        lambda data: EndianedMmapIOCTemp.gen_reader(data, "<"),
+    ],
+)
+def test_find(stream_factory):
+    # long enough for the vectorized search, with matches on both sides of a 32 byte block
+    data = b"PK\x03\x04" + bytes(60) + b"PK\x03\x04PK" + bytes(30) + b"PK\x03\x04"
+    io = stream_factory(data)
+
+    assert io.find(b"PK\x03\x04") == 0
+    assert io.find(b"PK\x03\x04", 1) == 64
+    assert io.find("PK", 65) == 68
+    assert io.find(b"PK\x03\x04", -4) == len(data) - 4
+    assert io.find(b"PK\x03\x04", 1, 67) == -1
+    assert io.find_all(b"PK\x03\x04") == (0, 64, len(data) - 4)
+    assert io.find_all(b"\x00\x00", 4, 10, as_array=True).tolist() == [4, 6, 8]
+    assert io.tell() == 0
+    with pytest.raises(ValueError):
+        io.find(b"")
+
+    io.seek(1)
+    assert io.readuntil(b"PK\x03\x04") == data[1:64]
+    assert io.tell() == 64
+    assert io.readuntil(b"\x03\x04", 1) == b"P"
+    io.close()
+
+
+@pytest.mark.parametrize(
+    "stream_factory",
+    [
+        lambda data: EndianedStreamIO(BytesIO(data), "<"),
+        lambda data: EndianedBytesIO(data, "<"),
+        lambda data: EndianedStreamIOC(BytesIO(data), "<"),
+        lambda data: EndianedStreamIOC(BytesIO(data), "<", buffer_size=5),
+        lambda data: EndianedBytesIOC(data, "<"),
+        lambda data: EndianedFileIOCTemp.gen_reader(data, "<"),
+    ],
+)
+def test_cstring_array(stream_factory):
+    names = ["", "Transform", "m_Name", "äöü", "GameObject"]
+    table = b"".join(name.encode() + b"\x00" for name in names)
+    data = b"\x05" + table + "ä\x00".encode("latin-1") + b"tail"
+    io = stream_factory(data)
+    io.count_type = "u8"
+
+    assert io.read_cstring_array() == tuple(names)
+    assert io.read_cstring_array(1, encoding="latin-1") == ("ä",)
+    # the last string ends with the data
+    assert io.read_cstring_array(2, "cp1252") == ("tail", "")
+    end = io.tell()
+
+    offsets = [1, 11, 0, 11]
+    assert io.read_cstring_table(offsets, 1) == ("Transform", "m_Name", "", "m_Name")
+    assert io.read_cstring_table([0], len(data) - 4, "ascii") == ("tail",)
+    assert io.tell() == end
+    io.seek(1)
+    assert io.read_cstring_table([18]) == (names[3],)
+    assert io.tell() == 1
+    with pytest.raises(UnicodeDecodeError):
+        io.read_cstring_table([18], errors="strict", encoding="ascii")
+    io.seek(2)
+    with pytest.raises(LookupError):
+        io.read_cstring_array(1, "no-such-codec")
+    io.close()
+
+
+@pytest.mark.parametrize(
+    "stream_factory",
+    [
+        lambda: EndianedStreamIO(BytesIO(), "<"),
+        lambda: EndianedBytesIO(endian="<"),
+        lambda: EndianedStreamIOC(BytesIO(), "<"),
+        lambda: EndianedStreamIOC(BytesIO(), "<", buffer_size=5, write_buffer_size=5),
+        lambda: EndianedBytesIOC(endian="<"),
+        lambda: EndianedFileIOCTemp.gen_writer("<"),
+    ],
+)
+def test_write_bytes(stream_factory):
+    io = stream_factory()
+    io.count_type = "u8"
+    io.write_bytes(b"abc")
+    assert io.write_bytes(b"de", write_count=False) == 2
+    io.seek(0)
+    assert io.read(6) == b"\x03abcde"
+    io.close()
+
+
+@pytest.mark.parametrize(
+    "stream_factory",
+    [
+        lambda: EndianedStreamIO(BytesIO(), "<"),
+        lambda: EndianedBytesIO(endian="<"),
+        lambda: EndianedStreamIOC(BytesIO(), "<"),
+        lambda: EndianedStreamIOC(BytesIO(), "<", buffer_size=5, write_buffer_size=5),
+        lambda: EndianedBytesIOC(endian="<"),
+        lambda: EndianedFileIOCTemp.gen_writer("<"),
+    ],
+)
+def test_string_codecs(stream_factory):
+    # ascii, non-ascii utf-8, a surrogate from surrogateescape and latin-1 that fits into a byte
+    ascii_text = "m_Name" * 10
+    escaped = b"ab\xff".decode("utf-8", "surrogateescape")
+    io = stream_factory()
+    io.count_type = "u8"
+    assert io.write_cstring(ascii_text) == len(ascii_text) + 1
+    assert io.write_cstring("äöü€") == 10
+    assert io.write_cstring(escaped) == 4
+    assert io.write_cstring("äöü", encoding="latin-1") == 4
+    assert io.write_cstring("äöü", encoding="UTF_16-le") == 7
+    io.write_string("äöü")
+    io.write_string("abc", write_count=False)
+    with pytest.raises(UnicodeEncodeError):
+        io.write_cstring("€", encoding="latin-1")
+    with pytest.raises((TypeError, AttributeError)):
+        io.write_cstring(b"abc")
+
+    io.seek(0)
+    assert io.read_cstring() == ascii_text
+    assert io.read_cstring() == "äöü€"
+    assert io.read_cstring() == escaped
+    assert io.read_cstring("latin-1") == "äöü"
+    assert io.read(7) == "äöü".encode("utf-16-le") + b"\x00"
+    # the length prefix counts bytes, not characters
+    assert io.read_u8() == 6
+    assert io.read_string(6) == "äöü"
+    assert io.read_string(3, "ascii") == "abc"
+    io.close()
+
+
+@pytest.mark.parametrize(
+    "stream_factory",
+    [
+        lambda data: EndianedStreamIO(BytesIO(data), "<"),
+        lambda data: EndianedBytesIO(data, "<"),
+        lambda data: EndianedStreamIOC(BytesIO(data), "<"),
+        lambda data: EndianedBytesIOC(data, "<"),
+        lambda data: EndianedFileIOCTemp.gen_reader(data, "<"),
+    ],
+)
+def test_intern_strings(stream_factory):
+    data = b"m_Name\x00m_Name\x00\x06m_Name\x06m_Name\x00"
+    io = stream_factory(data)
+    io.count_type = "u8"
+
+    first = io.read_cstring(intern=True)
+    assert first == "m_Name"
+    assert io.read_cstring(intern=True) is first
+    assert io.read_string(intern=True) is first
+    assert io.read_string() == first
+    assert io.read_cstring_table([0, 7], 0, intern=True) == (first, first)
+    assert all(s is first for s in io.read_cstring_table([0, 7], 0, intern=True))
+    io.seek(0)
+    assert all(s is first for s in io.read_cstring_array(2, intern=True))
+    # non-ASCII strings are left alone
+    io = stream_factory("äöü\x00äöü\x00".encode())
+    assert io.read_cstring(intern=True) == io.read_cstring(intern=True) == "äöü"
+    io.close()
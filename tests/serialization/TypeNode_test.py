@@ -172,6 +172,13 @@ else:
                 HELPER.raw_f64_le,
                 None,
             ),
+            (
+                ListNode,
+                (TupleNode((U8Node(), U16Node())), U8Node()),
+                [(1, 2), (3, 4)],
+                b"\x02\x01\x02\x00\x03\x04\x00",
+                None,
+            ),
             (
                 ListNode,
                 (StringNode(), U8Node()),
@@ -322,3 +329,101 @@ else:
         writer.seek(0)
         value_read = node.read_from(writer)
         assert value_read == value, f"Expected {value}, got {value_read}"
+
+    @dataclass(slots=True)
+    class DummyRecord(BinarySerializable):
+        kind: DummyStrEnum
+        values: list[u8]
+        pair: tuple[u8, cstr]
+
+    @dataclass(slots=True)
+    class DummySchemaClass(BinarySerializable):
+        name: str
+        data: bytes
+        records: list[DummyRecord]
+        member: DummyClassWithMemberLength
+        fixed: DummyClassWithStaticLength
+
+    def test_schema():
+        from io import BytesIO
+
+        from bier.EndianedBinaryIO.C import (
+            EndianedBytesIO as CEndianedBytesIO,
+            EndianedStreamIO as CEndianedStreamIO,
+        )
+
+        value = DummySchemaClass(
+            name="schema",
+            data=b"\x00\x01\x02",
+            records=[
+                DummyRecord(DummyStrEnum.X, [1, 2, 3], (4, "four")),
+                DummyRecord(DummyStrEnum.X, [], (5, "")),
+            ],
+            member=DummyClassWithMemberLength(3, "abc"),
+            fixed=DummyClassWithStaticLength("cool string!"),
+        )
+        node = DummySchemaClass._get_node()
+        assert node.schema is not None
+
+        # reference output of the python nodes
+        writer = EndianedBytesIO(endian="<")
+        expected_size = value.write_to(writer)
+        expected_raw = writer.getvalue()
+
+        for endian in "<>":
+            writer = EndianedBytesIO(endian=endian)
+            value.write_to(writer)
+            raw = writer.getvalue()
+
+            c_writer = CEndianedBytesIO(endian=endian)
+            assert c_writer.write_schema(node.schema, value) == expected_size
+            assert c_writer.getvalue() == raw
+
+            c_writer.seek(0)
+            assert DummySchemaClass.read_from(c_writer) == value
+            assert c_writer.tell() == len(raw)
+
+            stream = BytesIO()
+            s_writer = CEndianedStreamIO(stream, endian=endian)
+            assert value.write_to(s_writer) == expected_size
+            s_writer.flush()
+            assert stream.getvalue() == raw
+            s_writer.seek(0)
+            assert DummySchemaClass.read_from(s_writer) == value
+
+        assert len(expected_raw) == expected_size
+
+        # the node checks still apply
+        invalid = DummySchemaClass(
+            name="",
+            data=b"",
+            records=[],
+            member=DummyClassWithMemberLength(2, "abc"),
+            fixed=DummyClassWithStaticLength(""),
+        )
+        with pytest.raises(AssertionError):
+            invalid.write_to(CEndianedBytesIO())
+
+        # string lengths come from the data, a huge one must raise instead of aborting
+        from bier.EndianedBinaryIO.C.Schema import Schema
+
+        schema = Schema(("string", ("prim", "Q"), "utf-8", "strict", False))
+        with pytest.raises((MemoryError, OverflowError)):
+            CEndianedBytesIO(b"\xff" * 7 + b"\x7f").read_schema(schema)
+
+    @pytest.mark.parametrize("c_reader", [False, True])
+    def test_string_node_intern(c_reader):
+        from bier.EndianedBinaryIO.C import EndianedBytesIO as CEndianedBytesIO
+        from bier.EndianedBinaryIO.C.Schema import Schema
+
+        data = b"m_Name\x00m_Name\x00\x06m_Name"
+        reader = CEndianedBytesIO(data) if c_reader else EndianedBytesIO(data)
+        node = StringNode(intern=True)
+        first = node.read_from(reader)
+        assert node.read_from(reader) is first
+        assert StringNode(U8Node(), intern=True).read_from(reader) is first
+
+        if c_reader:
+            reader.seek(0)
+            schema = Schema(("list", ("static", 2), ("cstring", True)))
+            assert all(s is first for s in reader.read_schema(schema))